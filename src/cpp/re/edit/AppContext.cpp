@@ -22,6 +22,7 @@
 #include "imgui_internal.h"
 #include "Application.h"
 #include "Utils.h"
+#include "TaskGraph.h"
 #include "stl.h"
 #include "Clipboard.h"
 #include "UIContext.h"
@@ -145,40 +146,6 @@ bool AppContext::IsCurrent(AppContext *iCtx)
     return false;
 }
 
-//------------------------------------------------------------------------
-// AppContext::initPanels
-//------------------------------------------------------------------------
-void AppContext::initPanels(fs::path const &iDevice2DFile,
-                            fs::path const &iHDGui2DFile,
-                            Utils::CancellableSPtr const &iCancellable)
-{
-  Widget::resetWidgetIota();
-
-  iCancellable->progress("Loading device_2D.lua...");
-  auto d2d = lua::Device2D::fromFile(iDevice2DFile);
-  fReEditVersion = d2d->getReEditVersion();
-
-  iCancellable->progress("Loading hdgui_2D.lua...");
-  auto hdg = lua::HDGui2D::fromFile(iHDGui2DFile);
-
-  iCancellable->progress("Init front panel...");
-  fFrontPanel->initPanel(*this, d2d->front(), hdg->front());
-
-  iCancellable->progress("Init back panel...");
-  fBackPanel->initPanel(*this, d2d->back(), hdg->back());
-  if(fHasFoldedPanels)
-  {
-    iCancellable->progress("Init folded front panel...");
-    fFoldedFrontPanel->initPanel(*this, d2d->folded_front(), hdg->folded_front());
-
-    iCancellable->progress("Init folded back panel...");
-    fFoldedBackPanel->initPanel(*this, d2d->folded_back(), hdg->folded_back());
-  }
-  markEdited();
-  iCancellable->progress("Checking for errors...");
-  checkForErrors();
-}
-
 //------------------------------------------------------------------------
 // AppContext::renderTabs
 //------------------------------------------------------------------------
@@ -217,7 +184,10 @@ void AppContext::renderTabs()
   ImGui::PopStyleVar();
 
   if(type != fCurrentPanelState->getType())
+  {
+    fCurrentPanelState->fPanel.commitEditedWidget();
     fCurrentPanelState = getPanelState(type);
+  }
 
   ImGui::PopID();
 
@@ -405,6 +375,23 @@ void AppContext::render()
       ImGui::SeparatorText("Performance");
       ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate,
                   ImGui::GetIO().Framerate);
+      auto const &frameStats = Application::GetCurrent().getFrameStats();
+      ImGui::Text("Frames rendered %ld | skipped (idle) %ld", frameStats.fRenderedCount, frameStats.fSkippedCount);
+      auto const &memoryStats = fTextureManager->getMemoryStats();
+      auto const toMB = [](std::size_t iSize) { return static_cast<float>(iSize) / (1024.0f * 1024.0f); };
+      ImGui::Text("Textures memory %.1fMB (CPU %.1fMB | GPU %.1fMB) | Peak %.1fMB | Evicted %d",
+                  toMB(memoryStats.memorySize()),
+                  toMB(memoryStats.fCPUMemorySize),
+                  toMB(memoryStats.fGPUMemorySize),
+                  toMB(memoryStats.fPeakMemorySize),
+                  memoryStats.fEvictedCount);
+      if(UIContext::HasCurrent())
+        ImGui::Text("GPU upload queue %zu", UIContext::GetCurrent().getGPUUploadQueueDepth());
+      auto const &drawStats = fCurrentPanelState->fPanel.getDrawStats();
+      ImGui::Text("Panel items drawn %d | culled %d", drawStats.fDrawnCount, drawStats.fCulledCount);
+      auto const &drawListStats = fPanelCanvasDrawList.getStats();
+      ImGui::Text("Panel canvas draws %d | batches %d | shader switches %d",
+                  drawListStats.fCommandCount, drawListStats.fBatchCount, drawListStats.fShaderSwitchCount);
     }
   }
 
@@ -571,9 +558,11 @@ std::string AppContext::getDeviceName() const
 //------------------------------------------------------------------------
 // AppContext::reloadTextures
 //------------------------------------------------------------------------
-bool AppContext::reloadTextures()
+bool AppContext::reloadTextures(std::set<FilmStrip::key_t> const &iKeys)
 {
-  markEdited();
+  // only the widgets referencing the textures which changed on disk need to be checked again
+  for(auto const &key: iKeys)
+    markTextureChanged(key);
   return checkForErrors();
 }
 
@@ -597,26 +586,70 @@ void AppContext::initDevice()
 }
 
 //------------------------------------------------------------------------
-// AppContext::initGUI2D
+// AppContext::initProject
 //------------------------------------------------------------------------
-void AppContext::initGUI2D(Utils::CancellableSPtr const &iCancellable)
+void AppContext::initProject(Utils::CancellableSPtr const &iCancellable)
 {
   auto GUI2D = fRoot / "GUI2D";
-  iCancellable->progress("Loading built ins...");
-  fTextureManager->init(BuiltIns::kDeviceBuiltIns, GUI2D);
-
-  iCancellable->progress("Scanning GUI2D...");
-  fTextureManager->scanDirectory();
-
   auto device_2D = GUI2D / "device_2D.lua";
   auto hdgui_2D = GUI2D / "hdgui_2D.lua";
+
+  std::unique_ptr<lua::Device2D> d2d{};
+  std::unique_ptr<lua::HDGui2D> hdg{};
+
+  // each task runs in its own thread => this context must be made current in each of them
+  auto withContext = [this](TaskGraph::task_t iTask) -> TaskGraph::task_t {
+    return [this, task = std::move(iTask)] {
+      Utils::StorageRAII<AppContext> current{&kCurrent, this};
+      task();
+    };
+  };
+
+  // motherboard (re-mock), GUI2D scan and both lua files are independent from each other: the panels need all of
+  // them and are initialized one after the other (they share the undo state and the widget iota)
+  TaskGraph graph{};
+
+  auto device = graph.add("Loading motherboard", withContext([this] { initDevice(); }));
+
+  auto textures = graph.add("Scanning GUI2D", withContext([this, &GUI2D] {
+    fTextureManager->init(BuiltIns::kDeviceBuiltIns, GUI2D);
+    fTextureManager->scanDirectory();
+  }));
+
   if(fs::exists(device_2D) && fs::exists(hdgui_2D))
-    initPanels(device_2D, hdgui_2D, iCancellable);
-  else
   {
-    markEdited();
-    checkForErrors();
+    auto d2dTask = graph.add("Loading device_2D.lua", [&d2d, &device_2D] { d2d = lua::Device2D::fromFile(device_2D); });
+    auto hdgTask = graph.add("Loading hdgui_2D.lua", [&hdg, &hdgui_2D] { hdg = lua::HDGui2D::fromFile(hdgui_2D); });
+
+    auto front = graph.add("Init front panel", withContext([this, &d2d, &hdg] {
+      fReEditVersion = d2d->getReEditVersion();
+      fFrontPanel->initPanel(*this, d2d->front(), hdg->front());
+    }), {device, textures, d2dTask, hdgTask});
+
+    auto back = graph.add("Init back panel", withContext([this, &d2d, &hdg] {
+      fBackPanel->initPanel(*this, d2d->back(), hdg->back());
+    }), {front});
+
+    // fHasFoldedPanels is only known once the motherboard is loaded
+    auto foldedFront = graph.add("Init folded front panel", withContext([this, &d2d, &hdg] {
+      if(fHasFoldedPanels)
+        fFoldedFrontPanel->initPanel(*this, d2d->folded_front(), hdg->folded_front());
+    }), {back});
+
+    graph.add("Init folded back panel", withContext([this, &d2d, &hdg] {
+      if(fHasFoldedPanels)
+        fFoldedBackPanel->initPanel(*this, d2d->folded_back(), hdg->folded_back());
+    }), {foldedFront});
   }
+
+  // the widget ids must not depend on which task (and thread) runs first
+  Widget::resetWidgetIota();
+
+  graph.run(iCancellable);
+
+  markEdited();
+  iCancellable->progress("Checking for errors...");
+  checkForErrors();
 }
 
 //------------------------------------------------------------------------
@@ -642,6 +675,24 @@ void AppContext::markEdited()
   }
 }
 
+//------------------------------------------------------------------------
+// AppContext::markTextureChanged
+//------------------------------------------------------------------------
+std::optional<FilmStrip::key_t> AppContext::markTextureChanged(std::optional<FilmStrip::key_t> iKey) const
+{
+  if(iKey)
+  {
+    fFrontPanel->fPanel.markTextureChanged(*iKey);
+    fBackPanel->fPanel.markTextureChanged(*iKey);
+    if(fHasFoldedPanels)
+    {
+      fFoldedFrontPanel->fPanel.markTextureChanged(*iKey);
+      fFoldedBackPanel->fPanel.markTextureChanged(*iKey);
+    }
+  }
+  return iKey;
+}
+
 //------------------------------------------------------------------------
 // AppContext::checkForErrors
 //------------------------------------------------------------------------
@@ -958,8 +1009,7 @@ void AppContext::beforeRenderFrame()
   if(fReloadTexturesRequested)
   {
     fReloadTexturesRequested = false;
-    fTextureManager->scanDirectory();
-    if(reloadTextures())
+    if(reloadTextures(fTextureManager->scanDirectory()))
     {
       Application::GetCurrent().newNotification()
         .text("Images reloaded. Some errors detected.");
@@ -998,8 +1048,9 @@ void AppContext::beforeRenderFrame()
     }
   }
 
-  fLastUndoAction = fUndoManager->getLastUndoAction();
-  fNeedsSaving = fLastUndoAction != fLastSavedUndoAction;
+  auto lastUndoAction = fUndoManager->getLastUndoAction();
+  fLastUndoActionId = lastUndoAction ? lastUndoAction->getId() : 0;
+  fNeedsSaving = fLastUndoActionId != fLastSavedUndoActionId;
 }
 
 //------------------------------------------------------------------------
@@ -1027,6 +1078,9 @@ void AppContext::newFrame()
 void AppContext::afterRenderFrame()
 {
   fPropertyManager->afterRenderFrame();
+  fTextureManager->enforceMemoryBudget(static_cast<std::size_t>(Application::GetCurrent().getTextureMemoryBudget()) * 1024 * 1024);
+  fUndoManager->enforceHistoryLimits(Application::GetCurrent().getUndoHistoryMaxCount(),
+                                     static_cast<std::size_t>(Application::GetCurrent().getUndoHistoryMemoryBudget()) * 1024 * 1024);
 }
 
 //------------------------------------------------------------------------
@@ -1038,12 +1092,13 @@ void AppContext::save()
   auto deferred = Utils::defer([this] { enableFileWatcher(); });
   UserError errors{};
   auto GUI2D = fRoot / "GUI2D";
-  importBuiltIns(&errors); // convert built ins into actual images first (so that cmake() can see them)
-  applyTextureEffects(&errors);
-  Application::saveFile(GUI2D / "device_2D.lua", device2D(), &errors);
-  Application::saveFile(GUI2D / "hdgui_2D.lua", hdgui2D(), &errors);
+  // convert built ins into actual images first (so that cmake() can see them)
+  auto texturesCreated = importBuiltIns(&errors);
+  texturesCreated |= applyTextureEffects(&errors);
+  saveFile(GUI2D / "device_2D.lua", device2D(), &errors);
+  saveFile(GUI2D / "hdgui_2D.lua", hdgui2D(), &errors);
   if(fs::exists(fRoot / "CMakeLists.txt"))
-    Application::saveFile(GUI2D / "gui_2D.cmake", cmake(), &errors);
+    saveFile(GUI2D / "gui_2D.cmake", cmake(), &errors);
   Application::GetCurrent().savePreferences(&errors);
   if(errors.hasErrors())
   {
@@ -1063,11 +1118,52 @@ void AppContext::save()
   }
 //  fAppContext->fUndoManager->clear();
   fNeedsSaving = false;
-  fLastSavedUndoAction = fUndoManager->getLastUndoAction();
+  auto lastUndoAction = fUndoManager->getLastUndoAction();
+  fLastSavedUndoActionId = lastUndoAction ? lastUndoAction->getId() : 0;
   ImGui::GetIO().WantSaveIniSettings = false;
   fReEditVersion = kFullVersion;
 
-  computeErrors(); // applyEffects can fix some issues so we need to check
+  // applyEffects can fix some issues so we need to check all panels, but only when new images were generated:
+  // otherwise only the panels edited since the last check need to be revisited
+  if(texturesCreated)
+    computeErrors();
+  else
+    checkForErrors();
+}
+
+//------------------------------------------------------------------------
+// AppContext::saveFile
+//------------------------------------------------------------------------
+void AppContext::saveFile(fs::path const &iFile, std::string const &iContent, UserError *oErrors)
+{
+  auto hash = std::hash<std::string>{}(iContent);
+
+  std::error_code errorCode;
+  auto lastWriteTime = fs::last_write_time(iFile, errorCode);
+
+  // same content as the last save and the file has not been touched since => nothing to do
+  auto iter = fSavedFiles.find(iFile);
+  if(!errorCode && iter != fSavedFiles.end() && iter->second.fContentHash == hash && iter->second.fLastWriteTime == lastWriteTime)
+    return;
+
+  UserError errors{};
+  Application::saveFile(iFile, iContent, &errors);
+  if(errors.hasErrors())
+  {
+    fSavedFiles.erase(iFile);
+    if(oErrors)
+    {
+      for(auto const &error: errors.getErrors())
+        oErrors->add(error);
+    }
+    return;
+  }
+
+  lastWriteTime = fs::last_write_time(iFile, errorCode);
+  if(errorCode)
+    fSavedFiles.erase(iFile);
+  else
+    fSavedFiles[iFile] = SavedFile{hash, lastWriteTime};
 }
 
 //------------------------------------------------------------------------
@@ -1075,12 +1171,19 @@ void AppContext::save()
 //------------------------------------------------------------------------
 std::string AppContext::hdgui2D() const
 {
-  std::stringstream s{};
+  // the panel sections are cached (see Panel::hdgui2D) so the final size is known upfront (1 allocation)
+  auto const &front = fFrontPanel->fPanel.hdgui2D();
+  auto const &back = fBackPanel->fPanel.hdgui2D();
+  auto size = front.size() + back.size();
+  if(fHasFoldedPanels)
+    size += fFoldedFrontPanel->fPanel.hdgui2D().size() + fFoldedBackPanel->fPanel.hdgui2D().size();
+
+  lua::Writer s{size + 256};
   s << "format_version = \"2.0\"\n\n";
-  s << fmt::printf("re_edit = { version = \"%s\" }\n\n", kFullVersion);
-  s << fFrontPanel->fPanel.hdgui2D();
+  s.printf("re_edit = { version = \"%s\" }\n\n", kFullVersion);
+  s << front;
   s << "\n";
-  s << fBackPanel->fPanel.hdgui2D();
+  s << back;
   s << "\n";
   if(fHasFoldedPanels)
   {
@@ -1094,7 +1197,7 @@ std::string AppContext::hdgui2D() const
     s << "-- players don't have folded panels\n";
   }
 
-  return s.str();
+  return s.release();
 }
 
 //------------------------------------------------------------------------
@@ -1102,18 +1205,24 @@ std::string AppContext::hdgui2D() const
 //------------------------------------------------------------------------
 std::string AppContext::device2D() const
 {
-  std::stringstream s{};
+  auto const &front = fFrontPanel->fPanel.device2D();
+  auto const &back = fBackPanel->fPanel.device2D();
+  auto size = front.size() + back.size();
+  if(fHasFoldedPanels)
+    size += fFoldedFrontPanel->fPanel.device2D().size() + fFoldedBackPanel->fPanel.device2D().size();
+
+  lua::Writer s{size + 256};
   s << "format_version = \"2.0\"\n\n";
-  s << fmt::printf("re_edit = { version = \"%s\" }\n\n", kFullVersion);
+  s.printf("re_edit = { version = \"%s\" }\n\n", kFullVersion);
 
   if(!fHasFoldedPanels)
   {
     s << "panel_type = \"note_player\"\n";
   }
 
-  s << fFrontPanel->fPanel.device2D();
+  s << front;
   s << "\n";
-  s << fBackPanel->fPanel.device2D();
+  s << back;
   s << "\n";
 
   if(fHasFoldedPanels)
@@ -1127,7 +1236,7 @@ std::string AppContext::device2D() const
     s << "-- players don't have folded panels\n";
 
 
-  return s.str();
+  return s.release();
 }
 
 //------------------------------------------------------------------------
@@ -1173,7 +1282,7 @@ std::set<FilmStrip::key_t> AppContext::computeUnusedTextures() const
   }
 
   // note that it returns only VALID textures
-  auto allTextures = fTextureManager->findTextureKeys({[] (FilmStrip const &iFilmStrip) { return iFilmStrip.hasPath(); }, "Match path only textures"});
+  auto allTextures = fTextureManager->findTextureKeys({[] (FilmStrip::Metadata const &iMetadata) { return iMetadata.hasPath(); }, "Match path only textures"});
 
   std::set<FilmStrip::key_t> unusedTextures{};
 
@@ -1219,7 +1328,8 @@ void AppContext::disableFileWatcher()
 //------------------------------------------------------------------------
 std::optional<FilmStrip::key_t> AppContext::importTexture(fs::path const &iTexturePath)
 {
-  return fTextureManager->importTexture(iTexturePath);
+  // the imported image may replace an existing one
+  return markTextureChanged(fTextureManager->importTexture(iTexturePath));
 }
 
 //------------------------------------------------------------------------
@@ -1237,7 +1347,7 @@ std::optional<FilmStrip::key_t> AppContext::importTextureBlocking()
   {
     fs::path texturePath{outPath};
     NFD_FreePath(outPath);
-    return fTextureManager->importTexture(texturePath);
+    return importTexture(texturePath);
   }
   else if(result == NFD_CANCEL)
   {
@@ -1281,7 +1391,7 @@ std::size_t AppContext::importTexturesBlocking()
     NFD_PathSet_Free(outPaths);
 
     for(auto &texturePath: texturePaths)
-      fTextureManager->importTexture(texturePath);
+      importTexture(texturePath);
     return texturePaths.size();
   }
   else if(result == NFD_CANCEL)
@@ -1298,7 +1408,7 @@ std::size_t AppContext::importTexturesBlocking()
 //------------------------------------------------------------------------
 // AppContext::importBuiltIns
 //------------------------------------------------------------------------
-void AppContext::importBuiltIns(UserError *oErrors)
+bool AppContext::importBuiltIns(UserError *oErrors)
 {
   std::set<FilmStrip::key_t> keys{};
   fFrontPanel->fPanel.collectUsedTextureBuiltIns(keys);
@@ -1310,13 +1420,15 @@ void AppContext::importBuiltIns(UserError *oErrors)
   }
 
   if(!keys.empty())
-    fTextureManager->importBuiltIns(keys, oErrors);
+    return fTextureManager->importBuiltIns(keys, oErrors);
+
+  return false;
 }
 
 //------------------------------------------------------------------------
 // AppContext::applyTextureEffects
 //------------------------------------------------------------------------
-void AppContext::applyTextureEffects(UserError *oErrors)
+bool AppContext::applyTextureEffects(UserError *oErrors)
 {
   std::vector<FilmStripFX> effects{};
   fFrontPanel->fPanel.collectFilmStripEffects(effects);
@@ -1328,7 +1440,9 @@ void AppContext::applyTextureEffects(UserError *oErrors)
   }
 
   if(!effects.empty())
-    fTextureManager->applyEffects(effects, oErrors);
+    return fTextureManager->applyEffects(effects, oErrors);
+
+  return false;
 }
 
 //------------------------------------------------------------------------
@@ -1476,12 +1590,21 @@ ImVec2 AppContext::getRenderScale() const
 //------------------------------------------------------------------------
 // AppContext::getPanelCanvasRenderTexture
 //------------------------------------------------------------------------
-Texture::RenderTexture const &AppContext::getPanelCanvasRenderTexture(ImVec2 const &iSize)
+Texture::RenderTexture &AppContext::getPanelCanvasRenderTexture(ImVec2 const &iSize)
 {
   fPanelCanvasRenderTexture.resize(iSize, getRenderScale());
   return fPanelCanvasRenderTexture;
 }
 
+//------------------------------------------------------------------------
+// AppContext::getPanelCanvasMovingLayerRenderTexture
+//------------------------------------------------------------------------
+Texture::RenderTexture &AppContext::getPanelCanvasMovingLayerRenderTexture(ImVec2 const &iSize)
+{
+  fPanelCanvasMovingLayerRenderTexture.resize(iSize, getRenderScale());
+  return fPanelCanvasMovingLayerRenderTexture;
+}
+
 //------------------------------------------------------------------------
 // AppContext::textureTooltip
 //------------------------------------------------------------------------
@@ -1672,7 +1795,7 @@ void AppContext::redoLastAction()
 void AppContext::clearUndoHistory()
 {
   fUndoManager->clear();
-  fLastSavedUndoAction = nullptr;
+  fLastSavedUndoActionId = 0;
 }
 
 namespace impl {
@@ -1757,6 +1880,10 @@ void AppContext::renderUndoHistory()
       clearUndoHistory();
     }
     ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::Text("%zu actions | %.1fMB",
+                fUndoManager->getUndoHistory().size() + fUndoManager->getRedoHistory().size(),
+                static_cast<float>(fUndoManager->getMemorySize()) / (1024.0f * 1024.0f));
 
     if(ImGui::BeginChild("History", ImVec2{}, false, ImGuiWindowFlags_HorizontalScrollbar))
     {
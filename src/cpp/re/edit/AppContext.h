@@ -20,6 +20,7 @@
 #define RE_EDIT_APP_CONTEXT_H
 
 #include <vector>
+#include <map>
 #include <string>
 #include <memory>
 #include <exception>
@@ -37,6 +38,7 @@
 #include "Canvas.h"
 #include "Clipboard.h"
 #include "Grid.h"
+#include "RLDrawList.h"
 
 namespace efsw {
 class FileWatcher;
@@ -129,17 +131,21 @@ public: // UserPreferences
 
 public: // Properties
   inline Object const *findObject(std::string const &iObjectPath) const { return fPropertyManager->findObject(iObjectPath); };
-  inline std::vector<Object const *> findObjects(Object::Filter const &iFilter) const { return fPropertyManager->findObjects(iFilter); }
-  inline std::vector<Object const *> findAllObjects() const { return fPropertyManager->findAllObjects(); }
+  inline std::vector<Object const *> const &findObjects(Object::Filter const &iFilter) const { return fPropertyManager->findObjects(iFilter); }
+  inline std::vector<Object const *> const &findAllObjects() const { return fPropertyManager->findAllObjects(); }
 
-  inline std::vector<Property const *> findProperties(Property::Filter const &iFilter) const { return fPropertyManager->findProperties(iFilter); };
-  inline std::vector<Property const *> findAllProperties() const { return fPropertyManager->findAllProperties(); }
+  inline std::vector<Property const *> const &findProperties(Property::Filter const &iFilter) const { return fPropertyManager->findProperties(iFilter); };
+  inline std::vector<Property const *> const &findAllProperties() const { return fPropertyManager->findAllProperties(); }
   inline std::vector<std::string> findPropertyNames(Property::Filter const &iFilter) const { return fPropertyManager->findPropertyNames(iFilter); }
   void sortProperties(std::vector<std::string> &ioProperties, Property::Comparator const &iComparator) const { fPropertyManager->sortProperties(ioProperties, iComparator); }
   inline Property const *findProperty(std::string const &iPropertyPath) const { return fPropertyManager->findProperty(iPropertyPath); };
   inline std::string getPropertyInfo(std::string const &iPropertyPath) const { return fPropertyManager->getPropertyInfo(iPropertyPath); }
   int getPropertyValueAsInt(std::string const &iPropertyPath) const { return fPropertyManager->getValueAsInt(iPropertyPath); }
   void setPropertyValueAsInt(std::string const &iPropertyPath, int iValue) { return fPropertyManager->setValueAsInt(iPropertyPath, iValue); }
+  inline std::uint64_t getPropertyValuesVersion() const { return fPropertyManager->getValuesVersion(); }
+  inline PropertyHandle getPropertyHandle(std::string const &iPropertyPath) const { return fPropertyManager->getPropertyHandle(iPropertyPath); }
+  inline bool isCurrentPropertyHandle(PropertyHandle const &iHandle) const { return fPropertyManager->isCurrent(iHandle); }
+  inline int getPropertyValueAsInt(PropertyHandle const &iHandle) const { return fPropertyManager->getValueAsInt(iHandle); }
   void propertyEditView(std::string const &iPropertyPath) { fPropertyManager->editView(iPropertyPath); }
   void propertyEditViewAsInt(std::string const &iPropertyPath, std::function<void(int)> const &iOnChange) const { fPropertyManager->editViewAsInt(iPropertyPath, iOnChange); }
   constexpr int getUserSamplesCount() const { return fPropertyManager->getUserSamplesCount(); }
@@ -178,7 +184,10 @@ public: // Texture
   template<typename F>
   bool textureMenu(FilmStrip::Filter const &iFilter, F &&f);
   ImVec2 getRenderScale() const;
-  Texture::RenderTexture const &getPanelCanvasRenderTexture(ImVec2 const &iSize);
+  Texture::RenderTexture &getPanelCanvasRenderTexture(ImVec2 const &iSize);
+  //! Transparent layer composited on top of the panel canvas (widgets being moved)
+  Texture::RenderTexture &getPanelCanvasMovingLayerRenderTexture(ImVec2 const &iSize);
+  inline RLDrawList &getPanelCanvasDrawList() { return fPanelCanvasDrawList; }
 
 public: // Undo
   constexpr bool isUndoEnabled() const { return fUndoManager->isEnabled(); }
@@ -246,8 +255,9 @@ public:
 protected:
   void init(config::Device const &iConfig);
   config::Device getConfig() const;
-  bool reloadTextures();
+  bool reloadTextures(std::set<FilmStrip::key_t> const &iKeys);
   void markEdited();
+  std::optional<FilmStrip::key_t> markTextureChanged(std::optional<FilmStrip::key_t> iKey) const;
   bool checkForErrors();
   bool computeErrors();
   bool computeErrors(PanelType iType);
@@ -255,11 +265,11 @@ protected:
   void renderErrors(Panel const &iPanel);
   void renderUndoHistory();
   void initDevice();
-  void initGUI2D(Utils::CancellableSPtr const &iCancellable);
+  void initProject(Utils::CancellableSPtr const &iCancellable);
   bool reloadDevice();
   void save();
-  void importBuiltIns(UserError *oErrors = nullptr);
-  void applyTextureEffects(UserError *oErrors = nullptr);
+  bool importBuiltIns(UserError *oErrors = nullptr);
+  bool applyTextureEffects(UserError *oErrors = nullptr);
   void commitTextureEffects();
   std::string hdgui2D() const;
   std::string device2D() const;
@@ -267,9 +277,6 @@ protected:
   std::set<FilmStrip::key_t> computeUnusedTextures() const;
   std::optional<std::string> getReEditVersion() const { return fReEditVersion; }
 
-  void initPanels(fs::path const &iDevice2DFile,
-                  fs::path const &iHDGui2DFile,
-                  Utils::CancellableSPtr const &iCancellable);
   inline ReGui::Canvas &getPanelCanvas() { return fPanelCanvas; }
   void newFrame();
   void beforeRenderFrame();
@@ -289,6 +296,16 @@ protected:
   void enableFileWatcher();
   void disableFileWatcher();
 
+protected:
+  void saveFile(fs::path const &iFile, std::string const &iContent, UserError *oErrors);
+
+  // what was last written by `saveFile` (so that an unchanged output is not even read back from disk)
+  struct SavedFile
+  {
+    std::size_t fContentHash{};
+    fs::file_time_type fLastWriteTime{};
+  };
+
 protected:
   fs::path fRoot;
   ReGui::Window fMainWindow{"re-edit", std::nullopt, ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_HorizontalScrollbar};
@@ -315,14 +332,17 @@ protected:
   PanelState *fPreviousPanelState{};
   ReGui::Canvas fPanelCanvas{};
   Texture::RenderTexture fPanelCanvasRenderTexture{};
+  Texture::RenderTexture fPanelCanvasMovingLayerRenderTexture{};
+  RLDrawList fPanelCanvasDrawList{};
   Clipboard fClipboard{};
   bool fNeedsSaving{};
-  void *fLastSavedUndoAction{};
-  void *fLastUndoAction{};
+  long fLastSavedUndoActionId{}; // ids (unlike pointers) are never reused (old actions get dropped)
+  long fLastUndoActionId{};
   bool fRecomputeDimensionsRequested{true};
   bool fReloadTexturesRequested{};
   bool fReloadDeviceRequested{};
   std::optional<std::string> fNewLayoutRequested{};
+  std::map<fs::path, SavedFile> fSavedFiles{};
   ImGuiMouseCursor fMouseCursor{ImGuiMouseCursor_None};
 
   std::shared_ptr<efsw::FileWatcher> fRootWatcher{};
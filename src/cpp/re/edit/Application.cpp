@@ -24,6 +24,8 @@
 #include "lua/ConfigParser.h"
 #include "LoggingManager.h"
 #include <fstream>
+#include <array>
+#include <cstring>
 #include <chrono>
 #include <iterator>
 #include <imgui.h>
@@ -138,22 +140,54 @@ std::optional<fs::path> inferValidRoot(fs::path const &iPath) noexcept
   return std::nullopt;
 }
 
+//------------------------------------------------------------------------
+// impl::hasSameContent
+// Compares the file with iContent chunk by chunk (the file is never loaded in memory as a whole)
+//------------------------------------------------------------------------
+bool hasSameContent(fs::path const &iFile, std::string const &iContent)
+{
+  std::error_code errorCode;
+  if(!fs::is_regular_file(iFile, errorCode) || fs::file_size(iFile, errorCode) != iContent.size() || errorCode)
+    return false;
+
+  std::ifstream file(iFile, std::ios::in | std::ios::binary);
+  std::array<char, 16 * 1024> buffer{};
+  std::size_t offset = 0;
+  while(offset < iContent.size())
+  {
+    auto count = std::min(buffer.size(), iContent.size() - offset);
+    if(!file.read(buffer.data(), static_cast<std::streamsize>(count)))
+      return false;
+    if(std::memcmp(buffer.data(), iContent.data() + offset, count) != 0)
+      return false;
+    offset += count;
+  }
+  return true;
+}
+
 }
 
 
 //------------------------------------------------------------------------
 // Application::async
 //------------------------------------------------------------------------
-template<class Function, class... Args>
-bool Application::async(std::string const &iKey, Function &&f, Args &&... args)
+template<class Function>
+bool Application::async(std::string const &iKey, Function &&f)
 {
   RE_EDIT_INTERNAL_ASSERT(fGUIThreadID == std::this_thread::get_id(), "Can only be called from the GUI thread!");
   if(!hasAsyncAction(iKey))
   {
-    std::future<gui_action_t> action = std::async(std::launch::async,
-                                                  std::forward<Function>(f),
-                                                  std::forward<Args>(args)...);
-    fAsyncActions[iKey] = std::move(action);
+    // the resulting action is executed on the GUI thread (next frame) as soon as f completes
+    fAsyncActions[iKey] =
+      ThreadPool::GetDefault().submitThenOnUIThread(ThreadPool::Priority::kBackground,
+                                                    UIContext::GetCurrent(),
+                                                    std::forward<Function>(f),
+                                                    [this, iKey](std::shared_future<gui_action_t> const &iAction) {
+                                                      fAsyncActions.erase(iKey);
+                                                      auto action = executeAndLogOnException<gui_action_t>([&iAction] { return iAction.get(); });
+                                                      if(action)
+                                                        action();
+                                                    });
     return true;
   }
   else
@@ -396,10 +430,7 @@ std::shared_ptr<AppContext> Application::initAppContext(fs::path const &iRoot,
 
   iCancellable->progress("Loading...");
   ctx->init(iConfig);
-  iCancellable->progress("Loading motherboard...");
-  ctx->initDevice();
-  iCancellable->progress("Loading GUI...");
-  ctx->initGUI2D(iCancellable);
+  ctx->initProject(iCancellable);
   return ctx;
 }
 
@@ -728,35 +759,6 @@ void Application::handleNewFrameActions()
     action();
 }
 
-//------------------------------------------------------------------------
-// Application::handleAsyncActions
-//------------------------------------------------------------------------
-void Application::handleAsyncActions()
-{
-  auto futures = std::move(fAsyncActions);
-  for(auto &pair : futures)
-  {
-    auto &key = pair.first;
-    auto &future = pair.second;
-    switch(future.wait_for(std::chrono::seconds(0)))
-    {
-      case std::future_status::ready:
-      {
-        auto action = executeAndLogOnException<gui_action_t>([&future] { return future.get(); });
-        if(action)
-          action();
-        break;
-      }
-      case std::future_status::timeout:
-        // not complete => moving back to fAsyncActions
-        fAsyncActions[key] = std::move(future);
-        break;
-      case std::future_status::deferred:
-        RE_EDIT_FAIL("not reached");
-    }
-  }
-}
-
 //------------------------------------------------------------------------
 // Application::handleFontChangeRequest
 //------------------------------------------------------------------------
@@ -777,18 +779,22 @@ bool Application::newFrame(std::vector<gui_action_t> const &iFrameActions) noexc
 {
   Utils::StorageRAII<Application> current{&kCurrent, this};
 
+  fFrameStats.fRenderedCount++;
+
   try
   {
     if(!iFrameActions.empty())
     {
+      fLastActivityTime = std::chrono::steady_clock::now();
       for(auto &action: iFrameActions)
         action();
     }
     if(!fNewFrameActions.empty())
       handleNewFrameActions();
 
-    if(!fAsyncActions.empty())
-      handleAsyncActions();
+    // uploads enqueued by the actions above are processed right away (within the budget)
+    if(UIContext::HasCurrent())
+      UIContext::GetCurrent().processGPUUploads(static_cast<float>(getGPUUploadBudget()));
 
     if(fFontManager->hasFontChangeRequest())
       handleFontChangeRequest();
@@ -808,6 +814,89 @@ bool Application::newFrame(std::vector<gui_action_t> const &iFrameActions) noexc
   return running();
 }
 
+namespace impl {
+
+constexpr auto kIdleDelay = std::chrono::milliseconds{1000};
+constexpr auto kIdleWaitTimeout = std::chrono::milliseconds{1000};
+
+//------------------------------------------------------------------------
+// impl::hasUserInput
+//------------------------------------------------------------------------
+static bool hasUserInput(ImGuiIO const &io)
+{
+  if(io.MouseDelta.x != 0 || io.MouseDelta.y != 0 || io.MouseWheel != 0 || io.MouseWheelH != 0)
+    return true;
+
+  if(!io.InputQueueCharacters.empty())
+    return true;
+
+  if(std::any_of(std::begin(io.MouseDown), std::end(io.MouseDown), [](auto d) { return d; }))
+    return true;
+
+  for(int key = ImGuiKey_NamedKey_BEGIN; key < ImGuiKey_NamedKey_END; key++)
+  {
+    if(ImGui::IsKeyDown(static_cast<ImGuiKey>(key)))
+      return true;
+  }
+
+  return false;
+}
+
+}
+
+//------------------------------------------------------------------------
+// Application::isIdle
+//------------------------------------------------------------------------
+bool Application::isIdle() const
+{
+  // ImGui needs a few frames to settle after an input (hover, tooltips, auto-resize...)
+  if(std::chrono::steady_clock::now() - fLastActivityTime < impl::kIdleDelay)
+    return false;
+
+  // the loading progress bar is polled
+  if(fState != State::kReLoaded && fState != State::kNoReLoaded)
+    return false;
+
+  if(!fNewFrameActions.empty() || !fAsyncActions.empty() || !fDialogs.empty())
+    return false;
+
+  if(fFontManager->hasFontChangeRequest())
+    return false;
+
+  // notifications which dismiss themselves need to be rendered until then
+  if(std::any_of(fNotifications.begin(), fNotifications.end(), [](auto const &n) { return n->isTimed(); }))
+    return false;
+
+  // blinking cursor
+  if(ImGui::GetCurrentContext() && ImGui::GetIO().WantTextInput)
+    return false;
+
+  // actions posted by other threads (file watcher, decoded textures...) and uploads in progress
+  if(UIContext::HasCurrent())
+  {
+    auto const &uiContext = UIContext::GetCurrent();
+    if(uiContext.hasUIActions() || uiContext.getGPUUploadQueueDepth() > 0)
+      return false;
+  }
+
+  return true;
+}
+
+//------------------------------------------------------------------------
+// Application::waitForEvents
+//------------------------------------------------------------------------
+bool Application::waitForEvents()
+{
+  auto const start = std::chrono::steady_clock::now();
+  fContext->waitForEvents(std::chrono::duration<double>(impl::kIdleWaitTimeout).count());
+  auto const elapsed = std::chrono::steady_clock::now() - start;
+
+  auto const frameRate = getTargetFrameRate() > 0 ? getTargetFrameRate() : 60;
+  fFrameStats.fSkippedCount += static_cast<long>(std::chrono::duration<double>(elapsed).count() * frameRate);
+
+  return elapsed < impl::kIdleWaitTimeout;
+}
+
 //------------------------------------------------------------------------
 // Application::render
 //------------------------------------------------------------------------
@@ -815,6 +904,12 @@ bool Application::render() noexcept
 {
   Utils::StorageRAII<Application> current{&kCurrent, this};
 
+  if(impl::hasUserInput(ImGui::GetIO()) || ImGui::GetIO().DisplaySize != fLastDisplaySize)
+  {
+    fLastActivityTime = std::chrono::steady_clock::now();
+    fLastDisplaySize = ImGui::GetIO().DisplaySize;
+  }
+
   if(hasDialog())
   {
     try
@@ -1222,6 +1317,55 @@ void Application::renderApplicationMenuItems()
     {
       fContext->setVSyncEnabled(fConfig.fVSyncEnabled);
     }
+    if(ImGui::BeginMenu("Texture Memory Budget"))
+    {
+      auto textureMemoryBudget = getTextureMemoryBudget();
+      for(auto budget: {256, 512, 1024, 2048, 4096})
+      {
+        if(ImGui::MenuItem(fmt::printf("%d MB", budget).c_str(), nullptr, textureMemoryBudget == budget))
+          textureMemoryBudget = budget;
+      }
+      if(ImGui::MenuItem("Unlimited", nullptr, textureMemoryBudget == 0))
+        textureMemoryBudget = 0;
+      fConfig.fTextureMemoryBudget = textureMemoryBudget;
+      ImGui::EndMenu();
+    }
+    if(ImGui::BeginMenu("GPU Upload Budget"))
+    {
+      auto gpuUploadBudget = getGPUUploadBudget();
+      for(auto budget: {2, 4, 8, 16})
+      {
+        if(ImGui::MenuItem(fmt::printf("%d ms/frame", budget).c_str(), nullptr, gpuUploadBudget == budget))
+          gpuUploadBudget = budget;
+      }
+      if(ImGui::MenuItem("Unlimited", nullptr, gpuUploadBudget == 0))
+        gpuUploadBudget = 0;
+      fConfig.fGPUUploadBudget = gpuUploadBudget;
+      ImGui::EndMenu();
+    }
+    if(ImGui::BeginMenu("Undo History"))
+    {
+      auto maxCount = getUndoHistoryMaxCount();
+      for(auto count: {100, 500, 1000, 5000})
+      {
+        if(ImGui::MenuItem(fmt::printf("%d actions", count).c_str(), nullptr, maxCount == count))
+          maxCount = count;
+      }
+      if(ImGui::MenuItem("Unlimited actions", nullptr, maxCount == 0))
+        maxCount = 0;
+      fConfig.fUndoHistoryMaxCount = maxCount;
+      ImGui::Separator();
+      auto memoryBudget = getUndoHistoryMemoryBudget();
+      for(auto budget: {64, 128, 256, 512, 1024})
+      {
+        if(ImGui::MenuItem(fmt::printf("%d MB", budget).c_str(), nullptr, memoryBudget == budget))
+          memoryBudget = budget;
+      }
+      if(ImGui::MenuItem("Unlimited memory", nullptr, memoryBudget == 0))
+        memoryBudget = 0;
+      fConfig.fUndoHistoryMemoryBudget = memoryBudget;
+      ImGui::EndMenu();
+    }
     ImGui::MenuItem("Show Performance", nullptr, &fConfig.fShowPerformance);
     ImGui::EndMenu();
   }
@@ -1578,32 +1722,35 @@ std::optional<std::string> Application::readFile(fs::path const &iFile, UserErro
 //------------------------------------------------------------------------
 void Application::saveFile(fs::path const &iFile, std::string const &iContent, UserError *oErrors)
 {
+  auto dir = iFile.parent_path();
+  auto tmpFile = dir / fmt::printf("%s.re_edit.tmp", iFile.filename().u8string());
+
   try
   {
-    auto originalContent = readFile(iFile);
-    if(originalContent && *originalContent == iContent)
+    if(impl::hasSameContent(iFile, iContent))
     {
       // no change => no save
       return;
     }
 
     // if the parent directory does not exist, just create it
-    auto dir = iFile.parent_path();
     if(!fs::exists(dir))
       fs::create_directories(dir);
 
     // we do it in 2 steps since step 1 is the one that is more likely to fail
-    // 1. we save in a new file
-    auto tmpFile = dir / fmt::printf("%s.re_edit.tmp", iFile.filename().u8string());
+    // 1. we save in a new file (written in one go from the already generated content)
     std::ofstream f{tmpFile};
     f.exceptions(std::ofstream::ios_base::failbit | std::ofstream::ios_base::badbit);
-    f << iContent;
+    f.write(iContent.data(), static_cast<std::streamsize>(iContent.size()));
     f.close();
-    // 2. we rename
+    // 2. we rename (atomic: the original file is either untouched or fully replaced)
     fs::rename(tmpFile, iFile);
   }
   catch(...)
   {
+    // never leave a partially written temporary file behind
+    std::error_code errorCode;
+    fs::remove(tmpFile, errorCode);
     if(oErrors)
       oErrors->add("Error while saving file %s: %s", iFile.u8string(), what(std::current_exception()));
   }
@@ -33,7 +33,9 @@
 #include "fs.h"
 #include "Config.h"
 #include "Notification.h"
+#include "ThreadPool.h"
 #include <version.h>
+#include <chrono>
 #include <future>
 #include <map>
 
@@ -59,6 +61,8 @@ public:
     virtual void openURL(std::string const &iURL) const = 0;
     virtual void setTargetFrameRate(int iFrameRate) const = 0;
     virtual void setVSyncEnabled(bool iEnabled) const = 0;
+    //! Blocks until an event is received (or the timeout expires)
+    virtual void waitForEvents(double iTimeoutSeconds) const {}
 
     std::shared_ptr<NativePreferencesManager> getPreferencesManager() const { return fPreferencesManager; }
 
@@ -77,6 +81,12 @@ public:
 
   using gui_action_t = std::function<void()>;
 
+  struct FrameStats
+  {
+    long fRenderedCount{};
+    long fSkippedCount{}; // frames not rendered (at the target frame rate) while idle
+  };
+
 public:
   explicit Application(std::shared_ptr<Context> iContext);
   Application(std::shared_ptr<Context> iContext, Application::Config const &iConfig);
@@ -109,6 +119,10 @@ public:
   constexpr int getTargetFrameRate() const { return fConfig.fTargetFrameRate; }
   constexpr bool isVSyncEnabled() const { return fConfig.fVSyncEnabled; }
   constexpr bool isShowPerformance() const { return fConfig.fShowPerformance; }
+  constexpr int getTextureMemoryBudget() const { return fConfig.fTextureMemoryBudget; }
+  constexpr int getGPUUploadBudget() const { return fConfig.fGPUUploadBudget; }
+  constexpr int getUndoHistoryMaxCount() const { return fConfig.fUndoHistoryMaxCount; }
+  constexpr int getUndoHistoryMemoryBudget() const { return fConfig.fUndoHistoryMemoryBudget; }
 
   void onNativeWindowFontDpiScaleChange(float iFontDpiScale);
   void onNativeWindowFontScaleChange(float iFontScale);
@@ -120,6 +134,20 @@ public:
   void renderMainMenu();
   void maybeExit();
   inline bool running() const { return fState != State::kDone; }
+
+  /**
+   * @return `true` when nothing has happened for a while (no input, nothing pending or animating) in which case
+   *         the main loop should call `waitForEvents` instead of rendering a frame */
+  bool isIdle() const;
+
+  /**
+   * Blocks until an event is received (input, window or a wake up from another thread through `UIContext`) or a
+   * timeout expires.
+   *
+   * @return `true` if an event was received (meaning a frame should be rendered) */
+  bool waitForEvents();
+
+  constexpr FrameStats const &getFrameStats() const { return fFrameStats; }
   void exit();
   ReGui::Dialog &newDialog(std::string iTitle, bool iHighPriority = false);
   void newExceptionDialog(std::string iMessage, bool iSaveButton, std::exception_ptr const &iException);
@@ -151,8 +179,8 @@ private:
   template<typename T>
   struct CancellableFuture
   {
-    template< class Function, class... Args >
-    void launch(Function&& f, Args&&... args) { fFuture = std::async(std::launch::async, std::forward<Function>(f), std::forward<Args>(args)...); }
+    template<class Function>
+    void launch(Function&& f) { fFuture = ThreadPool::GetDefault().submit(ThreadPool::Priority::kLoad, std::forward<Function>(f)); }
 
     inline void cancel() { fCancellable->cancel(); }
     inline bool cancelled() const { return fCancellable->cancelled(); }
@@ -185,12 +213,11 @@ private:
   void deferNextFrame(gui_action_t iAction) { if(iAction) fNewFrameActions.emplace_back(std::move(iAction)); }
   void applyConfigStyle() const;
 
-  template<class Function, class... Args>
-  bool async(std::string const &iKey, Function&& f, Args&&... args);
+  template<class Function>
+  bool async(std::string const &iKey, Function&& f);
   bool hasAsyncAction(std::string const &iKey) const { return fAsyncActions.find(iKey) != fAsyncActions.end(); }
 
   void handleNewFrameActions();
-  void handleAsyncActions();
   void handleFontChangeRequest();
 
 private:
@@ -207,8 +234,11 @@ private:
   bool fShowMetricsWindow{false};
 
   std::unique_ptr<CancellableFuture<gui_action_t>> fReLoadingFuture{};
-  std::map<std::string, std::future<gui_action_t>> fAsyncActions{};
+  std::map<std::string, std::future<void>> fAsyncActions{};
   std::vector<gui_action_t> fNewFrameActions{};
+  std::chrono::steady_clock::time_point fLastActivityTime{std::chrono::steady_clock::now()};
+  ImVec2 fLastDisplaySize{};
+  FrameStats fFrameStats{};
   std::vector<std::unique_ptr<ReGui::Dialog>> fDialogs{};
   std::vector<std::unique_ptr<ReGui::Notification>> fNotifications{};
   std::unique_ptr<ReGui::Dialog> fCurrentDialog{};
@@ -30,26 +30,29 @@ void Canvas::begin(screen_pos_t const &iCanvasPos,
                    screen_size_t const &iCanvasSize,
                    canvas_size_t const &iContentSize,
                    ImVec2 const &iRenderScale,
-                   Zoom iZoom,
-                   ImVec4 const &iBackgroundColor)
+                   Zoom iZoom)
 {
   fCanvasPos = iCanvasPos;
   fCanvasSize = {std::max(1.0f, iCanvasSize.x), std::max(1.0f, iCanvasSize.y)};
   fContentSize = iContentSize;
   fRenderScale = iRenderScale;
   updateZoom(iZoom, fFocus);
-  DrawRectangle(0, 0,
-                static_cast<int>(fCanvasSize.x * fRenderScale.x),
-                static_cast<int>(fCanvasSize.y * fRenderScale.y),
-                ReGui::GetRLColor(iBackgroundColor));
 }
 
 //------------------------------------------------------------------------
 // Canvas::begin
 //------------------------------------------------------------------------
-void Canvas::begin(ImVec2 const &iContentSize, ImVec2 const &iRenderScale, Zoom iZoom, ImVec4 const &iBackgroundColor)
+void Canvas::begin(ImVec2 const &iContentSize, ImVec2 const &iRenderScale, Zoom iZoom)
 {
-  begin(ImGui::GetCursorScreenPos(), ImGui::GetContentRegionAvail(), iContentSize, iRenderScale, iZoom, iBackgroundColor);
+  begin(ImGui::GetCursorScreenPos(), ImGui::GetContentRegionAvail(), iContentSize, iRenderScale, iZoom);
+}
+
+//------------------------------------------------------------------------
+// Canvas::clear
+//------------------------------------------------------------------------
+void Canvas::clear(ImVec4 const &iColor) const
+{
+  ClearBackground(ReGui::GetRLColor(iColor));
 }
 
 //------------------------------------------------------------------------
@@ -131,6 +134,13 @@ void Canvas::addTexture(Texture const *iTexture,
                         ImU32 iTextureColor,
                         texture::FX const &iTextureFX) const
 {
+  if(!fDrawTextures)
+  {
+    // the texture is still displayed (from a previous render) => it must not be considered unused
+    iTexture->markDrawn(iFrameNumber);
+    return;
+  }
+
   iTexture->draw(toRenderScreenPos(iPos),
                  (iTextureFX.hasSizeOverride() ? *iTextureFX.fSizeOverride : iTexture->frameSize()) * fZoom.value() * fRenderScale,
                  iFrameNumber,
@@ -144,6 +154,9 @@ void Canvas::addTexture(Texture const *iTexture,
 //------------------------------------------------------------------------
 void Canvas::addRectFilled(Canvas::canvas_pos_t const &iPos, canvas_size_t const &iSize, ImU32 iCol) const
 {
+  if(!fDrawShapes)
+    return;
+
   ImDrawList* dl = ImGui::GetWindowDrawList();
   auto min = toScreenPos(iPos);
   dl->AddRectFilled(min, min + iSize * fZoom.value(), iCol);
@@ -154,6 +167,9 @@ void Canvas::addRectFilled(Canvas::canvas_pos_t const &iPos, canvas_size_t const
 //------------------------------------------------------------------------
 void Canvas::addRect(Canvas::canvas_pos_t const &iPos, canvas_size_t const &iSize, ImU32 iCol) const
 {
+  if(!fDrawShapes)
+    return;
+
   ImDrawList* dl = ImGui::GetWindowDrawList();
   auto min = toScreenPos(iPos);
   dl->AddRect(min, min + iSize * fZoom.value(), iCol);
@@ -164,6 +180,9 @@ void Canvas::addRect(Canvas::canvas_pos_t const &iPos, canvas_size_t const &iSiz
 //------------------------------------------------------------------------
 void Canvas::addLine(Canvas::canvas_pos_t const &iP1, Canvas::canvas_pos_t const &iP2, ImU32 iColor, float iThickness) const
 {
+  if(!fDrawShapes)
+    return;
+
   ImDrawList* dl = ImGui::GetWindowDrawList();
   dl->AddLine(toScreenPos(iP1), toScreenPos(iP2), iColor, iThickness);
 }
@@ -173,6 +192,9 @@ void Canvas::addLine(Canvas::canvas_pos_t const &iP1, Canvas::canvas_pos_t const
 //------------------------------------------------------------------------
 void Canvas::addVerticalLine(canvas_pos_t const &p, ImU32 iColor, float iThickness) const
 {
+  if(!fDrawShapes)
+    return;
+
   auto p1 = toScreenPos(p);
   p1.y = fCanvasPos.y;
   auto p2 = p1;
@@ -186,6 +208,9 @@ void Canvas::addVerticalLine(canvas_pos_t const &p, ImU32 iColor, float iThickne
 //------------------------------------------------------------------------
 void Canvas::addHorizontalLine(canvas_pos_t const &p, ImU32 iColor, float iThickness) const
 {
+  if(!fDrawShapes)
+    return;
+
   auto p1 = toScreenPos(p);
   p1.x = fCanvasPos.x;
   auto p2 = p1;
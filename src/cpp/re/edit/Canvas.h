@@ -54,19 +54,49 @@ public:
   using canvas_pos_t  = ImVec2;
   using canvas_size_t = ImVec2;
 
+  /**
+   * Everything which determines where (and how big) the content gets rendered */
+  struct Viewport
+  {
+    screen_size_t fSize{};
+    screen_pos_t fOffset{};
+    float fZoom{};
+    ImVec2 fRenderScale{};
+
+    constexpr bool operator==(Viewport const &rhs) const
+    {
+      return fSize.x == rhs.fSize.x && fSize.y == rhs.fSize.y &&
+             fOffset.x == rhs.fOffset.x && fOffset.y == rhs.fOffset.y &&
+             fZoom == rhs.fZoom &&
+             fRenderScale.x == rhs.fRenderScale.x && fRenderScale.y == rhs.fRenderScale.y;
+    }
+    constexpr bool operator!=(Viewport const &rhs) const { return !(*this == rhs); }
+  };
+
 public:
-  void begin(ImVec2 const &iContentSize, ImVec2 const &iRenderScale, Zoom iZoom, ImVec4 const &iBackgroundColor);
+  void begin(ImVec2 const &iContentSize, ImVec2 const &iRenderScale, Zoom iZoom);
 
   void begin(screen_pos_t const &iCanvasPos,
              screen_size_t const &iCanvasSize,
              canvas_size_t const &iContentSize,
              ImVec2 const &iRenderScale,
-             Zoom iZoom,
-             ImVec4 const &iBackgroundColor);
+             Zoom iZoom);
 
+  /**
+   * Clears the render texture currently bound (raylib) with the provided color (a fully transparent one for
+   * a layer meant to be composited on top of another one) */
+  void clear(ImVec4 const &iColor) const;
 
   Zoom end();
 
+  /**
+   * Textures are rendered with raylib (into the render texture bound by the caller) whereas shapes (rectangles,
+   * lines...) are added to the ImGui window draw list, on top of the render texture. Restricting what gets drawn
+   * lets the caller render the textures only when they change (the textures skipped are still marked as used). */
+  inline void setDrawFilter(bool iTextures, bool iShapes) { fDrawTextures = iTextures; fDrawShapes = iShapes; }
+
+  inline Viewport getViewport() const { return {fCanvasSize, fOffset, fZoom.value(), fRenderScale}; }
+
   void centerContent();
 
   void addTexture(Texture const *iTexture,
@@ -93,6 +123,14 @@ public:
 
   inline canvas_pos_t getCanvasMousePos() const { return fromScreenPos(ImGui::GetMousePos()); }
 
+  /**
+   * @return the portion of the content (in canvas coordinates) currently visible, optionally expanded by
+   *         `iScreenMargin` pixels on each side (to account for borders drawn outside of the items) */
+  inline ReGui::Rect getVisibleCanvasRect(float iScreenMargin = 0) const {
+    auto margin = ImVec2{iScreenMargin, iScreenMargin};
+    return {fromScreenPos(fCanvasPos - margin), fromScreenPos(fCanvasPos + fCanvasSize + margin)};
+  }
+
   void setFocus(std::optional<canvas_pos_t> const &iFocus) { fFocus = iFocus; }
   std::optional<canvas_pos_t> getFocus() const { return fFocus; }
 
@@ -121,6 +159,9 @@ private:
   bool fIsActive{};
   bool fIsHovered{};
 
+  bool fDrawTextures{true};
+  bool fDrawShapes{true};
+
   screen_pos_t fOffset{};
 };
 
@@ -231,6 +231,10 @@ struct Global
   int fTargetFrameRate{60};
   bool fVSyncEnabled{false};
   bool fShowPerformance{false};
+  int fTextureMemoryBudget{1024}; // in MB (0 means no budget)
+  int fGPUUploadBudget{4}; // in ms per frame (0 means no budget)
+  int fUndoHistoryMaxCount{1000}; // number of actions (0 means no limit)
+  int fUndoHistoryMemoryBudget{256}; // in MB (0 means no budget)
 
   std::vector<Device> fDeviceHistory{};
 
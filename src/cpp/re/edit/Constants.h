@@ -116,6 +116,9 @@ constexpr auto kDeviceNameVertical = ImVec2{65, 395};
 
 constexpr auto kFoldButtonPos = ImVec2{65, 45};
 
+// how far (in screen pixels) outside the visible part of the canvas items are still drawn (borders...)
+constexpr float kCullingScreenMargin = 4.0f;
+
 constexpr float toFloatColor(int iColor) { return static_cast<float>(iColor) / 255.0f; }
 constexpr ImVec4 toFloatColor(int r, int g, int b, int a = 255) { return ImVec4{toFloatColor(r), toFloatColor(g), toFloatColor(b), toFloatColor(a)}; }
 
@@ -125,6 +128,12 @@ constexpr auto kBlackColor = ImVec4{0, 0, 0, 1};
 constexpr auto kErrorColor = ImVec4{1,0,0,1};
 constexpr auto kTipColor = toFloatColor(92, 184, 92);
 constexpr auto kXRayColor = ImVec4{1, 1, 1, 0.4};
+constexpr auto kPendingTextureColor = ImVec4{0.5, 0.5, 0.5, 0.4};
+constexpr int kTextureEvictionFrameCount = 300; // ~5s at 60fps
+constexpr std::size_t kGPUUploadBandSize = 1024 * 1024; // bytes uploaded to the GPU per step
+constexpr int kMaxMipLevels = 4; // downscaled levels of a filmstrip (down to 1/16) used when zoomed out
+constexpr std::size_t kGPUFrameResidencyThreshold = 16 * 1024 * 1024; // bigger filmstrips only keep the frames drawn on the GPU
+constexpr std::size_t kGPUFrameTileSize = 2 * 1024 * 1024; // bytes per tile of frames (frame-range residency)
 constexpr auto kDefaultTintColor = IM_COL32_WHITE;
 constexpr int kDefaultBrightness = 0; // [-255, 255]
 constexpr int kDefaultContrast = 0;   // [-100, 100]
@@ -18,12 +18,19 @@
 
 #include "FilmStrip.h"
 #include "Errors.h"
+#include "ThreadPool.h"
+#include "UIContext.h"
+#include "Utils.h"
 #include "external/stb_image_resize.h"
 #include <regex>
 #include <fstream>
 #include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <array>
 
 extern "C" const char *stbi_failure_reason(void);
+extern "C" int stbi_info(char const *filename, int *x, int *y, int *comp);
 
 namespace re::edit {
 
@@ -43,6 +50,9 @@ static unsigned int stb_decompress(unsigned char* output, const unsigned char* i
 FilmStrip::FilmStrip(std::shared_ptr<Source> iSource, char const *iErrorMessage) :
   fSource{std::move(iSource)},
   fImage{},
+  fWidth{fImage.width()},
+  fHeight{fImage.height()},
+  fState{State::kError},
   fErrorMessage{iErrorMessage}
 {
 //  RE_EDIT_LOG_DEBUG("%p | Error: FilmStrip::FilmStrip(%s) : %s", this, fSource->fKey, iErrorMessage);
@@ -54,11 +64,28 @@ FilmStrip::FilmStrip(std::shared_ptr<Source> iSource, char const *iErrorMessage)
 FilmStrip::FilmStrip(std::shared_ptr<Source> iSource, RLImageRGBA8 &&iImage) :
   fSource{std::move(iSource)},
   fImage{std::move(iImage)},
+  fWidth{fImage.width()},
+  fHeight{fImage.height()},
+  fState{State::kLoaded},
   fErrorMessage{}
 {
 //  RE_EDIT_LOG_DEBUG("%p | FilmStrip::FilmStrip(%s)", this, fSource->fKey);
 }
 
+//------------------------------------------------------------------------
+// FilmStrip::FilmStrip
+//------------------------------------------------------------------------
+FilmStrip::FilmStrip(std::shared_ptr<Source> iSource, int iWidth, int iHeight) :
+  fSource{std::move(iSource)},
+  fImage{},
+  fWidth{iWidth},
+  fHeight{iHeight},
+  fState{State::kPending},
+  fErrorMessage{}
+{
+//  RE_EDIT_LOG_DEBUG("%p | Pending: FilmStrip::FilmStrip(%s)", this, fSource->fKey);
+}
+
 //------------------------------------------------------------------------
 // FilmStrip::~FilmStrip
 //------------------------------------------------------------------------
@@ -88,6 +115,54 @@ std::vector<unsigned char> loadCompressedBase85(char const *iCompressedBase85)
   return decompressedData;
 }
 
+//------------------------------------------------------------------------
+// impl::readPNGHeader
+// Reads only the signature + IHDR chunk (first 24 bytes of the file) to extract the dimensions of the image
+//------------------------------------------------------------------------
+bool readPNGHeader(fs::path const &iPath, int &oWidth, int &oHeight)
+{
+  static constexpr unsigned char kSignature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+
+  unsigned char header[24];
+  std::ifstream file(iPath.u8string().c_str(), std::ios::in | std::ios::binary);
+  if(!file.read(reinterpret_cast<char *>(header), sizeof(header)))
+    return false;
+
+  if(std::memcmp(header, kSignature, sizeof(kSignature)) != 0 || std::memcmp(header + 12, "IHDR", 4) != 0)
+    return false;
+
+  // big endian
+  auto readInt = [&header](int iOffset) {
+    return static_cast<int>((static_cast<unsigned int>(header[iOffset]) << 24) |
+                            (static_cast<unsigned int>(header[iOffset + 1]) << 16) |
+                            (static_cast<unsigned int>(header[iOffset + 2]) << 8) |
+                            static_cast<unsigned int>(header[iOffset + 3]));
+  };
+
+  oWidth = readInt(16);
+  oHeight = readInt(20);
+
+  return oWidth > 0 && oHeight > 0;
+}
+
+//------------------------------------------------------------------------
+// impl::readMetadata
+//------------------------------------------------------------------------
+void readMetadata(FilmStrip::Source &ioSource)
+{
+  auto const &path = ioSource.getPath();
+
+  if(!readPNGHeader(path, ioSource.fWidth, ioSource.fHeight))
+  {
+    ioSource.fWidth = 0;
+    ioSource.fHeight = 0;
+  }
+
+  std::error_code errorCode;
+  auto fileSize = fs::file_size(path, errorCode);
+  ioSource.fFileSize = errorCode ? 0 : fileSize;
+}
+
 }
 
 //------------------------------------------------------------------------
@@ -98,7 +173,34 @@ std::unique_ptr<FilmStrip> FilmStrip::loadBuiltInCompressedBase85(std::shared_pt
   auto decompressedData = impl::loadCompressedBase85(iSource->getBuiltIn().fCompressedDataBase85);
   RLImageRGBA8 image{LoadImageFromMemory(".png", decompressedData.data(), static_cast<int>(decompressedData.size()))};
   RE_EDIT_INTERNAL_ASSERT(image.isValid(), "%s", stbi_failure_reason());
-  return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, std::move(image)));
+  auto filmStrip = std::unique_ptr<FilmStrip>(new FilmStrip(iSource, std::move(image)));
+  filmStrip->fMipLevels = generateMipLevels(filmStrip->fImage, filmStrip->numFrames());
+  return filmStrip;
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::decode
+//------------------------------------------------------------------------
+RLImageRGBA8 FilmStrip::decode(Source const &iSource, FilmStripCache const *iCache, std::string &oErrorMessage)
+{
+  if(iCache)
+  {
+    auto image = iCache->load(iSource);
+    if(image.isValid())
+      return image;
+  }
+
+  RLImageRGBA8 image{LoadImage(iSource.getPath().u8string().c_str())};
+  if(!image.isValid())
+  {
+    auto reason = stbi_failure_reason();
+    oErrorMessage = reason ? std::string(reason) : fmt::printf("File not found %s", iSource.getPath().u8string());
+    RE_EDIT_LOG_ERROR("Error loading file [%s] | %s", iSource.getPath().u8string(), oErrorMessage);
+  }
+  else if(iCache)
+    iCache->save(iSource, image);
+
+  return image;
 }
 
 //------------------------------------------------------------------------
@@ -110,18 +212,12 @@ std::unique_ptr<FilmStrip> FilmStrip::load(std::shared_ptr<Source> const &iSourc
 
   if(iSource->hasPath())
   {
-    RLImageRGBA8 image{LoadImage(iSource->getPath().u8string().c_str())};
+    std::string error{};
+    auto image = decode(*iSource, nullptr, error);
     if(image.isValid())
-    {
       return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, std::move(image)));
-    }
     else
-    {
-      auto reason = stbi_failure_reason();
-      auto error = reason ? std::string(reason) : fmt::printf("File not found %s", iSource->getPath().u8string());
-      RE_EDIT_LOG_ERROR("Error loading file [%s] | %s", iSource->getPath().u8string(), error);
       return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, error.c_str()));
-    }
   }
   else
   {
@@ -129,6 +225,137 @@ std::unique_ptr<FilmStrip> FilmStrip::load(std::shared_ptr<Source> const &iSourc
   }
 }
 
+//------------------------------------------------------------------------
+// FilmStrip::loadPending
+//------------------------------------------------------------------------
+std::unique_ptr<FilmStrip> FilmStrip::loadPending(std::shared_ptr<Source> const &iSource)
+{
+  RE_EDIT_ASSERT(iSource->fNumFrames > 0 && iSource->hasPath());
+
+  // dimensions already read when scanning the directory
+  if(iSource->hasDimensions())
+    return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, iSource->fWidth, iSource->fHeight));
+
+  int width, height, components;
+  if(stbi_info(iSource->getPath().u8string().c_str(), &width, &height, &components))
+    return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, width, height));
+
+  auto reason = stbi_failure_reason();
+  auto error = reason ? std::string(reason) : fmt::printf("File not found %s", iSource->getPath().u8string());
+  RE_EDIT_LOG_ERROR("Error loading file [%s] | %s", iSource->getPath().u8string(), error);
+  return std::unique_ptr<FilmStrip>(new FilmStrip(iSource, error.c_str()));
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::decode
+//------------------------------------------------------------------------
+void FilmStrip::decode(std::shared_ptr<FilmStrip> const &iFilmStrip, FilmStripCache const *iCache, int iNumFrames)
+{
+  if(!iFilmStrip->isPending())
+    return;
+
+  std::string error{};
+  auto image = std::make_shared<RLImageRGBA8>(decode(*iFilmStrip->fSource, iCache, error));
+  auto mipLevels = std::make_shared<std::vector<RLImageRGBA8>>(generateMipLevels(*image, iNumFrames));
+
+  // Implementation note: the image is handed over to the UI thread so that the filmstrip changes state on the
+  // same thread the texture gets uploaded to the GPU (std::function requires a copyable lambda, hence shared_ptr)
+  auto action = [iFilmStrip, image, mipLevels, iNumFrames, error] {
+    iFilmStrip->loaded(std::move(*image), std::move(*mipLevels), iNumFrames, error);
+  };
+
+  if(UIContext::HasCurrent())
+    UIContext::GetCurrent().execute(action);
+  else
+    action();
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::loaded
+//------------------------------------------------------------------------
+void FilmStrip::loaded(RLImageRGBA8 &&iImage,
+                       std::vector<RLImageRGBA8> &&iMipLevels,
+                       int iMipLevelsNumFrames,
+                       std::string const &iErrorMessage)
+{
+  std::vector<std::function<void()>> listeners{};
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+
+    // already loaded (ensureLoaded) or deleted in the meantime
+    if(fState != State::kPending && fState != State::kUnloaded)
+      return;
+
+    if(iImage.isValid())
+    {
+      fImage = std::move(iImage);
+      fWidth = fImage.width();
+      fHeight = fImage.height();
+      // the number of frames may have been overridden while decoding (the levels would not match the frames)
+      if(iMipLevelsNumFrames == numFrames())
+        fMipLevels = std::move(iMipLevels);
+      else
+        fMipLevels.clear();
+      fState = State::kLoaded;
+    }
+    else
+    {
+      fErrorMessage = iErrorMessage;
+      fState = State::kError;
+    }
+
+    listeners = std::move(fLoadedListeners);
+  }
+
+  for(auto &listener: listeners)
+    listener();
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::releasePixels
+//------------------------------------------------------------------------
+bool FilmStrip::releasePixels()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+
+  // built-ins are small and cannot be decoded again from disk
+  if(!isLoaded() || !hasPath())
+    return false;
+
+  fImage = {};
+  fMipLevels.clear();
+  fState = State::kUnloaded;
+  return true;
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::markPending
+//------------------------------------------------------------------------
+bool FilmStrip::markPending()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if(isUnloaded())
+  {
+    fState = State::kPending;
+    return true;
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::deferUntilLoaded
+//------------------------------------------------------------------------
+bool FilmStrip::deferUntilLoaded(std::function<void()> iListener)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if(isPending())
+  {
+    fLoadedListeners.emplace_back(std::move(iListener));
+    return true;
+  }
+  return false;
+}
 
 //------------------------------------------------------------------------
 // FilmStripMgr::FilmStripMgr
@@ -137,6 +364,17 @@ FilmStripMgr::FilmStripMgr(std::vector<BuiltIns::Def> const &iBuiltIns,
                            std::optional<fs::path> iDirectory) :
   fDirectory{std::move(iDirectory)}
 {
+  if(fDirectory)
+  {
+    fCache = std::make_shared<FilmStripCache>(FilmStripCache::getDefaultDirectory());
+
+    // the cache directory is shared by all the managers => pruned once (in the background)
+    static std::once_flag kPruneCache{};
+    std::call_once(kPruneCache, [cache = fCache] {
+      ThreadPool::GetDefault().post(ThreadPool::Priority::kBackground, [cache] { cache->prune(); });
+    });
+  }
+
   for(auto &def: iBuiltIns)
   {
     FilmStrip::key_t key{def.fKey};
@@ -145,6 +383,11 @@ FilmStripMgr::FilmStripMgr(std::vector<BuiltIns::Def> const &iBuiltIns,
   }
 }
 
+//------------------------------------------------------------------------
+// FilmStripMgr::~FilmStripMgr
+//------------------------------------------------------------------------
+FilmStripMgr::~FilmStripMgr() = default;
+
 //------------------------------------------------------------------------
 // FilmStripMgr::overrideNumFrames
 //------------------------------------------------------------------------
@@ -154,10 +397,34 @@ int FilmStrip::overrideNumFrames(int iNumFrames)
     iNumFrames = 1;
 
   auto res = fNumFrames;
+  if(iNumFrames != numFrames())
+    fMipLevels.clear(); // computed with a different number of frames
   fNumFrames = iNumFrames;
   return res;
 }
 
+//------------------------------------------------------------------------
+// FilmStrip::memorySize
+//------------------------------------------------------------------------
+std::size_t FilmStrip::memorySize() const
+{
+  if(!isLoaded())
+    return 0;
+
+  auto res = static_cast<std::size_t>(fWidth) * fHeight * RLImageRGBA8::kBytesPerPixel;
+  for(auto const &level: fMipLevels)
+    res += static_cast<std::size_t>(level.width()) * level.height() * RLImageRGBA8::kBytesPerPixel;
+  return res;
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::metadata
+//------------------------------------------------------------------------
+FilmStrip::Metadata FilmStrip::metadata() const
+{
+  return {key(), hasPath(), width(), height(), numFrames(), fSource->fLastModifiedTime, fSource->fFileSize};
+}
+
 //------------------------------------------------------------------------
 // operator<< JboxColor3
 //------------------------------------------------------------------------
@@ -263,110 +530,239 @@ void ImageRGBA8Resize(Image image, Image newImage)
 }
 
 /**
- * This version, not part of raylib, flips the image into a new image already pre-allocated */
-void ImageRGBA8Flip(Image image, Image newImage)
+ * Downscales `image` into `newImage` (exactly half its size, rounded down) with a 2x2 box filter. The color is
+ * weighted by alpha so that (invisible) fully transparent pixels do not darken the edges. */
+void ImageRGBA8HalfSize(Image image, Image newImage)
 {
-  RE_EDIT_ASSERT(image.format == RLImageRGBA8::kPixelFormat);
-  RE_EDIT_ASSERT(image.width == newImage.width && image.height == newImage.height);
+  RE_EDIT_ASSERT(image.format == RLImageRGBA8::kPixelFormat && newImage.width == image.width / 2 && newImage.height == image.height / 2);
 
-  auto widthInBytes = image.width * RLImageRGBA8::kBytesPerPixel;
+  constexpr auto kBPP = RLImageRGBA8::kBytesPerPixel;
+  auto const srcRowSize = static_cast<std::size_t>(image.width) * kBPP;
+  auto const src = static_cast<unsigned char const *>(image.data);
+  auto dst = static_cast<unsigned char *>(newImage.data);
 
-  for (int i = (image.height - 1), offsetSize = 0; i >= 0; i--)
+  for(int y = 0; y < newImage.height; y++)
   {
-    memcpy(static_cast<unsigned char *>(newImage.data) + offsetSize,
-           static_cast<unsigned char *>(image.data) + i * widthInBytes,
-           widthInBytes);
-    offsetSize += widthInBytes;
+    auto row0 = src + static_cast<std::size_t>(2 * y) * srcRowSize;
+    auto row1 = row0 + srcRowSize;
+    for(int x = 0; x < newImage.width; x++, row0 += 2 * kBPP, row1 += 2 * kBPP, dst += kBPP)
+    {
+      unsigned int const a0 = row0[3], a1 = row0[kBPP + 3], a2 = row1[3], a3 = row1[kBPP + 3];
+      unsigned int const alpha = a0 + a1 + a2 + a3;
+      for(int c = 0; c < 3; c++)
+      {
+        dst[c] = alpha == 0 ? 0 :
+                 static_cast<unsigned char>((row0[c] * a0 + row0[kBPP + c] * a1 + row1[c] * a2 + row1[kBPP + c] * a3 + alpha / 2) / alpha);
+      }
+      dst[3] = static_cast<unsigned char>((alpha + 2) / 4);
+    }
   }
 }
 
+/**
+ * Returns the frame `iFrame` of the image as an image (shares the pixels) */
+Image FrameImage(Image const &iImage, int iFrameHeight, int iFrame)
+{
+  auto frame = iImage;
+  frame.height = iFrameHeight;
+  frame.data = static_cast<unsigned char *>(iImage.data) +
+               static_cast<std::size_t>(iImage.width) * iFrameHeight * iFrame * RLImageRGBA8::kBytesPerPixel;
+  return frame;
 }
 
-//------------------------------------------------------------------------
-// FilmStrip::applyEffects
-//------------------------------------------------------------------------
-std::unique_ptr<FilmStrip> FilmStrip::applyEffects(texture::FX const &iEffects) const
+/**
+ * Tint, brightness and contrast are all computed independently on each channel of each pixel, so their combination
+ * can be precomputed as a lookup table (one per channel). The computations are the same as the raylib apis
+ * (`ImageColorTint`, `ImageColorBrightness` and `ImageColorContrast`) applied in this order. */
+struct ColorLUT
 {
-  RE_EDIT_ASSERT(fImage.isValid());
-
-  auto image = fImage.clone();
+  static std::optional<ColorLUT> from(texture::FX const &iEffects)
+  {
+    if(!iEffects.hasShaderFX())
+      return std::nullopt;
 
-  if(iEffects.hasTint())
-    ImageColorTint(image.rlImagePtr(), ReGui::GetRLColor(iEffects.fTint));
+    ColorLUT res{};
 
-  if(iEffects.hasBrightness())
-    ImageColorBrightness(image.rlImagePtr(), iEffects.fBrightness);
+    auto const tint = ReGui::GetRLColor(iEffects.fTint);
+    float const tintChannels[] = {static_cast<float>(tint.r) / 255,
+                                  static_cast<float>(tint.g) / 255,
+                                  static_cast<float>(tint.b) / 255,
+                                  static_cast<float>(tint.a) / 255};
 
-  if(iEffects.hasContrast())
-    ImageColorContrast(image.rlImagePtr(), static_cast<float>(iEffects.fContrast));
+    auto const brightness = std::clamp(iEffects.fBrightness, -255, 255);
 
-  if(iEffects.isFlippedX())
-    ImageFlipHorizontal(image.rlImagePtr());
+    auto contrast = std::clamp(static_cast<float>(iEffects.fContrast), -100.0f, 100.0f);
+    contrast = (100.0f + contrast) / 100.0f;
+    contrast *= contrast;
 
-  if(iEffects.isFlippedY())
-  {
-    if(numFrames() == 1)
-      ImageFlipVertical(image.rlImagePtr());
-    else
+    for(int channel = 0; channel < 4; channel++)
     {
-      // Implementation note: we need to flip each frame. Using a more efficient API than raylib
-      RLImageRGBA8 newImage{image.width(), image.height()};
+      for(int i = 0; i < 256; i++)
+      {
+        auto v = static_cast<unsigned char>(i);
 
-      auto frameRange = FrameRGBA8Range::create(image, numFrames());
-      auto newFrameRange = FrameRGBA8Range::create(newImage, numFrames());
+        if(iEffects.hasTint())
+          v = static_cast<unsigned char>(((static_cast<float>(v) / 255 * tintChannels[channel]) * 255.0f));
 
-      for(auto frame = frameRange.begin(), newFrame = newFrameRange.begin();
-          frame != frameRange.end() && newFrame != newFrameRange.end();
-          ++frame, ++newFrame)
-      {
-        impl::ImageRGBA8Flip(*frame, *newFrame);
-      }
+        // brightness and contrast do not apply to alpha
+        if(channel < 3)
+        {
+          if(iEffects.hasBrightness())
+          {
+            auto c = v + brightness;
+            if(c < 0) c = 1;
+            if(c > 255) c = 255;
+            v = static_cast<unsigned char>(c);
+          }
+
+          if(iEffects.hasContrast())
+          {
+            auto p = static_cast<float>(v) / 255.0f;
+            p -= 0.5f;
+            p *= contrast;
+            p += 0.5f;
+            p *= 255;
+            if(p < 0) p = 0;
+            if(p > 255) p = 255;
+            v = static_cast<unsigned char>(p);
+          }
+        }
 
-      image = std::move(newImage);
+        res.fTables[channel][i] = v;
+      }
     }
 
+    return res;
   }
 
-  if(iEffects.hasSizeOverride())
+  static void applyRow(ColorLUT const *iLUT, bool iFlipX, int iWidth, unsigned char const *iSrc, unsigned char *oDst)
   {
-    auto newWidth = static_cast<int>(iEffects.fSizeOverride->x);
-    auto newFrameHeight = static_cast<int>(iEffects.fSizeOverride->y);
-
-    if(numFrames() == 1)
+    for(int x = 0; x < iWidth; x++)
     {
-      ImageResize(image.rlImagePtr(), newWidth, newFrameHeight);
+      auto src = iSrc + x * RLImageRGBA8::kBytesPerPixel;
+      auto dst = oDst + (iFlipX ? iWidth - 1 - x : x) * RLImageRGBA8::kBytesPerPixel;
+      if(iLUT)
+      {
+        dst[0] = iLUT->fTables[0][src[0]];
+        dst[1] = iLUT->fTables[1][src[1]];
+        dst[2] = iLUT->fTables[2][src[2]];
+        dst[3] = iLUT->fTables[3][src[3]];
+      }
+      else
+        std::memcpy(dst, src, RLImageRGBA8::kBytesPerPixel);
     }
+  }
+
+  std::array<std::array<unsigned char, 256>, 4> fTables{};
+};
+
+}
+
+//------------------------------------------------------------------------
+// FilmStrip::applyEffects
+//------------------------------------------------------------------------
+std::unique_ptr<FilmStrip> FilmStrip::applyEffects(texture::FX const &iEffects) const
+{
+  RE_EDIT_ASSERT(fImage.isValid());
+
+  auto const numFrames = this->numFrames();
+  auto const frameHeight = this->frameHeight();
+  auto const width = this->width();
+  auto const height = this->height();
+
+  // Implementation note: tint, brightness and contrast are fused into a single pass (lookup table) which also
+  // takes care of flipping. Frames are processed in parallel.
+  auto const lut = impl::ColorLUT::from(iEffects);
+  auto const flipX = iEffects.isFlippedX();
+  auto const flipY = iEffects.isFlippedY();
+
+  RLImageRGBA8 image{width, height};
+
+  auto const processRow = [&lut, flipX, width, src = fImage.data(), dst = image.data()](int iSrcY, int iDstY) {
+    auto const rowSize = static_cast<std::size_t>(width) * RLImageRGBA8::kBytesPerPixel;
+    auto srcRow = src + static_cast<std::size_t>(iSrcY) * rowSize;
+    auto dstRow = dst + static_cast<std::size_t>(iDstY) * rowSize;
+    if(!lut && !flipX)
+      std::memcpy(dstRow, srcRow, rowSize);
     else
-    {
-      // Implementation note: resizing the entire image when there are multiple frames would lead to bleeding between
-      // frames. So we need to resize each frame separately. The raylib apis would be very inefficient in this instance,
-      // thus going down one level and using stbi directly
-      RLImageRGBA8 newImage{newWidth, newFrameHeight * numFrames()};
+      impl::ColorLUT::applyRow(lut ? &*lut : nullptr, flipX, width, srcRow, dstRow);
+  };
 
-      auto frameRange = FrameRGBA8Range::create(image, numFrames());
-      auto newFrameRange = FrameRGBA8Range::create(newImage, numFrames());
+  ThreadPool::GetDefault().parallelFor(ThreadPool::Priority::kInteractive, numFrames, [&processRow, frameHeight, flipY](int iFrame) {
+    auto const frameY = iFrame * frameHeight;
+    for(int y = 0; y < frameHeight; y++)
+      processRow(frameY + y, frameY + (flipY ? frameHeight - 1 - y : y));
+  });
 
-      for(auto frame = frameRange.begin(), newFrame = newFrameRange.begin();
-          frame != frameRange.end() && newFrame != newFrameRange.end();
-          ++frame, ++newFrame)
-      {
-        impl::ImageRGBA8Resize(*frame, *newFrame);
-      }
+  // rows past the last frame (when the height is not a multiple of the number of frames)
+  for(int y = numFrames * frameHeight; y < height; y++)
+    processRow(y, y);
 
-      image = std::move(newImage);
-    }
+  if(iEffects.hasSizeOverride())
+  {
+    auto newWidth = static_cast<int>(iEffects.fSizeOverride->x);
+    auto newFrameHeight = static_cast<int>(iEffects.fSizeOverride->y);
+
+    // Implementation note: resizing the entire image when there are multiple frames would lead to bleeding between
+    // frames. So we need to resize each frame separately. The raylib apis would be very inefficient in this instance,
+    // thus going down one level and using stbi directly
+    RLImageRGBA8 newImage{newWidth, newFrameHeight * numFrames};
+
+    ThreadPool::GetDefault().parallelFor(ThreadPool::Priority::kInteractive, numFrames, [&image, &newImage, frameHeight, newFrameHeight](int iFrame) {
+      impl::ImageRGBA8Resize(impl::FrameImage(image.rlImageRef(), frameHeight, iFrame),
+                             impl::FrameImage(newImage.rlImageRef(), newFrameHeight, iFrame));
+    });
+
+    image = std::move(newImage);
   }
 
   return std::unique_ptr<FilmStrip>(new FilmStrip(nullptr, std::move(image)));;
 }
 
+//------------------------------------------------------------------------
+// FilmStrip::generateMipLevels
+//------------------------------------------------------------------------
+std::vector<RLImageRGBA8> FilmStrip::generateMipLevels(RLImageRGBA8 const &iImage, int iNumFrames)
+{
+  std::vector<RLImageRGBA8> res{};
+
+  if(!iImage.isValid() || iNumFrames < 1)
+    return res;
+
+  auto previous = &iImage;
+  auto frameWidth = iImage.width();
+  auto frameHeight = iImage.height() / iNumFrames;
+
+  while(static_cast<int>(res.size()) < kMaxMipLevels && frameWidth >= 2 && frameHeight >= 2)
+  {
+    auto const newFrameWidth = frameWidth / 2;
+    auto const newFrameHeight = frameHeight / 2;
+    RLImageRGBA8 level{newFrameWidth, newFrameHeight * iNumFrames};
+
+    ThreadPool::GetDefault().parallelFor(ThreadPool::Priority::kLoad, iNumFrames, [previous, &level, frameHeight, newFrameHeight](int iFrame) {
+      impl::ImageRGBA8HalfSize(impl::FrameImage(previous->rlImageRef(), frameHeight, iFrame),
+                               impl::FrameImage(level.rlImageRef(), newFrameHeight, iFrame));
+    });
+
+    res.emplace_back(std::move(level));
+    previous = &res.back();
+    frameWidth = newFrameWidth;
+    frameHeight = newFrameHeight;
+  }
+
+  return res;
+}
+
 //------------------------------------------------------------------------
 // FilmStrip::markDeleted
 //------------------------------------------------------------------------
 void FilmStrip::markDeleted()
 {
+  std::lock_guard<std::mutex> lock(fMutex);
   fImage = {};
+  fMipLevels.clear();
   fErrorMessage = "File has been deleted";
+  fState = State::kError;
 }
 
 //------------------------------------------------------------------------
@@ -382,7 +778,7 @@ std::shared_ptr<FilmStrip> FilmStripMgr::findFilmStrip(FilmStrip::key_t const &i
     auto iterSource = fSources.find(iKey);
     if(iterSource != fSources.end())
     {
-      std::shared_ptr<FilmStrip> filmStrip = FilmStrip::load(iterSource->second);
+      auto filmStrip = load(iterSource->second);
       fFilmStrips[iKey] = filmStrip;
       return filmStrip;
     }
@@ -396,11 +792,11 @@ std::shared_ptr<FilmStrip> FilmStripMgr::findFilmStrip(FilmStrip::key_t const &i
 std::vector<FilmStrip::key_t> FilmStripMgr::findKeys(FilmStrip::Filter const &iFilter) const
 {
   std::vector<FilmStrip::key_t> res{};
-  res.reserve(fFilmStrips.size());
+  res.reserve(fSources.size());
   for(auto const &[k, source]: fSources)
   {
-    auto fs = getFilmStrip(k);
-    if(fs && fs->isValid() && iFilter(*fs))
+    auto metadata = findMetadata(k);
+    if(metadata && iFilter(*metadata))
       res.emplace_back(k);
   }
   return res;
@@ -412,13 +808,51 @@ std::vector<FilmStrip::key_t> FilmStripMgr::findKeys(FilmStrip::Filter const &iF
 //------------------------------------------------------------------------
 bool FilmStripMgr::checkKeyMatchesFilter(FilmStrip::key_t const &iKey, FilmStrip::Filter const &iFilter) const
 {
-  if(fSources.find(iKey) != fSources.end())
+  auto metadata = findMetadata(iKey);
+  return metadata && iFilter(*metadata);
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::findMetadata
+//------------------------------------------------------------------------
+std::optional<FilmStrip::Metadata> FilmStripMgr::findMetadata(FilmStrip::key_t const &iKey) const
+{
+  // when the filmstrip exists, it is the most accurate (the number of frames may have been overridden)
+  auto iterFS = fFilmStrips.find(iKey);
+  if(iterFS != fFilmStrips.end())
+  {
+    if(iterFS->second->isValid())
+      return iterFS->second->metadata();
+    return std::nullopt;
+  }
+
+  auto iterSource = fSources.find(iKey);
+  if(iterSource == fSources.end())
+    return std::nullopt;
+
+  auto const &source = iterSource->second;
+
+  if(source->hasPath())
   {
-    auto fs = getFilmStrip(iKey);
-    if(fs && fs->isValid() && iFilter(*fs))
-      return true;
+    // header could not be read => not a valid image
+    if(!source->hasDimensions())
+      return std::nullopt;
+
+    return FilmStrip::Metadata{source->fKey,
+                               true,
+                               source->fWidth,
+                               source->fHeight,
+                               source->fNumFrames,
+                               source->fLastModifiedTime,
+                               source->fFileSize};
   }
-  return false;
+
+  // built-ins are small and decoded from memory
+  auto filmStrip = getFilmStrip(iKey);
+  if(filmStrip && filmStrip->isValid())
+    return filmStrip->metadata();
+
+  return std::nullopt;
 }
 
 //------------------------------------------------------------------------
@@ -440,12 +874,95 @@ std::shared_ptr<FilmStrip> FilmStripMgr::getFilmStrip(FilmStrip::key_t const &iK
     iterSource = fSources.find(iKey);
   }
 
-  std::shared_ptr<FilmStrip> filmStrip = FilmStrip::load(iterSource->second);
+  auto filmStrip = load(iterSource->second);
   fFilmStrips[iKey] = filmStrip;
 
   return filmStrip;
 }
 
+//------------------------------------------------------------------------
+// FilmStripMgr::load
+//------------------------------------------------------------------------
+std::shared_ptr<FilmStrip> FilmStripMgr::load(std::shared_ptr<FilmStrip::Source> const &iSource) const
+{
+  // built-ins are decoded from memory and are small: no need to defer
+  if(!iSource->hasPath())
+    return FilmStrip::load(iSource);
+
+  std::shared_ptr<FilmStrip> filmStrip = FilmStrip::loadPending(iSource);
+
+  if(filmStrip->isPending())
+    enqueueDecode(filmStrip);
+
+  return filmStrip;
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::enqueueDecode
+//------------------------------------------------------------------------
+void FilmStripMgr::enqueueDecode(std::shared_ptr<FilmStrip> const &iFilmStrip) const
+{
+  ThreadPool::GetDefault().post(ThreadPool::Priority::kLoad, [weakFilmStrip = std::weak_ptr<FilmStrip>(iFilmStrip),
+                                                               cache = fCache,
+                                                               numFrames = iFilmStrip->numFrames()] {
+    // no need to decode a filmstrip nobody is referencing anymore (ex: modified on disk in the meantime)
+    if(auto filmStrip = weakFilmStrip.lock())
+      FilmStrip::decode(filmStrip, cache.get(), numFrames);
+  });
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::scheduleLoad
+//------------------------------------------------------------------------
+void FilmStripMgr::scheduleLoad(std::shared_ptr<FilmStrip> const &iFilmStrip) const
+{
+  if(iFilmStrip && iFilmStrip->markPending())
+    enqueueDecode(iFilmStrip);
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::releasePixels
+//------------------------------------------------------------------------
+std::size_t FilmStripMgr::releasePixels(std::function<bool(FilmStrip const &)> const &iKeepPixels) const
+{
+  std::size_t res = 0;
+  for(auto const &[key, filmStrip]: fFilmStrips)
+  {
+    if(iKeepPixels(*filmStrip))
+      continue;
+    auto size = filmStrip->memorySize();
+    if(filmStrip->releasePixels())
+      res += size;
+  }
+  return res;
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::computeMemorySize
+//------------------------------------------------------------------------
+std::size_t FilmStripMgr::computeMemorySize() const
+{
+  std::size_t res = 0;
+  for(auto const &[key, filmStrip]: fFilmStrips)
+    res += filmStrip->memorySize();
+  return res;
+}
+
+//------------------------------------------------------------------------
+// FilmStripMgr::ensureLoaded
+//------------------------------------------------------------------------
+void FilmStripMgr::ensureLoaded(std::shared_ptr<FilmStrip> const &iFilmStrip) const
+{
+  if(iFilmStrip && (iFilmStrip->isPending() || iFilmStrip->isUnloaded()))
+  {
+    std::string error{};
+    auto image = FilmStrip::decode(*iFilmStrip->fSource, fCache.get(), error);
+    auto mipLevels = FilmStrip::generateMipLevels(image, iFilmStrip->numFrames());
+    // the background decoding (if any) becomes a noop
+    iFilmStrip->loaded(std::move(image), std::move(mipLevels), iFilmStrip->numFrames(), error);
+  }
+}
+
 //------------------------------------------------------------------------
 // FilmStripMgr::scanDirectory
 //------------------------------------------------------------------------
@@ -465,6 +982,9 @@ std::set<FilmStrip::key_t> FilmStripMgr::scanDirectory()
       // the source has been modified on disk
       if(source.fLastModifiedTime != previousSource->fLastModifiedTime)
       {
+        if(fCache && previousSource->hasPath())
+          fCache->invalidate(*previousSource);
+
         // this will trigger a "reload"
         fFilmStrips.erase(source.fKey);
         fSources[source.fKey] = std::make_shared<FilmStrip::Source>(source);
@@ -473,7 +993,9 @@ std::set<FilmStrip::key_t> FilmStripMgr::scanDirectory()
     }
     else
     {
+      // a widget may already reference it (missing texture)
       fSources[source.fKey] = std::make_shared<FilmStrip::Source>(source);
+      modifiedKeys.emplace(source.fKey);
     }
   }
 
@@ -482,6 +1004,8 @@ std::set<FilmStrip::key_t> FilmStripMgr::scanDirectory()
   {
     if(source->hasPath())
     {
+      if(fCache)
+        fCache->invalidate(*source);
       fFilmStrips.erase(key);
       modifiedKeys.emplace(key);
       auto builtInIter = fBuiltIns.find(key);
@@ -495,7 +1019,7 @@ std::set<FilmStrip::key_t> FilmStripMgr::scanDirectory()
     // we don't touch the builtIns
   }
 
-  RE_EDIT_LOG_DEBUG("Scan complete: %ld disk textures (%ld modified)", sources.size(), modifiedKeys.size());
+  RE_EDIT_LOG_DEBUG("Scan complete: %ld disk textures (%ld added/modified/removed)", sources.size(), modifiedKeys.size());
 
   return modifiedKeys;
 }
@@ -538,7 +1062,9 @@ std::vector<FilmStrip::Source> FilmStripMgr::scanDirectory(fs::path const &iDire
           auto inferredNumFrames = m[2].matched ? std::stoi(m[2].str()) : 1;
           auto key = filename;
           key = key.substr(0, key.size() - 4); // remove .png
-          res.emplace_back(FilmStrip::Source{ent.path(), key, static_cast<long>(ent.last_write_time().time_since_epoch().count()), inferredNumFrames});
+          FilmStrip::Source source{ent.path(), key, static_cast<long>(ent.last_write_time().time_since_epoch().count()), inferredNumFrames};
+          impl::readMetadata(source);
+          res.emplace_back(std::move(source));
         }
         else
         {
@@ -653,16 +1179,22 @@ std::pair<FilmStrip::key_t, bool> FilmStripMgr::applyEffects(FilmStrip::key_t co
 
     auto keyFX = FilmStrip::computeKey(iKey, filmStrip->numFrames(), iEffects);
 
-    // do we already know about this?
+    // do we already know about this? (checked before loading so that an existing file never requires decoding
+    // the original)
     auto filmStripFX = findFilmStrip(keyFX);
     if(filmStripFX && filmStripFX->isValid())
       return {keyFX, false};
     else
     {
+      ensureLoaded(filmStrip);
+      if(!filmStrip->isLoaded())
+        return {iKey, false};
+
       // no we don't so save and add to map
       filmStripFX = save(keyFX, filmStrip->applyEffects(iEffects));
       if(filmStripFX)
       {
+        fSources[keyFX] = filmStripFX->fSource;
         fFilmStrips[keyFX] = filmStripFX;
         return {keyFX, true};
       }
@@ -682,18 +1214,292 @@ std::pair<FilmStrip::key_t, bool> FilmStripMgr::applyEffects(FilmStrip::key_t co
 //------------------------------------------------------------------------
 std::set<FilmStrip::key_t> FilmStripMgr::applyEffects(std::vector<FilmStripFX> const &iEffects, UserError *oErrors)
 {
-  std::set<FilmStrip::key_t> modifiedKeys{};
+  struct Job
+  {
+    FilmStrip::key_t fKeyFX{};
+    std::shared_ptr<FilmStrip> fFilmStrip{};
+    texture::FX fEffects{};
+    std::unique_ptr<FilmStrip> fFilmStripFX{};
+  };
+
+  std::vector<Job> candidates{};
+  std::vector<std::shared_ptr<FilmStrip>> toLoad{};
+  std::set<FilmStrip::key_t> keysFX{};
 
+  // 1. determine which filmstrips need to be generated (same logic as applyEffects for 1 key)
   for(auto const &e: iEffects)
   {
-    auto [keyFX, modified] = applyEffects(e.fKey, e.fEffects, oErrors);
-    if(modified)
-      modifiedKeys.emplace(keyFX);
+    if(!e.fEffects.hasAny())
+      continue;
+
+    auto filmStrip = findFilmStrip(e.fKey);
+    if(!filmStrip || !filmStrip->isValid())
+      continue;
+
+    auto keyFX = FilmStrip::computeKey(e.fKey, filmStrip->numFrames(), e.fEffects);
+
+    // already known or already being generated (the output file already exists => the original is not even loaded)
+    if(keysFX.find(keyFX) != keysFX.end())
+      continue;
+    auto filmStripFX = findFilmStrip(keyFX);
+    if(filmStripFX && filmStripFX->isValid())
+      continue;
+
+    // the same original can be used with different effects => decoded only once
+    if((filmStrip->isPending() || filmStrip->isUnloaded()) &&
+       std::find(toLoad.begin(), toLoad.end(), filmStrip) == toLoad.end())
+      toLoad.emplace_back(filmStrip);
+
+    keysFX.emplace(keyFX);
+    candidates.emplace_back(Job{keyFX, filmStrip, e.fEffects});
+  }
+
+  // decode the originals in parallel (same as ensureLoaded but without touching the filmstrips)
+  struct Decoded
+  {
+    int fNumFrames{};
+    RLImageRGBA8 fImage{};
+    std::vector<RLImageRGBA8> fMipLevels{};
+    std::string fError{};
+  };
+
+  std::vector<Decoded> decoded(toLoad.size());
+  for(std::size_t i = 0; i < toLoad.size(); i++)
+    decoded[i].fNumFrames = toLoad[i]->numFrames();
+
+  ThreadPool::GetDefault().parallelFor(ThreadPool::Priority::kInteractive, static_cast<int>(toLoad.size()), [this, &toLoad, &decoded](int i) {
+    auto &d = decoded[i];
+    d.fImage = FilmStrip::decode(*toLoad[i]->fSource, fCache.get(), d.fError);
+    d.fMipLevels = FilmStrip::generateMipLevels(d.fImage, d.fNumFrames);
+  });
+
+  // installing the pixels notifies the listeners (which load the textures on the GPU) => on the calling thread
+  for(std::size_t i = 0; i < toLoad.size(); i++)
+  {
+    auto &d = decoded[i];
+    toLoad[i]->loaded(std::move(d.fImage), std::move(d.fMipLevels), d.fNumFrames, d.fError);
+  }
+
+  std::vector<Job> jobs{};
+  for(auto &job: candidates)
+  {
+    if(job.fFilmStrip->isLoaded())
+      jobs.emplace_back(std::move(job));
+  }
+
+  // 2. apply the effects and encode/save the images in parallel (does not touch the state of the manager)
+  ThreadPool::GetDefault().parallelFor(ThreadPool::Priority::kInteractive, static_cast<int>(jobs.size()), [this, &jobs](int i) {
+    auto &job = jobs[i];
+    job.fFilmStripFX = save(job.fKeyFX, job.fFilmStrip->applyEffects(job.fEffects));
+  });
+
+  // 3. add to the maps
+  std::set<FilmStrip::key_t> modifiedKeys{};
+
+  for(auto &job: jobs)
+  {
+    if(job.fFilmStripFX)
+    {
+      fSources[job.fKeyFX] = job.fFilmStripFX->fSource;
+      fFilmStrips[job.fKeyFX] = std::move(job.fFilmStripFX);
+      modifiedKeys.emplace(job.fKeyFX);
+    }
+    else
+    {
+      if(oErrors && fDirectory)
+        oErrors->add("Error saving file [%s.png]", (*fDirectory / job.fKeyFX).u8string());
+    }
   }
 
   return modifiedKeys;
 }
 
+namespace impl {
+
+struct CacheHeader
+{
+  static constexpr std::uint32_t kMagic = 0x54584552; // "RETX"
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::uint32_t fMagic{kMagic};
+  std::uint32_t fVersion{kVersion};
+  std::int32_t fWidth{};
+  std::int32_t fHeight{};
+  std::int64_t fLastModifiedTime{};
+  std::uint64_t fFileSize{};
+  std::uint64_t fPathSize{};
+};
+
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::getDefaultDirectory
+//------------------------------------------------------------------------
+fs::path FilmStripCache::getDefaultDirectory()
+{
+  std::error_code errorCode;
+  auto tmp = fs::temp_directory_path(errorCode);
+  return (errorCode ? fs::path{"."} : tmp) / "re-edit" / "texture-cache";
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::computeCacheFile
+//------------------------------------------------------------------------
+fs::path FilmStripCache::computeCacheFile(FilmStrip::Source const &iSource) const
+{
+  auto hash = std::hash<std::string>{}(iSource.getPath().u8string());
+  return fDirectory / fmt::printf("%016llx.rgba", static_cast<unsigned long long>(hash));
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::load
+//------------------------------------------------------------------------
+RLImageRGBA8 FilmStripCache::load(FilmStrip::Source const &iSource) const
+{
+  if(!iSource.hasPath() || iSource.fLastModifiedTime == 0)
+    return {};
+
+  auto cacheFile = computeCacheFile(iSource);
+  std::ifstream file(cacheFile.u8string().c_str(), std::ios::in | std::ios::binary);
+  if(!file)
+    return {};
+
+  impl::CacheHeader header{};
+  if(!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+    return {};
+
+  // entry is out of date (or the file has been modified) => ignore
+  if(header.fMagic != impl::CacheHeader::kMagic ||
+     header.fVersion != impl::CacheHeader::kVersion ||
+     header.fLastModifiedTime != iSource.fLastModifiedTime ||
+     header.fFileSize != iSource.fFileSize ||
+     header.fWidth <= 0 || header.fHeight <= 0)
+    return {};
+
+  // check for (unlikely) hash collision
+  auto path = iSource.getPath().u8string();
+  if(header.fPathSize != path.size())
+    return {};
+  std::string cachedPath(static_cast<size_t>(header.fPathSize), '\0');
+  if(!file.read(cachedPath.data(), static_cast<std::streamsize>(cachedPath.size())) || cachedPath != path)
+    return {};
+
+  RLImageRGBA8 image{header.fWidth, header.fHeight};
+  auto size = static_cast<std::streamsize>(header.fWidth) * header.fHeight * RLImageRGBA8::kBytesPerPixel;
+  if(!file.read(reinterpret_cast<char *>(image.data()), size))
+    return {};
+
+  // marks the entry as recently used (see prune)
+  std::error_code errorCode;
+  fs::last_write_time(cacheFile, fs::file_time_type::clock::now(), errorCode);
+
+  return image;
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::save
+//------------------------------------------------------------------------
+void FilmStripCache::save(FilmStrip::Source const &iSource, RLImageRGBA8 const &iImage) const
+{
+  if(!iSource.hasPath() || iSource.fLastModifiedTime == 0 || !iImage.isValid())
+    return;
+
+  try
+  {
+    if(!fs::exists(fDirectory))
+      fs::create_directories(fDirectory);
+
+    auto path = iSource.getPath().u8string();
+
+    impl::CacheHeader header{};
+    header.fWidth = iImage.width();
+    header.fHeight = iImage.height();
+    header.fLastModifiedTime = iSource.fLastModifiedTime;
+    header.fFileSize = iSource.fFileSize;
+    header.fPathSize = path.size();
+
+    // we do it in 2 steps so that a partially written entry is never read (multiple threads may be saving
+    // the same entry)
+    auto cacheFile = computeCacheFile(iSource);
+    auto tmpFile = fs::path{cacheFile}.concat(fmt::printf(".%zx.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    {
+      std::ofstream file(tmpFile.u8string().c_str(), std::ios::out | std::ios::binary);
+      file.exceptions(std::ofstream::ios_base::failbit | std::ofstream::ios_base::badbit);
+      file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+      file.write(path.data(), static_cast<std::streamsize>(path.size()));
+      file.write(reinterpret_cast<char const *>(iImage.data()),
+                 static_cast<std::streamsize>(iImage.width()) * iImage.height() * RLImageRGBA8::kBytesPerPixel);
+    }
+    fs::rename(tmpFile, cacheFile);
+  }
+  catch(std::exception const &e)
+  {
+    RE_EDIT_LOG_WARNING("Error while caching texture %s: %s", iSource.getPath().u8string(), e.what());
+  }
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::invalidate
+//------------------------------------------------------------------------
+void FilmStripCache::invalidate(FilmStrip::Source const &iSource) const
+{
+  std::error_code errorCode;
+  fs::remove(computeCacheFile(iSource), errorCode);
+}
+
+//------------------------------------------------------------------------
+// FilmStripCache::prune
+//------------------------------------------------------------------------
+void FilmStripCache::prune(std::uintmax_t iMaxSize) const
+{
+  struct Entry
+  {
+    fs::path fPath{};
+    fs::file_time_type fLastUsedTime{};
+    std::uintmax_t fSize{};
+  };
+
+  try
+  {
+    std::vector<Entry> entries{};
+    std::uintmax_t totalSize{};
+
+    std::error_code errorCode;
+    for(auto const &file: fs::directory_iterator(fDirectory, errorCode))
+    {
+      // ignores the temporary files (being written)
+      if(!file.is_regular_file() || file.path().extension() != ".rgba")
+        continue;
+      auto size = file.file_size();
+      entries.emplace_back(Entry{file.path(), file.last_write_time(), size});
+      totalSize += size;
+    }
+
+    if(totalSize <= iMaxSize)
+      return;
+
+    std::sort(entries.begin(), entries.end(), [](auto const &l, auto const &r) { return l.fLastUsedTime < r.fLastUsedTime; });
+
+    auto removedCount = 0;
+    for(auto const &entry: entries)
+    {
+      if(totalSize <= iMaxSize)
+        break;
+      if(fs::remove(entry.fPath, errorCode))
+      {
+        totalSize -= entry.fSize;
+        removedCount++;
+      }
+    }
+
+    RE_EDIT_LOG_DEBUG("Texture cache pruned: %d entries removed (%ju bytes left)", removedCount, totalSize);
+  }
+  catch(std::exception const &e)
+  {
+    RE_EDIT_LOG_WARNING("Error while pruning the texture cache %s: %s", fDirectory.u8string(), e.what());
+  }
+}
+
 //------------------------------------------------------------------------
 // FilmStripMgr::toSource
 //------------------------------------------------------------------------
@@ -710,7 +1516,7 @@ std::shared_ptr<FilmStrip::Source> FilmStripMgr::toSource(FilmStrip::key_t const
 //------------------------------------------------------------------------
 // FilmStripMgr::save
 //------------------------------------------------------------------------
-std::unique_ptr<FilmStrip> FilmStripMgr::save(FilmStrip::key_t const &iKey, std::unique_ptr<FilmStrip> iFilmStrip)
+std::unique_ptr<FilmStrip> FilmStripMgr::save(FilmStrip::key_t const &iKey, std::unique_ptr<FilmStrip> iFilmStrip) const
 {
   if(!fDirectory)
     return nullptr;
@@ -724,9 +1530,12 @@ std::unique_ptr<FilmStrip> FilmStripMgr::save(FilmStrip::key_t const &iKey, std:
   }
 
   auto source = std::make_shared<FilmStrip::Source>(FilmStrip::Source::from(iKey, *fDirectory));
-  fSources[iKey] = source;
   iFilmStrip->updateSource(source);
 
+  // no need to decode the image when the project is reopened
+  if(fCache)
+    fCache->save(*source, iFilmStrip->fImage);
+
   return std::move(iFilmStrip);
 }
 
@@ -776,7 +1585,9 @@ FilmStrip::Source FilmStrip::Source::from(key_t const &iKey, fs::path const &iDi
   auto lastWriteTime = fs::last_write_time(path, errorCode);
   if(!errorCode)
   {
-    return {path, iKey, static_cast<long>(lastWriteTime.time_since_epoch().count()), inferredNumFrames};
+    Source source{path, iKey, static_cast<long>(lastWriteTime.time_since_epoch().count()), inferredNumFrames};
+    impl::readMetadata(source);
+    return source;
   }
   else
   {
@@ -26,6 +26,8 @@
 #include <vector>
 #include <functional>
 #include <variant>
+#include <atomic>
+#include <mutex>
 #include <imgui.h>
 #include "fs.h"
 #include <raylib.h>
@@ -77,9 +79,13 @@ struct RLImageRGBA8
 
   RLImageRGBA8 &operator=(RLImageRGBA8 &&iOther) noexcept
   {
-    fImage = iOther.fImage;
-    iOther.fImage.data = nullptr;
-    ensureProperFormat();
+    if(this != &iOther)
+    {
+      UnloadImage(fImage);
+      fImage = iOther.fImage;
+      iOther.fImage.data = nullptr;
+      ensureProperFormat();
+    }
     return *this;
   }
 
@@ -101,6 +107,7 @@ private:
 };
 
 class FilmStrip;
+class FilmStripCache;
 
 struct BuiltIn
 {
@@ -169,14 +176,35 @@ class FilmStrip
 public:
   using key_t = std::string;
 
+  /**
+   * Everything that is known about a filmstrip without decoding its pixels (dimensions are read from the PNG
+   * header when scanning the directory). Filters are evaluated against it. */
+  struct Metadata
+  {
+    constexpr bool hasPath() const { return fHasPath; }
+    constexpr int width() const { return fWidth; }
+    constexpr int height() const { return fHeight; }
+    constexpr int numFrames() const { return fNumFrames; }
+    constexpr int frameWidth() const { return width(); }
+    constexpr int frameHeight() const { return height() / numFrames(); }
+
+    key_t fKey{};
+    bool fHasPath{};
+    int fWidth{};
+    int fHeight{};
+    int fNumFrames{1};
+    long fLastModifiedTime{};
+    std::uintmax_t fFileSize{};
+  };
+
   struct Filter
   {
-    using type = std::function<bool(FilmStrip const &iFilmStrip)>;
+    using type = std::function<bool(Metadata const &iMetadata)>;
 
     Filter() = default;
     Filter(type iAction, std::string iDescription) : fAction{std::move(iAction)}, fDescription{std::move(iDescription)} {}
     explicit operator bool() const { return fAction.operator bool(); }
-    bool operator()(FilmStrip const &f) const { return fAction(f); }
+    bool operator()(Metadata const &m) const { return fAction(m); }
     type fAction{};
     std::string fDescription{};
   };
@@ -192,10 +220,15 @@ public:
     constexpr bool hasBuiltIn() const { return std::holds_alternative<BuiltIn>(fOrigin); }
     constexpr BuiltIn const &getBuiltIn() const { return std::get<BuiltIn>(fOrigin); }
 
+    constexpr bool hasDimensions() const { return fWidth > 0 && fHeight > 0; }
+
     origin_t fOrigin{};
     key_t fKey{};
     long fLastModifiedTime{};
     int fNumFrames{1};
+    int fWidth{};  // from the PNG header (0 for built-ins or if the header could not be read)
+    int fHeight{};
+    std::uintmax_t fFileSize{};
 
     static Source from(key_t const &iKey, fs::path const &iDirectory);
   };
@@ -213,29 +246,72 @@ public:
 
   constexpr std::string const &errorMessage() const { return fErrorMessage; };
 
-  constexpr bool isValid() const { return fImage.isValid(); }
+  //! A filmstrip is valid when its dimensions are known (the pixels may still be loading in the background)
+  inline bool isValid() const { return fState != State::kError; }
+
+  //! `true` while the pixels are being decoded in the background (dimensions are known)
+  inline bool isPending() const { return fState == State::kPending; }
+
+  //! `true` when the pixels are available (`data()` / `rlImage()`)
+  inline bool isLoaded() const { return fState == State::kLoaded; }
 
-  constexpr int width() const { return fImage.width(); }
-  constexpr int height() const { return fImage.height(); }
+  //! `true` when the pixels have been released (see `releasePixels`) and need to be decoded again to be used
+  inline bool isUnloaded() const { return fState == State::kUnloaded; }
+
+  //! Memory used by the pixels (0 when they are not loaded)
+  std::size_t memorySize() const;
+
+  constexpr int width() const { return fWidth; }
+  constexpr int height() const { return fHeight; }
   constexpr int numFrames() const { return fNumFrames > 0 ? fNumFrames : fSource->fNumFrames; }
 
   constexpr int frameWidth() const { return width(); }
   constexpr int frameHeight() const { return height() / numFrames(); }
 
+  Metadata metadata() const;
+
   constexpr RLImageRGBA8::data_t const *data() const { return fImage.data(); }
 
   constexpr Image const &rlImage() const { return fImage.rlImageRef(); }
 
+  /**
+   * Number of downscaled levels available with the pixels (level 0, the image itself, is not included). Level `n` is
+   * the image with every frame downscaled by `2^n` separately so that frames never bleed into each other. */
+  inline int numMipLevels() const { return static_cast<int>(fMipLevels.size()); }
+
+  //! @param iLevel must be in [1, numMipLevels()]
+  inline Image const &mipLevel(int iLevel) const { return fMipLevels.at(iLevel - 1).rlImageRef(); }
+
+  /**
+   * Computes (up to `kMaxMipLevels`) downscaled levels of the image: each level halves every frame (alpha weighted
+   * 2x2 box filter) and stops when a frame would be less than 1 pixel wide or high */
+  static std::vector<RLImageRGBA8> generateMipLevels(RLImageRGBA8 const &iImage, int iNumFrames);
+
   int overrideNumFrames(int iNumFrames);
 
+  /**
+   * If the filmstrip is still pending, registers `iListener` to be invoked (on the UI thread) when the decoding
+   * completes (successfully or not) and returns `true`. Otherwise, returns `false` and `iListener` is never invoked. */
+  bool deferUntilLoaded(std::function<void()> iListener);
+
+  /**
+   * Releases the pixels if they can be decoded again from the source (file on disk). Returns `true` if the pixels
+   * were released. Should be called from the UI thread. */
+  bool releasePixels();
+
   std::unique_ptr<FilmStrip> applyEffects(texture::FX const &iEffects) const;
 
   static std::unique_ptr<FilmStrip> load(std::shared_ptr<Source> const &iSource);
 
+  /**
+   * Reads only the header of the image (dimensions) and returns a pending filmstrip (or a filmstrip in error if
+   * the header cannot be read). The pixels are decoded later with `decode` (see `FilmStripMgr`). */
+  static std::unique_ptr<FilmStrip> loadPending(std::shared_ptr<Source> const &iSource);
+
   static inline auto bySizeFilter(ImVec2 const &iMinSize, ImVec2 const &iMaxSize, std::string iDescription) {
-    return Filter([iMinSize, iMaxSize](FilmStrip const &iFilmStrip) {
-      auto w = iFilmStrip.frameWidth();
-      auto h = iFilmStrip.frameHeight();
+    return Filter([iMinSize, iMaxSize](Metadata const &iMetadata) {
+      auto w = iMetadata.frameWidth();
+      auto h = iMetadata.frameHeight();
       return w >= static_cast<int>(iMinSize.x) && h >= static_cast<int>(iMinSize.y) &&
              w <= static_cast<int>(iMaxSize.x) && h <= static_cast<int>(iMaxSize.y);
     }, std::move(iDescription));
@@ -247,15 +323,15 @@ public:
   }
 
   static inline auto bySizeFilter(ImVec2 const &iSize) {
-    return Filter([iSize](FilmStrip const &iFilmStrip) {
-      return iFilmStrip.frameWidth() == static_cast<int>(iSize.x) &&
-             iFilmStrip.frameHeight() == static_cast<int>(iSize.y);
+    return Filter([iSize](Metadata const &iMetadata) {
+      return iMetadata.frameWidth() == static_cast<int>(iSize.x) &&
+             iMetadata.frameHeight() == static_cast<int>(iSize.y);
     }, fmt::printf("Size must be %dx%d", static_cast<int>(iSize.x), static_cast<int>(iSize.y)));
   }
 
   static inline auto bySingleFrameFilter() {
-    return Filter([](FilmStrip const &iFilmStrip) {
-      return iFilmStrip.numFrames() == 1;
+    return Filter([](Metadata const &iMetadata) {
+      return iMetadata.numFrames() == 1;
     }, "Must have exactly one frame");
   }
 
@@ -266,8 +342,8 @@ public:
     if(!iFilter2)
       return iFilter1;
 
-    return {[f1 = std::move(iFilter1.fAction), f2 = std::move(iFilter2.fAction)](FilmStrip const &iFilmStrip) {
-      return f1(iFilmStrip) || f2(iFilmStrip);
+    return {[f1 = std::move(iFilter1.fAction), f2 = std::move(iFilter2.fAction)](Metadata const &iMetadata) {
+      return f1(iMetadata) || f2(iMetadata);
     }, fmt::printf("%s or %s", iFilter1.fDescription, iFilter2.fDescription)};
   }
 
@@ -278,12 +354,12 @@ public:
     if(!iFilter2)
       return iFilter1;
 
-    return {[f1 = std::move(iFilter1.fAction), f2 = std::move(iFilter2.fAction)](FilmStrip const &iFilmStrip) {
-      return f1(iFilmStrip) && f2(iFilmStrip);
+    return {[f1 = std::move(iFilter1.fAction), f2 = std::move(iFilter2.fAction)](Metadata const &iMetadata) {
+      return f1(iMetadata) && f2(iMetadata);
     }, fmt::printf("%s and %s", iFilter1.fDescription, iFilter2.fDescription)};
   }
 
-  static inline Filter kAllFilter{[] (FilmStrip const &iFilmStrip) { return true; }, "Match all"};
+  static inline Filter kAllFilter{[] (Metadata const &iMetadata) { return true; }, "Match all"};
 
 //  std::unique_ptr<FilmStrip> clone() const;
 
@@ -329,21 +405,36 @@ private:
     constexpr FrameRGBA8Iterator const &end() const { return fEnd; }
   };
 
+private:
+  enum class State { kPending, kLoaded, kUnloaded, kError };
+
 private:
   FilmStrip(std::shared_ptr<Source> iSource, char const *iErrorMessage);
   FilmStrip(std::shared_ptr<Source> iSource, RLImageRGBA8 &&iImage);
+  FilmStrip(std::shared_ptr<Source> iSource, int iWidth, int iHeight);
 
   void updateSource(std::shared_ptr<Source> iSource) { fSource = std::move(iSource); }
   void markDeleted();
+  void loaded(RLImageRGBA8 &&iImage, std::vector<RLImageRGBA8> &&iMipLevels, int iMipLevelsNumFrames, std::string const &iErrorMessage);
+  bool markPending();
 
   static std::unique_ptr<FilmStrip> loadBuiltInCompressedBase85(std::shared_ptr<Source> const &iSource);
+  static RLImageRGBA8 decode(Source const &iSource, FilmStripCache const *iCache, std::string &oErrorMessage);
+  static void decode(std::shared_ptr<FilmStrip> const &iFilmStrip, FilmStripCache const *iCache, int iNumFrames);
 
 private:
   std::shared_ptr<Source> fSource;
   RLImageRGBA8 fImage;
+  std::vector<RLImageRGBA8> fMipLevels{}; // fMipLevels[i] is level i + 1
+  int fWidth;
+  int fHeight;
   int fNumFrames{0};
+  std::atomic<State> fState;
 
   std::string fErrorMessage;
+
+  std::mutex fMutex{};
+  std::vector<std::function<void()>> fLoadedListeners{};
 };
 
 struct FilmStripFX
@@ -354,17 +445,72 @@ struct FilmStripFX
 
 
 
+/**
+ * Persistent (on disk) cache of decoded images so that reopening a project does not inflate every PNG again.
+ * An entry is keyed by the path of the image and is valid only as long as the size and last modified time of
+ * the image match (so it invalidates itself when the image is modified). */
+class FilmStripCache
+{
+public:
+  //! Size of the cache on disk beyond which the least recently used entries are removed (see `prune`)
+  static constexpr std::uintmax_t kMaxSize = 1024 * 1024 * 1024;
+
+  explicit FilmStripCache(fs::path iDirectory) : fDirectory{std::move(iDirectory)} {}
+
+  //! Returns an invalid image when not in the cache (or out of date)
+  RLImageRGBA8 load(FilmStrip::Source const &iSource) const;
+  void save(FilmStrip::Source const &iSource, RLImageRGBA8 const &iImage) const;
+  void invalidate(FilmStrip::Source const &iSource) const;
+
+  /**
+   * Removes the least recently used entries (the modification time of an entry is updated each time it is loaded)
+   * until the cache fits in `iMaxSize` bytes. */
+  void prune(std::uintmax_t iMaxSize = kMaxSize) const;
+
+  static fs::path getDefaultDirectory();
+
+private:
+  fs::path computeCacheFile(FilmStrip::Source const &iSource) const;
+
+private:
+  fs::path fDirectory;
+};
+
 class FilmStripMgr
 {
 public:
   explicit FilmStripMgr(std::vector<BuiltIns::Def> const &iBuiltIns, std::optional<fs::path> iDirectory = std::nullopt);
+  ~FilmStripMgr();
+
   std::shared_ptr<FilmStrip> findFilmStrip(FilmStrip::key_t const &iKey) const;
   std::shared_ptr<FilmStrip> getFilmStrip(FilmStrip::key_t const &iKey) const;
 
+  /**
+   * Makes sure that the pixels of the filmstrip are available, decoding them synchronously (on the calling thread)
+   * if they are still pending. Should be called from the UI thread. */
+  void ensureLoaded(std::shared_ptr<FilmStrip> const &iFilmStrip) const;
+
+  //! If the pixels of the filmstrip were released, schedules them to be decoded again (in the background)
+  void scheduleLoad(std::shared_ptr<FilmStrip> const &iFilmStrip) const;
+
+  /**
+   * Releases the pixels of the filmstrips which can be decoded again, except the ones for which `iKeepPixels` returns
+   * `true`, and returns how much memory was freed */
+  std::size_t releasePixels(std::function<bool(FilmStrip const &)> const &iKeepPixels) const;
+
+  //! Memory used by the pixels of all the filmstrips
+  std::size_t computeMemorySize() const;
+
+  //! Returns the keys of the textures added, modified or removed on disk since the previous scan
   std::set<FilmStrip::key_t> scanDirectory();
   std::vector<FilmStrip::key_t> getKeys() const { return findKeys(FilmStrip::kAllFilter); }
   std::vector<FilmStrip::key_t> findKeys(FilmStrip::Filter const &iFilter) const;
   bool checkKeyMatchesFilter(FilmStrip::key_t const &iKey, FilmStrip::Filter const &iFilter) const;
+
+  /**
+   * Returns the metadata of the filmstrip without decoding its pixels (except for built-ins which are small and
+   * decoded from memory). Returns `std::nullopt` if the key is unknown or the filmstrip is not valid. */
+  std::optional<FilmStrip::Metadata> findMetadata(FilmStrip::key_t const &iKey) const;
   std::optional<FilmStrip::key_t> importTexture(fs::path const &iTexturePath);
   std::set<FilmStrip::key_t> importBuiltIns(std::set<FilmStrip::key_t> const &iKeys, UserError *oErrors = nullptr);
   bool remove(FilmStrip::key_t const &iKey);
@@ -377,9 +523,13 @@ public:
 
 private:
   static std::shared_ptr<FilmStrip::Source> toSource(FilmStrip::key_t const &iKey, BuiltIn const &iBuiltIn);
-  std::unique_ptr<FilmStrip> save(FilmStrip::key_t const &iKey, std::unique_ptr<FilmStrip> iFilmStrip);
+  std::shared_ptr<FilmStrip> load(std::shared_ptr<FilmStrip::Source> const &iSource) const;
+  void enqueueDecode(std::shared_ptr<FilmStrip> const &iFilmStrip) const;
+  //! Thread safe: does not update the state of the manager
+  std::unique_ptr<FilmStrip> save(FilmStrip::key_t const &iKey, std::unique_ptr<FilmStrip> iFilmStrip) const;
 
 private:
+  std::shared_ptr<FilmStripCache> fCache{};
   std::map<FilmStrip::key_t, BuiltIn> fBuiltIns{};
   std::optional<fs::path> fDirectory;
   mutable std::map<FilmStrip::key_t, std::shared_ptr<FilmStrip>> fFilmStrips{};
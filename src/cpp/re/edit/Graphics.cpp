@@ -88,57 +88,12 @@ std::string graphics_device2D_path(Texture const *iTexture, texture::FX const &i
 }
 
 //------------------------------------------------------------------------
-// collectUsedTexturePaths
+// textureSource
 //------------------------------------------------------------------------
-static void collectUsedTexturePaths(Texture const *iTexture, texture::FX const &iEffects, std::set<fs::path> &oPaths)
+static TextureReferences::Source textureSource(Texture::key_t const &iKey, Texture const *iTexture, texture::FX const &iEffects)
 {
-  // Implementation note: this API is used to generate cmake includes. When there is an effect
-  // applied, we do not include the original image
-  if(iTexture)
-  {
-    auto filmStrip = iTexture->getFilmStrip();
-    if(filmStrip)
-    {
-      if(iEffects.hasAny())
-      {
-        auto texture = AppContext::GetCurrent().findTexture(filmStrip->computeKey(iEffects));
-        if(texture)
-          filmStrip = texture->getFilmStrip();
-      }
-
-      if(filmStrip && filmStrip->isValid() && filmStrip->hasPath())
-        oPaths.emplace(filmStrip->path());
-    }
-  }
-}
-
-//------------------------------------------------------------------------
-// collectAllUsedTextureKeys
-//------------------------------------------------------------------------
-static void collectAllUsedTextureKeys(Texture const *iTexture, texture::FX const &iEffects, std::set<FilmStrip::key_t> &oKeys)
-{
-  // Implementation note: this API is used to determine which textures are unused. As a result we include both
-  // the image with effect and the original image (where there is an effect applied)
-  if(iTexture)
-  {
-    auto filmStrip = iTexture->getFilmStrip();
-    if(filmStrip)
-    {
-      if(filmStrip->isValid() && filmStrip->hasPath())
-        oKeys.emplace(filmStrip->key());
-
-      if(iEffects.hasAny())
-      {
-        auto texture = AppContext::GetCurrent().findTexture(filmStrip->computeKey(iEffects));
-        if(texture)
-        {
-          filmStrip = texture->getFilmStrip();
-          if(filmStrip && filmStrip->isValid() && filmStrip->hasPath())
-            oKeys.emplace(filmStrip->key());
-        }
-      }
-    }
-  }
+  auto filmStrip = iTexture ? iTexture->getFilmStrip() : nullptr;
+  return {iKey, iEffects, filmStrip ? filmStrip->numFrames() : 0};
 }
 
 //------------------------------------------------------------------------
@@ -446,30 +401,12 @@ void Graphics::findErrors(AppContext &iCtx, UserError &oErrors) const
 }
 
 //------------------------------------------------------------------------
-// Graphics::collectUsedTexturePaths
-//------------------------------------------------------------------------
-void Graphics::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
-{
-  impl::collectUsedTexturePaths(fDNZTexture.get(), fEffects, oPaths);
-}
-
-//------------------------------------------------------------------------
-// Graphics::collectAllUsedTextureKeys
+// Graphics::collectTextureSources
 //------------------------------------------------------------------------
-void Graphics::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
+void Graphics::collectTextureSources(TextureReferences::sources_t &oSources) const
 {
-  impl::collectAllUsedTextureKeys(fDNZTexture.get(), fEffects, oKeys);
-}
-
-//------------------------------------------------------------------------
-// Graphics::collectFilmStripEffects
-//------------------------------------------------------------------------
-void Graphics::collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const
-{
-  if(hasValidTexture() && fEffects.hasAny())
-  {
-    oEffects.emplace_back(FilmStripFX{getTexture()->key(), fEffects});
-  }
+  if(hasTexture())
+    oSources.emplace_back(re::edit::impl::textureSource(fTextureKey, fDNZTexture.get(), fEffects));
 }
 
 
@@ -929,45 +866,12 @@ void Graphics::hdgui2D(std::string const &iNodeName, attribute_list_t &oAttribut
 }
 
 //------------------------------------------------------------------------
-// Graphics::collectUsedTexturePaths
-//------------------------------------------------------------------------
-void Graphics::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
-{
-  if(hasTexture())
-    re::edit::impl::collectUsedTexturePaths(fDNZTexture.get(), fEffects, oPaths);
-}
-
-//------------------------------------------------------------------------
-// Graphics::collectAllUsedTextureKeys
+// Graphics::collectTextureSources
 //------------------------------------------------------------------------
-void Graphics::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
+void Graphics::collectTextureSources(TextureReferences::sources_t &oSources) const
 {
   if(hasTexture())
-    re::edit::impl::collectAllUsedTextureKeys(fDNZTexture.get(), fEffects, oKeys);
-}
-
-//------------------------------------------------------------------------
-// Graphics::collectFilmStripEffects
-//------------------------------------------------------------------------
-void Graphics::collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const
-{
-  if(hasValidTexture() && fEffects.hasAny())
-  {
-    oEffects.emplace_back(FilmStripFX{getTexture()->key(), fEffects});
-  }
-}
-
-//------------------------------------------------------------------------
-// Graphics::collectUsedTextureBuiltIns
-//------------------------------------------------------------------------
-void Graphics::collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const
-{
-  if(hasTexture())
-  {
-    auto filmStrip = getTexture()->getFilmStrip();
-    if(filmStrip->hasBuiltIn())
-      oKeys.emplace(filmStrip->key());
-  }
+    oSources.emplace_back(re::edit::impl::textureSource(getTextureKey(), fDNZTexture.get(), fEffects));
 }
 
 //------------------------------------------------------------------------
@@ -1023,7 +927,7 @@ std::string Graphics::toValueString() const
 //------------------------------------------------------------------------
 bool Graphics::copyFromAction(Attribute const *iFromAttribute)
 {
-  auto fromAttribute = dynamic_cast<Graphics const *>(iFromAttribute);
+  auto fromAttribute = iFromAttribute->as<Graphics>();
   if(fromAttribute)
   {
     fHitBoundaries = fromAttribute->fHitBoundaries;
@@ -1144,48 +1048,14 @@ bool Background::draw(AppContext &iCtx, ReGui::Canvas &iCanvas, Graphics const *
 }
 
 //------------------------------------------------------------------------
-// Background::collectUsedTexturePaths
-//------------------------------------------------------------------------
-void Background::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
-{
-  auto &app = AppContext::GetCurrent();
-
-  auto texture = app.findTexture(fValue);
-  if(texture && texture->isValid())
-  {
-    auto filmStrip = texture->getFilmStrip();
-    if(filmStrip->hasPath())
-      oPaths.emplace(filmStrip->path());
-  }
-  auto hdTexture = app.findHDTexture(fValue);
-  if(hdTexture && hdTexture->isValid())
-  {
-    auto filmStrip = hdTexture->getFilmStrip();
-    if(filmStrip->hasPath())
-      oPaths.emplace(filmStrip->path());
-  }
-}
-
-//------------------------------------------------------------------------
-// Background::collectUsedTexturePaths
+// Background::collectTextureSources
 //------------------------------------------------------------------------
-void Background::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
+void Background::collectTextureSources(TextureReferences::sources_t &oSources) const
 {
-  auto &app = AppContext::GetCurrent();
-
-  auto texture = app.findTexture(fValue);
-  if(texture && texture->isValid())
-  {
-    auto filmStrip = texture->getFilmStrip();
-    if(filmStrip->hasPath())
-      oKeys.emplace(filmStrip->key());
-  }
-  auto hdTexture = app.findHDTexture(fValue);
-  if(hdTexture && hdTexture->isValid())
+  if(!fValue->empty())
   {
-    auto filmStrip = hdTexture->getFilmStrip();
-    if(filmStrip->hasPath())
-      oKeys.emplace(filmStrip->key());
+    oSources.emplace_back(TextureReferences::Source{*fValue});
+    oSources.emplace_back(TextureReferences::Source{*fValue + "-HD"});
   }
 }
 
@@ -1205,12 +1075,12 @@ inline bool ends_with(std::string const &s, std::string const &iSuffix)
 //------------------------------------------------------------------------
 void Background::editView(AppContext &iCtx)
 {
-  static const FilmStrip::Filter kBackgroundFilter{[](FilmStrip const &f) { return f.numFrames() == 1; }, "Must have exactly 1 frame"};
+  static const FilmStrip::Filter kBackgroundFilter{[](FilmStrip::Metadata const &f) { return f.numFrames() == 1; }, "Must have exactly 1 frame"};
 
   menuView(iCtx);
   ImGui::SameLine();
 
-  if(ImGui::BeginCombo(fName, fValue.c_str()))
+  if(ImGui::BeginCombo(fName, fValue->c_str()))
   {
     auto textureKeys = ReGui::IsFilterEnabled() ? iCtx.findTextureKeys(kBackgroundFilter) : iCtx.getTextureKeys();
     for(auto const &p: textureKeys)
@@ -1244,7 +1114,7 @@ void Background::editView(AppContext &iCtx)
 //------------------------------------------------------------------------
 std::string Background::getValueAsLua() const
 {
-  return re::mock::fmt::printf("jbox.image{ path = \"%s\" }", fValue);
+  return re::mock::fmt::printf("jbox.image{ path = \"%s\" }", fValue->c_str());
 }
 
 }
\ No newline at end of file
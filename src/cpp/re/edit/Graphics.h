@@ -57,9 +57,7 @@ public:
   void setEffects(texture::FX const &iEffects) { fEffects = iEffects; fEdited = true; }
   bool isSizeValid() const;
 
-  void collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const;
-  void collectUsedTexturePaths(std::set<fs::path> &oPaths) const;
-  void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const;
+  void collectTextureSources(TextureReferences::sources_t &oSources) const;
 
   void reset();
   void editView(AppContext &iCtx);
@@ -112,19 +110,25 @@ constexpr bool isContained(ImVec2 const &iPosition, ImVec2 const &iTopLeft, ImVe
 class Graphics : public Attribute
 {
 public:
+  static constexpr kind_t kKind = kind::kGraphics;
+  kind_t getKind() const override { return kKind; }
+
   Graphics() : Attribute("graphics") {}
 
   void hdgui2D(attribute_list_t &oAttributes) const override;
   void hdgui2D(std::string const &iNodeName, attribute_list_t &oAttributes) const;
-  void collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const override;
-  void collectUsedTexturePaths(std::set<fs::path> &oPaths) const override;
-  void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const override;
-  void collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const override;
+  void collectTextureSources(TextureReferences::sources_t &oSources) const override;
 
   std::string device2D() const;
 
   std::string toValueString() const override;
 
+  std::size_t getMemorySize() const override
+  {
+    auto key = std::get_if<Texture::key_t>(&fTexture);
+    return sizeof(*this) + (key ? key->capacity() : 0);
+  }
+
   inline bool contains(ImVec2 const &iPosition) const { return impl::isContained(iPosition, fPosition, getBottomRight()); };
 
   inline bool overlaps(ImVec2 const &iTopLeft, ImVec2 const &iBottomRight) const {
@@ -219,13 +223,15 @@ public:
 class Background : public String
 {
 public:
+  static constexpr kind_t kKind = kind::kBackground | String::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit Background(char const *iName) : String(iName) {}
 
   std::string getValueAsLua() const override;
-  void collectUsedTexturePaths(std::set<fs::path> &oPaths) const override;
-  void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const override;
+  void collectTextureSources(TextureReferences::sources_t &oSources) const override;
 
-  std::string toValueString() const override { return fmt::printf("%s = \"%s\"", fName, fValue); }
+  std::string toValueString() const override { return fmt::printf("%s = \"%s\"", fName, fValue->c_str()); }
 
   void editView(AppContext &iCtx) override;
   bool draw(AppContext &iCtx, ReGui::Canvas &iCanvas, Graphics const *iParent, ImU32 iBorderColor, bool xRay) const;
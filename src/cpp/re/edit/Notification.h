@@ -63,6 +63,8 @@ public:
 
   void dismiss() { fActive = false; }
   constexpr bool isActive() const { return fActive; }
+  //! `true` if the notification dismisses itself after some time (see `dismissAfter`)
+  constexpr bool isTimed() const { return fDismissTime.has_value(); }
   constexpr Key const &key() { return fKey; }
 
 public:
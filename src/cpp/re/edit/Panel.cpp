@@ -106,20 +106,33 @@ Widget *Panel::findWidget(int id) const
 //------------------------------------------------------------------------
 // Panel::draw
 //------------------------------------------------------------------------
-void Panel::draw(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupWindowPadding)
+void Panel::draw(AppContext &iCtx, ReGui::Canvas &iCanvas, DrawLayer iLayer)
 {
-  // rails are always below
-  if(iCtx.fShowRackRails)
-    drawRails(iCtx, iCanvas);
+  fDrawStats = {};
 
-  if(iCtx.fPanelRendering != AppContext::EPanelRendering::kNone)
-    drawPanel(iCtx, iCanvas);
+  // only what intersects the visible portion of the canvas is drawn (margin for the borders)
+  auto const visibleRect = iCanvas.getVisibleCanvasRect(kCullingScreenMargin);
+  fVisibleWidgetIds.clear();
+  fSpatialIndex.findOverlapping(visibleRect, fVisibleWidgetIds);
+
+  if(iLayer != DrawLayer::kMoving)
+  {
+    // rails are always below
+    if(iCtx.fShowRackRails)
+      drawRails(iCtx, iCanvas, visibleRect);
+
+    if(iCtx.fPanelRendering != AppContext::EPanelRendering::kNone)
+      drawPanel(iCtx, iCanvas);
+  }
 
   // always draw decals first
-  drawWidgets(iCtx, iCanvas, fDecalsOrder);
+  drawWidgets(iCtx, iCanvas, fDecalsOrder, fVisibleWidgetIds, iLayer);
 
   // then draws the widgets
-  drawWidgets(iCtx, iCanvas, fWidgetsOrder);
+  drawWidgets(iCtx, iCanvas, fWidgetsOrder, fVisibleWidgetIds, iLayer);
+
+  if(iLayer == DrawLayer::kMoving)
+    return;
 
   // then the cable origin
   drawCableOrigin(iCtx, iCanvas);
@@ -131,7 +144,13 @@ void Panel::draw(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupW
                        kFoldButtonPos,
                        isPanelOfType(fType, kPanelTypeAnyUnfolded) ? 0 : 2);
   }
+}
 
+//------------------------------------------------------------------------
+// Panel::handleCanvasInteractions
+//------------------------------------------------------------------------
+void Panel::handleCanvasInteractions(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupWindowPadding)
+{
   if(fSelectWidgetsAction)
   {
     auto color = ImGui::GetColorU32({1,1,0,1});
@@ -207,7 +226,7 @@ void Panel::draw(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupW
 //------------------------------------------------------------------------
 // Panel::drawRails
 //------------------------------------------------------------------------
-void Panel::drawRails(AppContext const &iCtx, ReGui::Canvas const &iCanvas) const
+void Panel::drawRails(AppContext const &iCtx, ReGui::Canvas const &iCanvas, ReGui::Rect const &iVisibleRect)
 {
   auto rails = iCtx.getBuiltInTexture(BuiltIns::kRackRails.fKey);
   int leftFrame = 0;
@@ -221,10 +240,20 @@ void Panel::drawRails(AppContext const &iCtx, ReGui::Canvas const &iCanvas) cons
   auto leftPos = ImVec2{};
   auto rightPos = ImVec2{kDevicePixelWidth - rails->frameWidth(), 0};
   auto increment = ImVec2{ 0, rails->frameHeight() };
+  auto drawRail = [this, &iCanvas, &iVisibleRect, &rails, size = rails->frameSize()](ImVec2 const &iPos, int iFrame) {
+    if(iPos.x <= iVisibleRect.Max.x && iPos.x + size.x >= iVisibleRect.Min.x &&
+       iPos.y <= iVisibleRect.Max.y && iPos.y + size.y >= iVisibleRect.Min.y)
+    {
+      iCanvas.addTexture(rails.get(), iPos, iFrame);
+      fDrawStats.fDrawnCount++;
+    }
+    else
+      fDrawStats.fCulledCount++;
+  };
   for(int i = 0 ; i < heightRU; i++, leftPos += increment, rightPos += increment)
   {
-    iCanvas.addTexture(rails.get(), leftPos, leftFrame);
-    iCanvas.addTexture(rails.get(), rightPos, rightFrame);
+    drawRail(leftPos, leftFrame);
+    drawRail(rightPos, rightFrame);
   }
 }
 
@@ -256,12 +285,30 @@ void Panel::drawPanel(AppContext const &iCtx, ReGui::Canvas const &iCanvas) cons
 //------------------------------------------------------------------------
 // Panel::drawWidgets
 //------------------------------------------------------------------------
-void Panel::drawWidgets(AppContext &iCtx, ReGui::Canvas &iCanvas, std::vector<int> const &iOrder)
+void Panel::drawWidgets(AppContext &iCtx,
+                        ReGui::Canvas &iCanvas,
+                        std::vector<int> const &iOrder,
+                        std::vector<int> const &iVisibleWidgetIds,
+                        DrawLayer iLayer)
 {
+  // iVisibleWidgetIds is sorted (SpatialIndex::findOverlapping)
   for(auto id: iOrder)
   {
     auto &w = fWidgets[id];
-    w->draw(iCtx, iCanvas);
+    if(w->isHidden())
+      continue;
+
+    // the widgets being moved are the selected ones
+    if((iLayer == DrawLayer::kStatic && w->isSelected()) || (iLayer == DrawLayer::kMoving && !w->isSelected()))
+      continue;
+
+    if(std::binary_search(iVisibleWidgetIds.begin(), iVisibleWidgetIds.end(), id))
+    {
+      w->draw(iCtx, iCanvas);
+      fDrawStats.fDrawnCount++;
+    }
+    else
+      fDrawStats.fCulledCount++;
   }
 }
 
@@ -719,6 +766,7 @@ bool Panel::renderSelectWidgetsByTypeMenuItems(std::vector<Widget *> const &iWid
       if(ImGui::MenuItem(fmt::printf("%s [%d]", def.fName, count).c_str()))
       {
         Widget::selectByType(iWidgets, def.fType, iIncludeHiddenWidgets);
+        fDNZ.markSelectionDirty();
         res = true;
       }
     }
@@ -740,6 +788,7 @@ std::size_t Panel::renderWidgetsMenu(AppContext &iCtx, std::vector<Widget *> con
   {
     for(auto w: iWidgets)
       w->unselect();
+    fDNZ.markSelectionDirty();
   }
   ImGui::EndDisabled();
 
@@ -748,6 +797,7 @@ std::size_t Panel::renderWidgetsMenu(AppContext &iCtx, std::vector<Widget *> con
   {
     for(auto w: iWidgets)
       w->select();
+    fDNZ.markSelectionDirty();
   }
   ImGui::EndDisabled();
 
@@ -788,17 +838,22 @@ std::size_t Panel::renderWidgetsMenu(AppContext &iCtx, std::vector<Widget *> con
 //------------------------------------------------------------------------
 // Panel::findWidgetOnTopAt
 //------------------------------------------------------------------------
-Widget *Panel::findWidgetOnTopAt(std::vector<int> const &iOrder, ImVec2 const &iPosition) const
+Widget *Panel::findWidgetOnTopAt(std::vector<int> const &iOrder, std::vector<int> const &iCandidates) const
 {
-  auto ci = std::find_if(iOrder.rbegin(), iOrder.rend(), [this, &iPosition](auto const id) {
-    auto const &w = fWidgets.at(id);
-    return !w->isHidden() && w->contains(iPosition);
-  });
+  // only the (few) candidates are looked up in the order to find the one on top
+  std::optional<std::size_t> top{};
+  for(auto id: iCandidates)
+  {
+    auto iter = std::find(iOrder.begin(), iOrder.end(), id);
+    if(iter != iOrder.end())
+    {
+      auto index = static_cast<std::size_t>(iter - iOrder.begin());
+      if(!top || index > *top)
+        top = index;
+    }
+  }
 
-  if(ci == iOrder.rend())
-    return nullptr;
-  else
-    return findWidget(*ci);
+  return top ? findWidget(iOrder[*top]) : nullptr;
 }
 
 //------------------------------------------------------------------------
@@ -806,9 +861,19 @@ Widget *Panel::findWidgetOnTopAt(std::vector<int> const &iOrder, ImVec2 const &i
 //------------------------------------------------------------------------
 Widget *Panel::findWidgetOnTopAt(ImVec2 const &iPosition) const
 {
-  auto widget = findWidgetOnTopAt(fWidgetsOrder, iPosition);
+  std::vector<int> candidates{};
+  fSpatialIndex.findAt(iPosition, candidates);
+  candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this, &iPosition](auto id) {
+    auto w = findWidget(id);
+    return !w || w->isHidden() || !w->contains(iPosition);
+  }), candidates.end());
+
+  if(candidates.empty())
+    return nullptr;
+
+  auto widget = findWidgetOnTopAt(fWidgetsOrder, candidates);
   if(!widget)
-    widget = findWidgetOnTopAt(fDecalsOrder, iPosition);
+    widget = findWidgetOnTopAt(fDecalsOrder, candidates);
   return widget;
 }
 
@@ -855,6 +920,7 @@ void Panel::selectWidget(int id, bool iMultiple)
   {
     widget->fSelected = true;
   }
+  fDNZ.markSelectionDirty();
 }
 
 //------------------------------------------------------------------------
@@ -870,6 +936,7 @@ void Panel::selectWidgets(std::set<int> const &iWidgetIds, bool iAddToSelection)
     if(auto w = findWidget(id))
       w->select();
   }
+  fDNZ.markSelectionDirty();
 }
 
 //------------------------------------------------------------------------
@@ -893,6 +960,7 @@ void Panel::selectAll(bool iIncludeHiddenWidgets)
   {
     w->setSelected(iIncludeHiddenWidgets || !w->isHidden());
   }
+  fDNZ.markSelectionDirty();
 }
 
 //------------------------------------------------------------------------
@@ -916,6 +984,7 @@ void Panel::selectByType(WidgetType iType, bool iIncludeHiddenWidgets)
     if(w->getType() == iType && (iIncludeHiddenWidgets || !w->isHidden()))
       w->select();
   }
+  fDNZ.markSelectionDirty();
 }
 
 //------------------------------------------------------------------------
@@ -925,6 +994,7 @@ void Panel::clearSelection()
 {
   for(auto &p: fWidgets)
     p.second->unselect();
+  fDNZ.markSelectionDirty();
 }
 
 
@@ -948,6 +1018,8 @@ std::set<int> Panel::getSelectedWidgetIds() const
 void Panel::markEdited()
 {
   fEdited = true;
+  markModified();
+  fDNZ.markDirty();
   fGraphics.markEdited();
   for(auto &[n, widget]: fWidgets)
     widget->markEdited();
@@ -972,7 +1044,7 @@ bool Panel::checkForErrors(AppContext &iCtx)
   if(fEdited)
   {
     fUserError.clear();
-    fWidgetNameHashes.clear();
+    fWidgetNames.clear();
     if(fGraphics.checkForErrors(iCtx))
       addAllErrors("graphics", fGraphics);
 
@@ -980,11 +1052,12 @@ bool Panel::checkForErrors(AppContext &iCtx)
     {
       if(widget->checkForErrors(iCtx))
         addAllErrors(widget->getName(), *widget);
-      auto [_, inserted] = fWidgetNameHashes.emplace(widget->getNameHash());
+      auto [_, inserted] = fWidgetNames.emplace(widget->getNameSymbol());
       if(!inserted)
         fUserError.add("Duplicate widget names [%s]", widget->getName());
     }
 
+    markModified();
     fEdited = false;
   }
 
@@ -996,26 +1069,36 @@ bool Panel::checkForErrors(AppContext &iCtx)
 //------------------------------------------------------------------------
 std::string Panel::computeUniqueWidgetNameForCopy(std::string const &iOriginalName) const
 {
-  StringWithHash sw{fmt::printf("%s Copy", iOriginalName)};
+  auto name = fmt::printf("%s Copy", iOriginalName);
 
-  if(fWidgetNameHashes.find(sw.hash()) == fWidgetNameHashes.end())
-    return sw.value();
+  if(!isWidgetNameUsed(name))
+    return name;
 
   int i = 2;
   for(;; i++)
   {
-    StringWithHash sw2{fmt::printf("%s Copy (%d)", iOriginalName, i)};
-    if(fWidgetNameHashes.find(sw2.hash()) == fWidgetNameHashes.end())
-      return sw2.value();
+    name = fmt::printf("%s Copy (%d)", iOriginalName, i);
+    if(!isWidgetNameUsed(name))
+      return name;
   }
 }
 
+//------------------------------------------------------------------------
+// Panel::isWidgetNameUsed
+//------------------------------------------------------------------------
+bool Panel::isWidgetNameUsed(std::string const &iName) const
+{
+  // a name which has never been interned cannot be the name of a widget
+  auto symbol = Symbol::find(iName);
+  return symbol && fWidgetNames.find(*symbol) != fWidgetNames.end();
+}
+
 //------------------------------------------------------------------------
 // Panel::ensureUniqueName
 //------------------------------------------------------------------------
 std::unique_ptr<Widget> Panel::ensureUniqueName(std::unique_ptr<Widget> iWidget) const
 {
-  while(fWidgetNameHashes.find(iWidget->getNameHash()) != fWidgetNameHashes.end())
+  while(fWidgetNames.find(iWidget->getNameSymbol()) != fWidgetNames.end())
   {
     iWidget->setNameAction(Widget::computeDefaultWidgetName(iWidget->getType()));
   }
@@ -1035,6 +1118,17 @@ void Panel::editView(AppContext &iCtx)
 //    ImGui::Text("region = %f | itemWidth = %f", ImGui::GetContentRegionAvail().x, kItemWidth);
 
     auto size = dnz().fSelectedWidgets.size();
+
+    // the widget previously shown is no longer edited (selection changed) => commit its pending edits
+    std::optional<int> editedWidgetId{};
+    if(size == 1)
+      editedWidgetId = dnz().fSelectedWidgets[0]->getId();
+    if(editedWidgetId != fEditedWidgetId)
+    {
+      commitEditedWidget();
+      fEditedWidgetId = editedWidgetId;
+    }
+
     switch(size)
     {
       case 0:
@@ -1058,10 +1152,28 @@ void Panel::editView(AppContext &iCtx)
 
     ImGui::PopItemWidth();
   }
+  else
+  {
+    // window is collapsed
+    commitEditedWidget();
+    fEditedWidgetId = std::nullopt;
+  }
   ImGui::End();
 
 }
 
+//------------------------------------------------------------------------
+// Panel::commitEditedWidget
+//------------------------------------------------------------------------
+void Panel::commitEditedWidget()
+{
+  if(fEditedWidgetId)
+  {
+    if(auto widget = findWidget(*fEditedWidgetId))
+      widget->commitEditedName();
+  }
+}
+
 
 //------------------------------------------------------------------------
 // Panel::renderWidgetValues
@@ -1406,6 +1518,8 @@ void Panel::WidgetSelectionList::handleClick(Panel &iPanel, Widget *iWidget, boo
 {
   auto id = iWidget->getId();
 
+  iPanel.fDNZ.markSelectionDirty();
+
   // when iMultiSelectKey is held => multiple selection
   if(iMultiSelectKey)
   {
@@ -1527,12 +1641,12 @@ struct VisibilityProperties
   {
     if(iAttribute)
     {
-      auto &path = iAttribute->fSwitch.fValue;
+      auto const &path = *iAttribute->fSwitch.fValue;
       if(!path.empty())
       {
         auto id = iAttribute->getParent()->getId();
         auto &vp = getOrCreate(path);
-        for(auto value: iAttribute->fValues.fValue)
+        for(auto value: *iAttribute->fValues.fValue)
         {
           vp.add(value, iAttribute->getParent());
         }
@@ -1779,24 +1893,57 @@ char const *Panel::getName() const
   }
 }
 
+//------------------------------------------------------------------------
+// Panel::luaCache
+//------------------------------------------------------------------------
+Panel::LuaCache &Panel::luaCache() const
+{
+  if(fLuaCache.fEditVersion != fEditVersion)
+    fLuaCache = LuaCache{fEditVersion};
+  return fLuaCache;
+}
+
 //------------------------------------------------------------------------
 // Panel::hdgui2D
 //------------------------------------------------------------------------
-std::string Panel::hdgui2D() const
+std::string const &Panel::hdgui2D() const
+{
+  auto &cache = luaCache();
+  if(!cache.fHdgui2D)
+    cache.fHdgui2D = computeHdgui2D();
+  return *cache.fHdgui2D;
+}
+
+//------------------------------------------------------------------------
+// Panel::device2D
+//------------------------------------------------------------------------
+std::string const &Panel::device2D() const
+{
+  auto &cache = luaCache();
+  if(!cache.fDevice2D)
+    cache.fDevice2D = computeDevice2D();
+  return *cache.fDevice2D;
+}
+
+//------------------------------------------------------------------------
+// Panel::computeHdgui2D
+//------------------------------------------------------------------------
+std::string Panel::computeHdgui2D() const
 {
   auto panelName = toString(fType);
 
-  std::stringstream s{};
+  lua::Writer s{};
   s << "--------------------------------------------------------------------------\n";
-  s << fmt::printf("-- %s\n", panelName);
+  s.printf("-- %s\n", panelName);
   s << "--------------------------------------------------------------------------\n";
-  auto arrayName = fmt::printf("%s_widgets", panelName);
-  s << fmt::printf("%s = {}\n", arrayName);
+  s.printf("%s_widgets = {}\n", panelName);
   for(auto id: fWidgetsOrder)
   {
     auto const &w = fWidgets.at(id);
-    s << fmt::printf("-- %s\n", w->getName());
-    s << fmt::printf("%s[#%s + 1] = %s\n", arrayName, arrayName, w->hdgui2D());
+    s.printf("-- %s\n", w->getName());
+    s.printf("%s_widgets[#%s_widgets + 1] = ", panelName, panelName);
+    w->hdgui2D(s);
+    s << '\n';
   }
 
   char const *options = "";
@@ -1807,37 +1954,37 @@ std::string Panel::hdgui2D() const
   if(fCableOrigin)
     cableOrigin = R"( cable_origin = { node = "CableOrigin" },)";
 
-  s << fmt::printf("%s = jbox.panel{ graphics = { node = \"%s\" },%s%s widgets = %s }\n", panelName, fNodeName, options, cableOrigin, arrayName);
+  s.printf("%s = jbox.panel{ graphics = { node = \"%s\" },%s%s widgets = %s_widgets }\n", panelName, fNodeName, options, cableOrigin, panelName);
 
-  return s.str();
+  return s.release();
 }
 
 //------------------------------------------------------------------------
-// Panel::device2D
+// Panel::computeDevice2D
 //------------------------------------------------------------------------
-std::string Panel::device2D() const
+std::string Panel::computeDevice2D() const
 {
   auto panelName = toString(fType);
 
-  std::stringstream s{};
+  lua::Writer s{};
   s << "--------------------------------------------------------------------------\n";
-  s << fmt::printf("-- %s\n", panelName);
+  s.printf("-- %s\n", panelName);
   s << "--------------------------------------------------------------------------\n";
-  s << fmt::printf("%s = {}\n", panelName);
+  s.printf("%s = {}\n", panelName);
 
   s << "\n-- Main panel\n";
-  s << fmt::printf("%s[\"%s\"] = %s\n", panelName, fNodeName, fGraphics.device2D());
+  s.printf("%s[\"%s\"] = %s\n", panelName, fNodeName, fGraphics.device2D());
 
   if(!fDecalsOrder.empty())
   {
     s << "\n-- Decals\n";
-    s << fmt::printf("re_edit.%s = { decals = {} }\n", panelName);
+    s.printf("re_edit.%s = { decals = {} }\n", panelName);
     int index = 1;
     for(auto id: fDecalsOrder)
     {
       auto const &w = fWidgets.at(id);
-      s << fmt::printf("%s[%d] = %s -- %s\n", panelName, index, w->device2D(), w->getName());
-      s << fmt::printf("re_edit.%s.decals[%d] = \"%s\"\n", panelName, index, w->getName());
+      s.printf("%s[%d] = %s -- %s\n", panelName, index, w->device2D(), w->getName());
+      s.printf("re_edit.%s.decals[%d] = \"%s\"\n", panelName, index, w->getName());
       index++;
     }
   }
@@ -1847,16 +1994,79 @@ std::string Panel::device2D() const
   for(auto id: fWidgetsOrder)
   {
     auto const &w = fWidgets.at(id);
-    s << fmt::printf("%s[\"%s\"] = %s\n", panelName, w->getName(), w->device2D());
+    s.printf("%s[\"%s\"] = %s\n", panelName, w->getName(), w->device2D());
   }
   if(fCableOrigin)
   {
     s << "\n-- Cable Origin\n";
-    s << fmt::printf("%s[\"CableOrigin\"] = { offset = { %d, %d } }\n", panelName,
-                     static_cast<int>(fCableOrigin->x), static_cast<int>(fCableOrigin->y));
+    s.printf("%s[\"CableOrigin\"] = { offset = { %d, %d } }\n", panelName,
+             static_cast<int>(fCableOrigin->x), static_cast<int>(fCableOrigin->y));
   }
 
-  return s.str();
+  return s.release();
+}
+
+//------------------------------------------------------------------------
+// Panel::textureReferences
+//------------------------------------------------------------------------
+TextureReferences const &Panel::textureReferences() const
+{
+  // every edit changes fEditVersion => nothing to do if the panel has not been edited since the last time (and
+  // TextureReferences::update leaves the widgets whose sources did not change alone)
+  if(fTextureReferencesVersion != fEditVersion)
+  {
+    TextureReferences::sources_t sources{};
+    fGraphics.collectTextureSources(sources);
+    fTextureReferences.update(kPanelGraphicsOwner, sources, fEditVersion);
+
+    for(auto &[id, w]: fWidgets)
+    {
+      sources.clear();
+      w->collectTextureSources(sources);
+      fTextureReferences.update(id, sources, fEditVersion);
+    }
+
+    // deleted widgets
+    fTextureReferences.removeStale(fEditVersion);
+
+    fTextureReferencesVersion = fEditVersion;
+  }
+
+  return fTextureReferences;
+}
+
+//------------------------------------------------------------------------
+// Panel::markTextureChanged
+//------------------------------------------------------------------------
+void Panel::markTextureChanged(FilmStrip::key_t const &iKey)
+{
+  std::vector<TextureReferences::owner_t> owners{};
+  textureReferences().findOwners(iKey, owners);
+
+  if(owners.empty())
+    return;
+
+  for(auto owner: owners)
+  {
+    // the number of frames (and as a result the key of the texture generated by the effects) may have changed
+    fTextureReferences.invalidate(owner);
+    // the texture may now be missing (or found) => errors must be checked again
+    if(owner == kPanelGraphicsOwner)
+      fGraphics.markEdited();
+    else
+    {
+      // the size may have changed
+      markWidgetChanged(owner);
+      if(auto widget = findWidget(owner))
+        widget->markEdited();
+    }
+  }
+
+  // forces the invalidated owners to be recomputed on next access
+  fTextureReferencesVersion = 0;
+
+  // only the owners marked above are checked again (see checkForErrors)
+  fEdited = true;
 }
 
 //------------------------------------------------------------------------
@@ -1864,10 +2074,25 @@ std::string Panel::device2D() const
 //------------------------------------------------------------------------
 void Panel::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
 {
-  fGraphics.collectUsedTexturePaths(oPaths);
+  auto const &ctx = AppContext::GetCurrent();
 
-  for(auto &[id, w]: fWidgets)
-    w->collectUsedTexturePaths(oPaths);
+  // Implementation note: this API is used to generate cmake includes. When there is an effect applied, we do not
+  // include the original image (unless the image with the effect has not been generated yet)
+  textureReferences().forEach([&ctx, &oPaths](Symbol const &iKey, TextureReferences::Node const &iNode) {
+    if(!iNode.isUsedAsIs() && !iNode.isGenerated())
+      return;
+
+    auto texture = ctx.findTexture(iKey.str());
+    if(!texture && iNode.isGenerated())
+      texture = ctx.findTexture(iNode.getFX().fKey);
+
+    if(texture)
+    {
+      auto filmStrip = texture->getFilmStrip();
+      if(filmStrip && filmStrip->isValid() && filmStrip->hasPath())
+        oPaths.emplace(filmStrip->path());
+    }
+  });
 }
 
 //------------------------------------------------------------------------
@@ -1875,10 +2100,19 @@ void Panel::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
 //------------------------------------------------------------------------
 void Panel::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
 {
-  fGraphics.collectAllUsedTextureKeys(oKeys);
+  auto const &ctx = AppContext::GetCurrent();
 
-  for(auto &[id, w]: fWidgets)
-    w->collectAllUsedTextureKeys(oKeys);
+  // Implementation note: this API is used to determine which textures are unused. As a result we include both
+  // the image with effect and the original image (where there is an effect applied)
+  textureReferences().forEach([&ctx, &oKeys](Symbol const &iKey, TextureReferences::Node const &) {
+    auto texture = ctx.findTexture(iKey.str());
+    if(texture)
+    {
+      auto filmStrip = texture->getFilmStrip();
+      if(filmStrip && filmStrip->isValid() && filmStrip->hasPath())
+        oKeys.emplace(iKey.str());
+    }
+  });
 }
 
 //------------------------------------------------------------------------
@@ -1886,8 +2120,20 @@ void Panel::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
 //------------------------------------------------------------------------
 void Panel::collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const
 {
-  for(auto &[id, w]: fWidgets)
-    w->collectUsedTextureBuiltIns(oKeys);
+  auto const &ctx = AppContext::GetCurrent();
+
+  textureReferences().forEach([&ctx, &oKeys](Symbol const &iKey, TextureReferences::Node const &iNode) {
+    if(!iNode.isUsedAsIs() && !iNode.isUsedAsSource())
+      return;
+
+    auto texture = ctx.findTexture(iKey.str());
+    if(texture)
+    {
+      auto filmStrip = texture->getFilmStrip();
+      if(filmStrip && filmStrip->hasBuiltIn())
+        oKeys.emplace(iKey.str());
+    }
+  });
 }
 
 //------------------------------------------------------------------------
@@ -1895,10 +2141,16 @@ void Panel::collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const
 //------------------------------------------------------------------------
 void Panel::collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const
 {
-  fGraphics.collectFilmStripEffects(oEffects);
+  auto const &ctx = AppContext::GetCurrent();
 
-  for(auto &[id, w]: fWidgets)
-    w->collectFilmStripEffects(oEffects);
+  textureReferences().forEach([&ctx, &oEffects](Symbol const &, TextureReferences::Node const &iNode) {
+    if(!iNode.isGenerated())
+      return;
+
+    auto texture = ctx.findTexture(iNode.getFX().fKey);
+    if(texture && texture->isValid())
+      oEffects.emplace_back(iNode.getFX());
+  });
 }
 
 //------------------------------------------------------------------------
@@ -1949,11 +2201,15 @@ void Panel::selectWidgets(AppContext &iCtx, ImVec2 const &iPosition1, ImVec2 con
   if(topLeft.y > bottomRight.y)
     std::swap(topLeft.y, bottomRight.y);
 
-  for(auto &[id, w]: fWidgets)
+  std::vector<int> candidates{};
+  fSpatialIndex.findOverlapping({topLeft, bottomRight}, candidates);
+  for(auto id: candidates)
   {
-    if(!w->isSelected() && !w->isHidden() && w->overlaps(topLeft, bottomRight))
+    auto w = findWidget(id);
+    if(w && !w->isSelected() && !w->isHidden() && w->overlaps(topLeft, bottomRight))
     {
       w->select();
+      fDNZ.markSelectionDirty();
     }
   }
 }
@@ -1963,48 +2219,126 @@ void Panel::selectWidgets(AppContext &iCtx, ImVec2 const &iPosition1, ImVec2 con
 //------------------------------------------------------------------------
 void Panel::beforeEachFrame(AppContext &iCtx)
 {
-  computeDNZ(&iCtx);
+  if(fDNZ.fDirty)
+  {
+    computeDNZ();
+    fDrawVersion++;
+  }
+
+  // the visibility of a widget "by property" is not tracked per widget => any property value change
+  // re-evaluates all of them
+  auto propertyValuesVersion = iCtx.getPropertyValuesVersion();
+  if(fDNZ.fHiddenDirty || fDNZ.fPropertyValuesVersion != propertyValuesVersion)
+  {
+    for(auto &[_, w]: fWidgets)
+      w->computeIsHidden(iCtx);
+    fDNZ.fHiddenDirty = false;
+    fDNZ.fPropertyValuesVersion = propertyValuesVersion;
+    fDrawVersion++;
+  }
+
+  if(fDNZ.hasChanges())
+  {
+    updateDNZ(iCtx);
+    fDrawVersion++;
+  }
+}
+
+namespace impl {
+
+//------------------------------------------------------------------------
+// impl::computeSelectedRect
+//------------------------------------------------------------------------
+std::optional<ReGui::Rect> computeSelectedRect(std::vector<Widget *> const &iSelectedWidgets)
+{
+  std::optional<ReGui::Rect> res{};
+  for(auto w: iSelectedWidgets)
+  {
+    auto tl = w->getTopLeft();
+    auto br = w->getBottomRight();
+    if(res)
+    {
+      res->Min.x = std::min(res->Min.x, tl.x);
+      res->Min.y = std::min(res->Min.y, tl.y);
+      res->Max.x = std::max(res->Max.x, br.x);
+      res->Max.y = std::max(res->Max.y, br.y);
+    }
+    else
+    {
+      res = ReGui::Rect{tl, br};
+    }
+  }
+  return res;
+}
+
 }
 
 //------------------------------------------------------------------------
 // Panel::computeDNZ
 //------------------------------------------------------------------------
-void Panel::computeDNZ(AppContext *iCtx) const
+void Panel::computeDNZ() const
 {
   fDNZ.clear();
 
   for(auto &[_, w]: fWidgets)
   {
-    if(iCtx)
-      w->computeIsHidden(*iCtx);
-
-    auto tl = w->getTopLeft();
-    auto br = w->getBottomRight();
+    updateSpatialIndex(w.get());
 
     fDNZ.fSortedByNameWidgets.emplace_back(w.get());
 
     if(w->isSelected())
-    {
       fDNZ.fSelectedWidgets.emplace_back(w.get());
-      if(fDNZ.fSelectedRect)
-      {
-        fDNZ.fSelectedRect->Min.x = std::min(fDNZ.fSelectedRect->Min.x, tl.x);
-        fDNZ.fSelectedRect->Min.y = std::min(fDNZ.fSelectedRect->Min.y, tl.y);
-        fDNZ.fSelectedRect->Max.x = std::max(fDNZ.fSelectedRect->Max.x, br.x);
-        fDNZ.fSelectedRect->Max.y = std::max(fDNZ.fSelectedRect->Max.y, br.y);
-      }
-      else
-      {
-        fDNZ.fSelectedRect = ReGui::Rect{tl, br};
-      }
-    }
   }
 
   Widget::sortByName(fDNZ.fSortedByNameWidgets);
+  fDNZ.fSelectedRect = impl::computeSelectedRect(fDNZ.fSelectedWidgets);
 
   fDNZ.markClean();
 }
 
+//------------------------------------------------------------------------
+// Panel::updateDNZ
+//------------------------------------------------------------------------
+void Panel::updateDNZ(AppContext &iCtx) const
+{
+  if(!fDNZ.fChangedWidgetIds.empty())
+  {
+    for(auto id: fDNZ.fChangedWidgetIds)
+    {
+      auto w = findWidget(id);
+      if(!w)
+        continue;
+      w->computeIsHidden(iCtx);
+      updateSpatialIndex(w);
+      if(w->isSelected())
+        fDNZ.fSelectedRectDirty = true;
+    }
+    fDNZ.fChangedWidgetIds.clear();
+
+    // only a rename can change the order and the list is already sorted => linear check first
+    if(!Widget::isSortedByName(fDNZ.fSortedByNameWidgets))
+      Widget::sortByName(fDNZ.fSortedByNameWidgets);
+  }
+
+  if(fDNZ.fSelectionDirty)
+  {
+    fDNZ.fSelectedWidgets.clear();
+    for(auto &[_, w]: fWidgets)
+    {
+      if(w->isSelected())
+        fDNZ.fSelectedWidgets.emplace_back(w.get());
+    }
+    fDNZ.fSelectionDirty = false;
+    fDNZ.fSelectedRectDirty = true;
+  }
+
+  if(fDNZ.fSelectedRectDirty)
+  {
+    fDNZ.fSelectedRect = impl::computeSelectedRect(fDNZ.fSelectedWidgets);
+    fDNZ.fSelectedRectDirty = false;
+  }
+}
+
 //------------------------------------------------------------------------
 // PanelAction::getPanel
 //------------------------------------------------------------------------
@@ -2013,6 +2347,15 @@ Panel *PanelAction::getPanel() const
   return AppContext::GetCurrent().getPanel(fPanelType);
 }
 
+//------------------------------------------------------------------------
+// PanelAction::markPanelModified
+//------------------------------------------------------------------------
+void PanelAction::markPanelModified() const
+{
+  if(auto panel = getPanel())
+    panel->markModified();
+}
+
 //------------------------------------------------------------------------
 // Panel::DNZ::clear
 //------------------------------------------------------------------------
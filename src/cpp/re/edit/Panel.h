@@ -20,8 +20,11 @@
 #define RE_EDIT_PANEL_H
 
 #include "Widget.h"
+#include "SpatialIndex.h"
+#include "TextureReferences.h"
 #include <vector>
 #include <set>
+#include <unordered_set>
 #include <string>
 #include <optional>
 
@@ -90,6 +93,16 @@ public:
   static constexpr auto kZoomMin = 0.1f;
   static constexpr auto kZoomMax = 5.0f;
 
+  /**
+   * While widgets are being moved, everything else (the "static" layer) is drawn once and only the widgets being
+   * moved (the selected ones) are drawn every frame, in a layer of their own */
+  enum class DrawLayer
+  {
+    kAll,
+    kStatic,
+    kMoving
+  };
+
 public:
   explicit Panel(PanelType iType);
 
@@ -101,8 +114,13 @@ public:
 
   void setDeviceHeightRU(int iDeviceHeightRU);
 
-  void draw(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupWindowPadding);
+  void draw(AppContext &iCtx, ReGui::Canvas &iCanvas, DrawLayer iLayer = DrawLayer::kAll);
+  //! Draws the selection overlays (marquee, guides) and handles the mouse/keyboard interactions with the canvas
+  void handleCanvasInteractions(AppContext &iCtx, ReGui::Canvas &iCanvas, ImVec2 const &iPopupWindowPadding);
+  inline bool isMovingWidgets() const { return fMoveWidgetsAction.has_value(); }
   void editView(AppContext &iCtx);
+  //! Commits the pending edits of the widget shown in editView (ex: its name, see Widget::commitEditedName)
+  void commitEditedWidget();
   void editOrderView(AppContext &iCtx);
   void visibilityPropertiesView(AppContext &iCtx);
   void markEdited() override;
@@ -143,13 +161,36 @@ public:
   void resetAllWidgetsVisibility(AppContext &iCtx);
   void setWidgetsVisibility(AppContext &iCtx, std::vector<Widget *> const &iWidgets, re::edit::widget::Visibility iVisibility);
 
-  std::string hdgui2D() const;
-  std::string device2D() const;
+  std::string const &hdgui2D() const;
+  std::string const &device2D() const;
+  struct DrawStats
+  {
+    int fDrawnCount{};
+    int fCulledCount{};
+  };
+
+  constexpr DrawStats const &getDrawStats() const { return fDrawStats; }
+  constexpr std::uint64_t getEditVersion() const { return fEditVersion; }
+  //! Changes when something affecting how the panel is drawn changes outside of edits (selection, visibility...)
+  constexpr std::uint64_t getDrawVersion() const { return fDrawVersion; }
+  inline void markModified() { fEditVersion++; }
+  //! Notifies the panel that a widget was modified outside of the panel actions (name, size, visibility...)
+  inline void markWidgetChanged(int iWidgetId) const { fDNZ.markWidgetChanged(iWidgetId); }
+  //! Notifies the panel that the texture `iKey` was modified (the widgets using it are refreshed)
+  void markTextureChanged(FilmStrip::key_t const &iKey);
   void collectUsedTexturePaths(std::set<fs::path> &oPaths) const;
   void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const;
   void collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const;
   void collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const;
 
+  //! Owner of the panel graphics in `textureReferences()` (the other owners are the widgets ids)
+  static constexpr TextureReferences::owner_t kPanelGraphicsOwner = 0;
+
+  /**
+   * Which textures are used by which widgets (and vice versa). Brought up to date when the panel has been edited
+   * since the last call: only the widgets whose textures (key or effects) changed are recomputed. */
+  TextureReferences const &textureReferences() const;
+
   friend class PanelState;
 
   // action implementations (no undo)
@@ -178,7 +219,7 @@ protected:
 private:
   bool selectWidget(AppContext &iCtx, ImVec2 const &iPosition, bool iMultiSelectKey);
   void selectWidgets(AppContext &iCtx, ImVec2 const &iPosition1, ImVec2 const &iPosition2);
-  Widget *findWidgetOnTopAt(std::vector<int> const &iOrder, ImVec2 const &iPosition) const;
+  Widget *findWidgetOnTopAt(std::vector<int> const &iOrder, std::vector<int> const &iCandidates) const;
   Widget *findWidgetOnTopAt(ImVec2 const &iPosition) const;
   void moveWidgets(AppContext &iCtx, ImVec2 const &iPosition, Grid const &iGrid);
   void endMoveWidgets(AppContext &iCtx);
@@ -188,7 +229,9 @@ private:
   void setCableOrigin(ImVec2 const &iPosition);
   void setPanelOptions(bool iDisableSampleDropOnPanel);
   void beforeEachFrame(AppContext &iCtx);
-  void computeDNZ(AppContext *iCtx = nullptr) const;
+  void computeDNZ() const;
+  void updateDNZ(AppContext &iCtx) const;
+  inline void updateSpatialIndex(Widget const *iWidget) const { fSpatialIndex.update(iWidget->getId(), {iWidget->getTopLeft(), iWidget->getBottomRight()}); }
   bool renderPanelWidgetMenu(AppContext &iCtx, ImVec2 const &iPosition);
   bool renderPanelMenus(AppContext &iCtx, std::optional<ImVec2> iPosition = std::nullopt);
   bool renderSelectedWidgetsMenu(AppContext &iCtx, std::vector<Widget *> const &iWidgets);
@@ -197,9 +240,9 @@ private:
   bool renderSelectWidgetsByTypeMenuItems(std::vector<Widget *> const &iWidgets, bool iIncludeHiddenWidgets);
   bool renderWidgetMenu(AppContext &iCtx, Widget *iWidget);
   void renderWidgetValues(Widget const *iWidget);
-  void drawWidgets(AppContext &iCtx, ReGui::Canvas &iCanvas, std::vector<int> const &iOrder);
+  void drawWidgets(AppContext &iCtx, ReGui::Canvas &iCanvas, std::vector<int> const &iOrder, std::vector<int> const &iVisibleWidgetIds, DrawLayer iLayer);
   void drawCableOrigin(AppContext &iCtx, ReGui::Canvas &iCanvas);
-  void drawRails(AppContext const &iCtx, ReGui::Canvas const &iCanvas) const;
+  void drawRails(AppContext const &iCtx, ReGui::Canvas const &iCanvas, ReGui::Rect const &iVisibleRect);
   void drawPanel(AppContext const &iCtx, ReGui::Canvas const &iCanvas) const;
 
   void handleLeftMouseClick(AppContext &iCtx, ReGui::Canvas::canvas_pos_t const &iMousePos);
@@ -209,6 +252,7 @@ private:
   void handleCanvasInputs(AppContext &iCtx, ReGui::Canvas &iCanvas);
   std::string computeUniqueWidgetNameForCopy(std::string const &iOriginalName) const;
   std::unique_ptr<Widget> ensureUniqueName(std::unique_ptr<Widget> iWidget) const;
+  bool isWidgetNameUsed(std::string const &iName) const;
   inline std::unique_ptr<Widget> copy(Widget const *iWidget) const { return iWidget->copy(computeUniqueWidgetNameForCopy(iWidget->getName())); }
 
   template<class T, class... Args >
@@ -260,6 +304,10 @@ private:
     WidgetSelectionList fWidgetSelectionList{};
   };
 
+  /**
+   * Denormalized (derived) view of the widgets. It is fully rebuilt only when widgets are added/removed/replaced
+   * (`markDirty`): every other change (selection, widget modified, widgets moved) is recorded and applied
+   * incrementally in `beforeEachFrame` so that a frame where nothing changed does not touch it. */
   struct DNZ
   {
     std::vector<Widget *> fSelectedWidgets{};
@@ -270,15 +318,43 @@ private:
 
   private:
     void clear();
-    inline void markDirty() { fDirty = true; clear(); }
-    inline void markClean() { fDirty = false; }
+    inline void markDirty() { fDirty = true; fHiddenDirty = true; clear(); }
+    inline void markClean() { fDirty = false; fSelectionDirty = false; fSelectedRectDirty = false; fChangedWidgetIds.clear(); }
+    inline void markSelectionDirty() { fSelectionDirty = true; }
+    inline void markSelectedRectDirty() { fSelectedRectDirty = true; }
+    inline void markWidgetChanged(int iWidgetId)
+    {
+      // consecutive changes to the same widget (ex: dragging a slider) are recorded once
+      if(fChangedWidgetIds.empty() || fChangedWidgetIds.back() != iWidgetId)
+        fChangedWidgetIds.emplace_back(iWidgetId);
+    }
+    inline bool hasChanges() const { return fSelectionDirty || fSelectedRectDirty || !fChangedWidgetIds.empty(); }
 
   private:
     bool fDirty{true};
+    bool fHiddenDirty{true};
+    bool fSelectionDirty{};
+    bool fSelectedRectDirty{};
+    std::vector<int> fChangedWidgetIds{};
+    std::uint64_t fPropertyValuesVersion{}; // "by property" visibility depends on the property values
   };
 
   inline DNZ &dnz() const { if(fDNZ.fDirty) computeDNZ(); return fDNZ; }
 
+  /**
+   * Keeps the lua generated for this panel so that saving only regenerates the panels that were modified since
+   * the last time (the cache is valid as long as `fEditVersion` matches `Panel::fEditVersion`) */
+  struct LuaCache
+  {
+    std::uint64_t fEditVersion{};
+    std::optional<std::string> fHdgui2D{};
+    std::optional<std::string> fDevice2D{};
+  };
+
+  LuaCache &luaCache() const;
+  std::string computeHdgui2D() const;
+  std::string computeDevice2D() const;
+
 private:
   PanelType fType;
   int fDeviceHeightRU{1};
@@ -291,16 +367,25 @@ private:
   std::map<int, std::unique_ptr<Widget>> fWidgets{};
   std::vector<int> fWidgetsOrder{};
   std::vector<int> fDecalsOrder{};
-  std::set<StringWithHash::hash_t> fWidgetNameHashes{};
+  std::unordered_set<Symbol> fWidgetNames{};
   std::optional<WidgetMove> fWidgetMove{};
   std::optional<MouseDrag> fMoveWidgetsAction{};
   std::optional<MouseDrag> fSelectWidgetsAction{};
   std::optional<MouseDrag> fMoveCanvasAction{};
   std::optional<ImVec2> fPopupLocation{};
+  std::optional<int> fEditedWidgetId{}; // the widget shown in editView during the last frame
   int fWidgetCounter{1}; // used for unique id
   OrderSelectionList fWidgetsSelectionList{Panel::WidgetOrDecal::kWidget};
   OrderSelectionList fDecalsSelectionList{Panel::WidgetOrDecal::kDecal};
   mutable DNZ fDNZ{};
+  mutable SpatialIndex fSpatialIndex{}; // widgets bounding boxes (kept in sync in actions + DNZ)
+  mutable TextureReferences fTextureReferences{}; // see textureReferences()
+  mutable std::uint64_t fTextureReferencesVersion{}; // fEditVersion when fTextureReferences was last brought up to date
+  std::vector<int> fVisibleWidgetIds{}; // reused every frame
+  DrawStats fDrawStats{};
+  std::uint64_t fEditVersion{1};
+  std::uint64_t fDrawVersion{1};
+  mutable LuaCache fLuaCache{};
 };
 
 //------------------------------------------------------------------------
@@ -315,6 +400,9 @@ public:
 protected:
   Panel *getPanel() const;
 
+  //! Bumps the edit version of the panel: to be called by the actions modifying it (execute/undo/redo)
+  void markPanelModified() const;
+
 public:
   PanelType fPanelType{PanelType::kUnknown};
 };
@@ -34,6 +34,18 @@ public:
   {
     return this->getPanel();
   }
+
+  void execute() override
+  {
+    this->markPanelModified();
+    ValueAction<Panel, T, PanelAction>::execute();
+  }
+
+  void undo() override
+  {
+    this->markPanelModified();
+    ValueAction<Panel, T, PanelAction>::undo();
+  }
 };
 
 //------------------------------------------------------------------------
@@ -69,6 +81,7 @@ int Panel::addWidgetAction(int iWidgetId, std::unique_ptr<Widget> iWidget, int o
 
   fDNZ.markDirty();
 
+  updateSpatialIndex(iWidget.get());
   fWidgets[iWidgetId] = std::move(iWidget);
 
   return iWidgetId;
@@ -92,6 +105,8 @@ public:
 
   inline bool empty() const { return fSelectedWidgetIds.empty(); }
 
+  inline std::size_t getMemorySize() const { return stl::memorySize(fSelectedWidgetIds); }
+
 private:
   std::set<int> fSelectedWidgetIds{};
 };
@@ -121,6 +136,11 @@ public:
     fWidgetSelection.restore(getPanel());
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + fWidgetSelection.getMemorySize() - sizeof(fWidgetSelection);
+  }
+
 private:
   WidgetSelection fWidgetSelection{};
 };
@@ -181,6 +201,12 @@ public:
     fWidgetSelection.restore(getPanel());
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + stl::memorySize(fWidgetIds) - sizeof(fWidgetIds) +
+           fWidgetSelection.getMemorySize() - sizeof(fWidgetSelection);
+  }
+
 private:
   std::set<int> fWidgetIds{};
   WidgetSelection fWidgetSelection{};
@@ -196,6 +222,7 @@ bool Panel::selectWidgetAction(int id) const
   if(widget && !widget->isSelected())
   {
     widget->select();
+    fDNZ.markSelectionDirty();
     return true;
   }
   return false;
@@ -221,6 +248,7 @@ bool Panel::unselectWidgetAction(int id) const
   if(widget && widget->isSelected())
   {
     widget->unselect();
+    fDNZ.markSelectionDirty();
     return true;
   }
   return false;
@@ -251,15 +279,22 @@ public:
 
   int execute() override
   {
+    markPanelModified();
     fId = getPanel()->addWidgetAction(fId, fWidget->fullClone(), -1);
     return fId;
   }
 
   void undo() override
   {
+    markPanelModified();
     getPanel()->deleteWidgetAction(fId);
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + fWidget->getMemorySize();
+  }
+
 private:
   std::unique_ptr<Widget> fWidget;
   int fId{-1};
@@ -388,6 +423,7 @@ std::pair<std::unique_ptr<Widget>, int> Panel::deleteWidgetAction(int id)
 
     // make sure that we don't have a dangling pointer
     fDNZ.markDirty();
+    fSpatialIndex.remove(id);
 
     std::unique_ptr<Widget> deleted{};
     std::swap(fWidgets[id], deleted);
@@ -413,15 +449,22 @@ public:
 
   void execute() override
   {
+    markPanelModified();
     fWidgetAndOrder = std::move(getPanel()->deleteWidgetAction(fId));
     fUndoEnabled = fWidgetAndOrder.first != nullptr;
   }
 
   void undo() override
   {
+    markPanelModified();
     fId = getPanel()->addWidgetAction(fId, std::move(fWidgetAndOrder.first), fWidgetAndOrder.second);
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + (fWidgetAndOrder.first ? fWidgetAndOrder.first->getMemorySize() : 0);
+  }
+
 private:
   int fId{};
   std::pair<std::unique_ptr<Widget>, int> fWidgetAndOrder{};
@@ -486,6 +529,7 @@ public:
 
   void execute() override
   {
+    markPanelModified();
     fWidget = std::move(getPanel()->replaceWidgetAction(fId, std::move(fWidget)));
   }
 
@@ -494,6 +538,11 @@ public:
     execute(); // same code!
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + (fWidget ? fWidget->getMemorySize() : 0);
+  }
+
 private:
   int fId{};
   std::unique_ptr<Widget> fWidget{};
@@ -542,6 +591,7 @@ std::unique_ptr<Widget> Panel::replaceWidgetAction(int iWidgetId, std::unique_pt
   fDNZ.markDirty();
 
   std::swap(fWidgets[iWidgetId], iWidget);
+  updateSpatialIndex(fWidgets[iWidgetId].get());
   return iWidget;
 }
 
@@ -564,16 +614,23 @@ public:
 
   void execute() override
   {
+    markPanelModified();
     fUndoEnabled = getPanel()->changeWidgetsOrderAction(fSelectedWidgets, fWidgetOrDecal, fDirection) > 0;
   }
 
   void undo() override
   {
+    markPanelModified();
     getPanel()->changeWidgetsOrderAction(fSelectedWidgets,
                                          fWidgetOrDecal,
                                          fDirection == Panel::Direction::kUp ? Panel::Direction::kDown : Panel::Direction::kUp);
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + stl::memorySize(fSelectedWidgets) - sizeof(fSelectedWidgets);
+  }
+
 private:
   std::set<int> fSelectedWidgets{};
   Panel::WidgetOrDecal fWidgetOrDecal{};
@@ -683,6 +740,7 @@ public:
     fUndoEnabled = fMoveDelta.x != 0 || fMoveDelta.y != 0;
     if(fUndoEnabled)
     {
+      markPanelModified();
       auto panel = getPanel();
       fWidgetSelection.save(panel);
       panel->moveWidgetsAction(fWidgetsIds, fMoveDelta);
@@ -691,11 +749,18 @@ public:
 
   void undo() override
   {
+    markPanelModified();
     auto panel = getPanel();
     panel->moveWidgetsAction(fWidgetsIds, {-fMoveDelta.x, -fMoveDelta.y});
     fWidgetSelection.restore(panel);
   }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() + stl::memorySize(fWidgetsIds) - sizeof(fWidgetsIds) +
+           fWidgetSelection.getMemorySize() - sizeof(fWidgetSelection);
+  }
+
 protected:
   bool canMergeWith(Action const *iAction) const override
   {
@@ -774,6 +839,9 @@ void Panel::moveWidgetsAction(std::set<int> const &iWidgetsIds, ImVec2 const &iM
       w->moveAction(iMoveDelta);
       if(w->isEdited())
         fEdited = true;
+      updateSpatialIndex(w);
+      if(w->isSelected())
+        fDNZ.markSelectedRectDirty();
     }
   }
 }
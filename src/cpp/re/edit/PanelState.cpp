@@ -237,29 +237,120 @@ void PanelState::renderPanel(AppContext &iCtx)
     // * it seems out of order because first, we write the Image (since it needs to be below everything), and then
     //   we generate its content. But it works because, ImGui::Image only enqueues the fact that the image associated
     //   to the texture must be rendered and, by the time the action takes place, the texture has been populated
+    // * renderTexture is retained: it is only rendered again when something it depends on changes (see
+    //   CanvasLayerKey). While widgets are being moved, they are rendered every frame in a second (transparent)
+    //   texture composited on top, and renderTexture (which does not contain them) does not change.
 
     constexpr auto uv0 = ImVec2{0, 1};
     auto uv1 = renderRegionSize / textureSize;
     uv1.y = 1 - uv1.y; // need to flip Y
 
+    auto const movingWidgets = fPanel.isMovingWidgets();
+
     auto cp = ImGui::GetCursorScreenPos();
     ImGui::Image(renderTexture.asImTextureID(), regionSize, uv0, uv1);
     ImGui::SetCursorScreenPos(cp); // restore cursor position (Image moves it)
 
+    Texture::RenderTexture *movingLayerRenderTexture{};
+    if(movingWidgets)
+    {
+      movingLayerRenderTexture = &iCtx.getPanelCanvasMovingLayerRenderTexture(regionSize);
+      auto movingLayerUV1 = renderRegionSize / movingLayerRenderTexture->rlTextureSize();
+      movingLayerUV1.y = 1 - movingLayerUV1.y;
+      ImGui::Image(movingLayerRenderTexture->asImTextureID(), regionSize, uv0, movingLayerUV1);
+      ImGui::SetCursorScreenPos(cp);
+    }
+
     auto &canvas = iCtx.getPanelCanvas();
     auto dpiScale = Application::GetCurrent().getCurrentFontDpiScale();
-    BeginTextureMode(renderTexture.asRLRenderTexture()); // all raylib calls will render into renderTexture
     canvas.begin(fPanel.getSize(),
                  renderTexture.scale(),
-                 {iCtx.getZoom(), iCtx.isZoomFitContent(), Panel::kZoomMin * dpiScale, Panel::kZoomMax * dpiScale},
-                 windowBg);
-    fPanel.draw(iCtx, canvas, windowPadding);
+                 {iCtx.getZoom(), iCtx.isZoomFitContent(), Panel::kZoomMin * dpiScale, Panel::kZoomMax * dpiScale});
+
+    // textures (raylib) are only rendered when they change
+    canvas.setDrawFilter(true, false);
+    renderCanvasLayer(iCtx, renderTexture, windowBg,
+                      movingWidgets ? Panel::DrawLayer::kStatic : Panel::DrawLayer::kAll, fCanvasLayerKey);
+    if(movingLayerRenderTexture)
+      renderCanvasLayer(iCtx, *movingLayerRenderTexture, ImVec4{}, Panel::DrawLayer::kMoving, fCanvasMovingLayerKey);
+
+    // shapes (ImGui) are drawn every frame
+    canvas.setDrawFilter(false, true);
+    fPanel.draw(iCtx, canvas);
+    fPanel.handleCanvasInteractions(iCtx, canvas, windowPadding);
+
+    canvas.setDrawFilter(true, true);
     iCtx.setZoom(canvas.end());
-    EndTextureMode(); // finished rendering into renderTexture
   }
   ImGui::PopStyleVar();
 }
 
+//------------------------------------------------------------------------
+// PanelState::computeCanvasLayerKey
+//------------------------------------------------------------------------
+PanelState::CanvasLayerKey PanelState::computeCanvasLayerKey(AppContext const &iCtx,
+                                                             Texture::RenderTexture const &iRenderTexture,
+                                                             ImVec4 const &iBackgroundColor,
+                                                             Panel::DrawLayer iLayer) const
+{
+  CanvasLayerKey key{};
+  key.fContentVersion = iRenderTexture.contentVersion();
+  key.fLayer = iLayer;
+  // moving widgets changes the panel but not what is in the static layer
+  if(iLayer != Panel::DrawLayer::kStatic)
+  {
+    key.fEditVersion = fPanel.getEditVersion();
+    key.fDrawVersion = fPanel.getDrawVersion();
+  }
+  key.fPropertyValuesVersion = iCtx.getPropertyValuesVersion();
+  key.fTexturesGPUVersion = Texture::GetGPUVersion();
+  key.fViewport = iCtx.fPanelCanvas.getViewport();
+  key.fBackgroundColor = ReGui::GetColorU32(iBackgroundColor);
+  key.fSelectedWidgetColor = iCtx.getUserPreferences().fSelectedWidgetColor;
+  key.fWidgetBorderColor = iCtx.getUserPreferences().fWidgetBorderColor;
+  key.fPanelRendering = iCtx.fPanelRendering;
+  key.fWidgetRendering = iCtx.fWidgetRendering;
+  key.fBorderRendering = iCtx.fBorderRendering;
+  key.fCustomDisplayRendering = iCtx.fCustomDisplayRendering;
+  key.fSampleDropZoneRendering = iCtx.fSampleDropZoneRendering;
+  key.fShowRackRails = iCtx.fShowRackRails;
+  key.fShowFoldButton = iCtx.fShowFoldButton;
+  key.fHasFoldedPanels = iCtx.hasFoldedPanels();
+  return key;
+}
+
+//------------------------------------------------------------------------
+// PanelState::renderCanvasLayer
+//------------------------------------------------------------------------
+void PanelState::renderCanvasLayer(AppContext &iCtx,
+                                   Texture::RenderTexture &iRenderTexture,
+                                   ImVec4 const &iBackgroundColor,
+                                   Panel::DrawLayer iLayer,
+                                   CanvasLayerKey &ioKey)
+{
+  auto key = computeCanvasLayerKey(iCtx, iRenderTexture, iBackgroundColor, iLayer);
+  if(key == ioKey)
+    return;
+
+  auto &canvas = iCtx.getPanelCanvas();
+  auto &uiContext = UIContext::GetCurrent();
+  auto &drawList = iCtx.getPanelCanvasDrawList();
+
+  BeginTextureMode(iRenderTexture.asRLRenderTexture()); // all raylib calls will render into iRenderTexture
+  canvas.clear(iBackgroundColor);
+
+  // the textures are recorded then submitted in as few batches as possible
+  uiContext.setRLDrawList(&drawList);
+  fPanel.draw(iCtx, canvas, iLayer);
+  uiContext.setRLDrawList(nullptr);
+  drawList.flush(uiContext);
+
+  EndTextureMode(); // finished rendering into iRenderTexture
+
+  key.fContentVersion = iRenderTexture.markContentChanged();
+  ioKey = key;
+}
+
 //------------------------------------------------------------------------
 // PanelState::renderPanelWidgets
 //------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include "Panel.h"
 #include "lua/HDGui2D.h"
 #include "lua/Device2D.h"
+#include <tuple>
 
 namespace re::edit {
 
@@ -54,9 +55,59 @@ protected:
 public:
   Panel fPanel;
 
+private:
+  /**
+   * Everything which affects what gets rendered (with raylib) into a layer of the panel canvas: as long as it does
+   * not change, the layer is not rendered again (only composited). Note that the shapes (borders, selection...) are
+   * not part of it since they are drawn by ImGui every frame, on top of the layers. */
+  struct CanvasLayerKey
+  {
+    std::uint64_t fContentVersion{}; // render texture (changes if another panel renders into it)
+    Panel::DrawLayer fLayer{};
+    std::uint64_t fEditVersion{};
+    std::uint64_t fDrawVersion{};
+    std::uint64_t fPropertyValuesVersion{};
+    std::uint64_t fTexturesGPUVersion{};
+    ReGui::Canvas::Viewport fViewport{};
+    ImU32 fBackgroundColor{};
+    ImU32 fSelectedWidgetColor{};
+    ImU32 fWidgetBorderColor{};
+    AppContext::EPanelRendering fPanelRendering{};
+    AppContext::EWidgetRendering fWidgetRendering{};
+    AppContext::EBorderRendering fBorderRendering{};
+    AppContext::ECustomDisplayRendering fCustomDisplayRendering{};
+    AppContext::ESampleDropZoneRendering fSampleDropZoneRendering{};
+    bool fShowRackRails{};
+    bool fShowFoldButton{};
+    bool fHasFoldedPanels{};
+
+    inline auto tie() const
+    {
+      return std::tie(fContentVersion, fLayer, fEditVersion, fDrawVersion, fPropertyValuesVersion, fTexturesGPUVersion,
+                      fViewport, fBackgroundColor, fSelectedWidgetColor, fWidgetBorderColor, fPanelRendering,
+                      fWidgetRendering, fBorderRendering, fCustomDisplayRendering, fSampleDropZoneRendering,
+                      fShowRackRails, fShowFoldButton, fHasFoldedPanels);
+    }
+    inline bool operator==(CanvasLayerKey const &rhs) const { return tie() == rhs.tie(); }
+    inline bool operator!=(CanvasLayerKey const &rhs) const { return !(*this == rhs); }
+  };
+
+  CanvasLayerKey computeCanvasLayerKey(AppContext const &iCtx,
+                                       Texture::RenderTexture const &iRenderTexture,
+                                       ImVec4 const &iBackgroundColor,
+                                       Panel::DrawLayer iLayer) const;
+
+  void renderCanvasLayer(AppContext &iCtx,
+                         Texture::RenderTexture &iRenderTexture,
+                         ImVec4 const &iBackgroundColor,
+                         Panel::DrawLayer iLayer,
+                         CanvasLayerKey &ioKey);
+
 private:
   std::vector<WidgetDef> fWidgetDefs{};
   WidgetTypeArray<bool> fAllowedWidgetTypes{};
+  CanvasLayerKey fCanvasLayerKey{};
+  CanvasLayerKey fCanvasMovingLayerKey{};
 };
 
 }
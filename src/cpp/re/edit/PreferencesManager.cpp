@@ -64,6 +64,10 @@ std::string PreferencesManager::getAsLua(config::Global const &iConfig)
   s << fmt::printf("global_config[\"target_frame_rate\"] = %d\n", iConfig.fTargetFrameRate);
   s << fmt::printf("global_config[\"vsync_enabled\"] = %s\n", fmt::Bool::to_chars(iConfig.fVSyncEnabled));
   s << fmt::printf("global_config[\"show_performance\"] = %s\n", fmt::Bool::to_chars(iConfig.fShowPerformance));
+  s << fmt::printf("global_config[\"texture_memory_budget\"] = %d\n", iConfig.fTextureMemoryBudget);
+  s << fmt::printf("global_config[\"gpu_upload_budget\"] = %d\n", iConfig.fGPUUploadBudget);
+  s << fmt::printf("global_config[\"undo_history_max_count\"] = %d\n", iConfig.fUndoHistoryMaxCount);
+  s << fmt::printf("global_config[\"undo_history_memory_budget\"] = %d\n", iConfig.fUndoHistoryMemoryBudget);
 
   auto const &history = iConfig.fDeviceHistory;
   if(!history.empty())
@@ -16,10 +16,12 @@
  * @author Yan Pujante
  */
 
+#include <atomic>
 #include <optional>
 #include <set>
 #include <string>
 #include <functional>
+#include <cstdint>
 #include <re/mock/Motherboard.h>
 #include <JukeboxTypes.h>
 #include <bitmask_operators.hpp>
@@ -53,6 +55,16 @@ struct enable_bitmask_operators<re::mock::PropertyOwner>{
 
 namespace re::edit {
 
+/**
+ * Filters are long-lived (defined once per widget type) and copied in the attributes: each filter gets a unique key
+ * at creation which lets `PropertyManager` cache the outcome of a filter. */
+inline std::uint64_t nextFilterKey()
+{
+  // filters can be created from any thread (ex: the tasks initializing the project)
+  static std::atomic<std::uint64_t> kKey{0};
+  return ++kKey;
+}
+
 struct Object
 {
   using Type = re::mock::JboxObjectType;
@@ -62,11 +74,12 @@ struct Object
     using type = std::function<bool(Object const &iObject)>;
 
     Filter() = default;
-    Filter(type iAction, std::string iDescription) : fAction{std::move(iAction)}, fDescription{std::move(iDescription)} {}
+    Filter(type iAction, std::string iDescription) : fAction{std::move(iAction)}, fDescription{std::move(iDescription)}, fKey{nextFilterKey()} {}
     explicit operator bool() const { return fAction.operator bool(); }
     bool operator()(Object const &o) const { return fAction(o); }
     type fAction{};
     std::string fDescription{};
+    std::uint64_t fKey{}; // identifies the filter (shared by copies) so that results can be cached
   };
 
   constexpr Type type() const { return fInfo.fType; };
@@ -87,11 +100,12 @@ struct Property
     using type = std::function<bool(Property const &iProperty)>;
 
     Filter() = default;
-    Filter(type iAction, std::string iDescription) : fAction{std::move(iAction)}, fDescription{std::move(iDescription)} {}
+    Filter(type iAction, std::string iDescription) : fAction{std::move(iAction)}, fDescription{std::move(iDescription)}, fKey{nextFilterKey()} {}
     explicit operator bool() const { return fAction.operator bool(); }
     bool operator()(Property const &p) const { return fAction(p); }
     type fAction{};
     std::string fDescription{};
+    std::uint64_t fKey{}; // identifies the filter (shared by copies) so that results can be cached
   };
 
   constexpr TJBox_PropertyRef const &ref() const { return fInfo.fPropertyRef; };
@@ -111,6 +125,18 @@ struct Property
   Object fParent{};
 };
 
+/**
+ * Interned handle on a property, resolved once from its path (`PropertyManager::getPropertyHandle`): reading the
+ * value through the handle is an array access. A handle is only valid for the device it was resolved with (a
+ * reloaded device has a different generation). */
+struct PropertyHandle
+{
+  int fIndex{-1};
+  std::uint64_t fDeviceGeneration{};
+
+  constexpr bool exists() const { return fIndex >= 0; }
+};
+
 static constexpr auto kDocGuiOwnerFilter = [](const Property &p) {
   return isOneOf(p.owner(), Property::Owner::kDocOwner | Property::Owner::kGUIOwner);
 };
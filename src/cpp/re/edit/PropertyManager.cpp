@@ -21,6 +21,9 @@
 #include <imgui.h>
 #include <misc/cpp/imgui_stdlib.h>
 #include "Errors.h"
+#include <algorithm>
+#include <atomic>
+#include <iterator>
 
 using namespace re::mock;
 
@@ -55,10 +58,28 @@ typename T::result_t PropertyManager::executeAction(Args &&... args)
   return fUndoManager->execute<typename T::result_t, typename T::action_t>(std::move(action));
 }
 
+namespace impl {
+
+//------------------------------------------------------------------------
+// impl::nextVersion
+//------------------------------------------------------------------------
+std::uint64_t nextVersion()
+{
+  // shared by all instances so that a reloaded device never reuses a generation/version
+  // (a device may be loaded by a background task)
+  static std::atomic<std::uint64_t> kVersion{0};
+  return ++kVersion;
+}
+
+}
+
 //------------------------------------------------------------------------
 // PropertyManager::PropertyManager
 //------------------------------------------------------------------------
-PropertyManager::PropertyManager(std::shared_ptr<UndoManager> iUndoManager) : fUndoManager{std::move(iUndoManager) }
+PropertyManager::PropertyManager(std::shared_ptr<UndoManager> iUndoManager) :
+  fUndoManager{std::move(iUndoManager)},
+  fDeviceGeneration{impl::nextVersion()},
+  fValuesVersion{impl::nextVersion()}
 {
   // empty
 }
@@ -102,6 +123,7 @@ rt_input_setup = { notify = { } }
     config.mdef(Config::skeletonMotherboardDef());
 
   fDevice = std::make_shared<rack::Extension>(fRack.newExtension(config.getConfig()));
+  fDeviceGeneration = impl::nextVersion();
 
   auto objectInfos = fDevice->getObjectInfos();
 
@@ -130,6 +152,31 @@ rt_input_setup = { notify = { } }
   fDevice->disableRTCNotify();
   fDevice->disableRTCBindings();
 
+  fAllObjects.clear();
+  fAllObjects.reserve(fObjects.size());
+  for(auto const &[_, object]: fObjects)
+    fAllObjects.emplace_back(&object);
+
+  fAllProperties.clear();
+  fAllProperties.reserve(fProperties.size());
+  for(auto const &[_, property]: fProperties)
+    fAllProperties.emplace_back(&property);
+
+  fObjectsByFilter.clear();
+  fPropertiesByFilter.clear();
+
+  // interns all the properties and snapshots their values
+  fPropertyHandles.clear();
+  fValuesAsInt.clear();
+  fPropertyHandles.reserve(fProperties.size());
+  fValuesAsInt.reserve(fProperties.size());
+  for(auto const &[path, _]: fProperties)
+  {
+    fPropertyHandles[path] = static_cast<int>(fValuesAsInt.size());
+    fValuesAsInt.emplace_back(getValueAsInt(path));
+  }
+  fValuesVersion = impl::nextVersion();
+
   return fDevice->getDeviceInfo();
 }
 
@@ -144,33 +191,20 @@ re::mock::Info const &PropertyManager::getDeviceInfo() const
 //------------------------------------------------------------------------
 // PropertyManager::findObjects
 //------------------------------------------------------------------------
-std::vector<Object const *> PropertyManager::findObjects(Object::Filter const &iFilter) const
+std::vector<Object const *> const &PropertyManager::findObjects(Object::Filter const &iFilter) const
 {
-  std::vector<Object const *> res{};
-  if(iFilter)
-  {
-    for(auto const &[name, object]: fObjects)
-    {
-      if(iFilter(object))
-        res.emplace_back(&object);
-    }
-  }
-  return res;
-}
+  static const std::vector<Object const *> kNoObjects{};
 
+  if(!iFilter)
+    return kNoObjects;
+
+  auto iter = fObjectsByFilter.find(iFilter.fKey);
+  if(iter != fObjectsByFilter.end())
+    return iter->second;
 
-//------------------------------------------------------------------------
-// PropertyManager::findAllObjects
-//------------------------------------------------------------------------
-std::vector<Object const *> PropertyManager::findAllObjects() const
-{
   std::vector<Object const *> res{};
-  res.reserve(fObjects.size());
-  for(auto const &[name, object]: fObjects)
-  {
-    res.emplace_back(&object);
-  }
-  return res;
+  std::copy_if(fAllObjects.begin(), fAllObjects.end(), std::back_inserter(res), [&iFilter](auto o) { return iFilter(*o); });
+  return fObjectsByFilter[iFilter.fKey] = std::move(res);
 }
 
 //------------------------------------------------------------------------
@@ -188,33 +222,20 @@ Object const *PropertyManager::findObject(std::string const &iObjectPath) const
 //------------------------------------------------------------------------
 // PropertyManager::findProperties
 //------------------------------------------------------------------------
-std::vector<Property const *> PropertyManager::findProperties(Property::Filter const &iFilter) const
+std::vector<Property const *> const &PropertyManager::findProperties(Property::Filter const &iFilter) const
 {
-  std::vector<Property const *> res{};
-  if(iFilter)
-  {
-    for(auto const &[name, property]: fProperties)
-    {
-      if(iFilter(property))
-        res.emplace_back(&property);
-    }
-  }
-  return res;
-}
+  static const std::vector<Property const *> kNoProperties{};
 
+  if(!iFilter)
+    return kNoProperties;
+
+  auto iter = fPropertiesByFilter.find(iFilter.fKey);
+  if(iter != fPropertiesByFilter.end())
+    return iter->second;
 
-//------------------------------------------------------------------------
-// PropertyManager::findAllProperties
-//------------------------------------------------------------------------
-std::vector<Property const *> PropertyManager::findAllProperties() const
-{
   std::vector<Property const *> res{};
-  res.reserve(fProperties.size());
-  for(auto const &[name, property]: fProperties)
-  {
-    res.emplace_back(&property);
-  }
-  return res;
+  std::copy_if(fAllProperties.begin(), fAllProperties.end(), std::back_inserter(res), [&iFilter](auto p) { return iFilter(*p); });
+  return fPropertiesByFilter[iFilter.fKey] = std::move(res);
 }
 
 //------------------------------------------------------------------------
@@ -222,15 +243,11 @@ std::vector<Property const *> PropertyManager::findAllProperties() const
 //------------------------------------------------------------------------
 std::vector<std::string> PropertyManager::findPropertyNames(Property::Filter const &iFilter) const
 {
+  auto const &properties = findProperties(iFilter);
   std::vector<std::string> res{};
-  if(iFilter)
-  {
-    for(auto const &[name, property]: fProperties)
-    {
-      if(iFilter(property))
-        res.emplace_back(name);
-    }
-  }
+  res.reserve(properties.size());
+  for(auto p: properties)
+    res.emplace_back(p->path());
   return res;
 }
 
@@ -298,6 +315,26 @@ int PropertyManager::getValueAsInt(std::string const &iPropertyPath) const
     return 0;
 }
 
+//------------------------------------------------------------------------
+// PropertyManager::getPropertyHandle
+//------------------------------------------------------------------------
+PropertyHandle PropertyManager::getPropertyHandle(std::string const &iPropertyPath) const
+{
+  auto iter = fPropertyHandles.find(iPropertyPath);
+  return {iter == fPropertyHandles.end() ? -1 : iter->second, fDeviceGeneration};
+}
+
+//------------------------------------------------------------------------
+// PropertyManager::onValueChanged
+//------------------------------------------------------------------------
+void PropertyManager::onValueChanged(std::string const &iPropertyPath)
+{
+  auto iter = fPropertyHandles.find(iPropertyPath);
+  if(iter != fPropertyHandles.end())
+    fValuesAsInt[static_cast<std::size_t>(iter->second)] = getValueAsInt(iPropertyPath);
+  fValuesVersion = impl::nextVersion();
+}
+
 //------------------------------------------------------------------------
 // PropertyManager::setValueAsInt
 //------------------------------------------------------------------------
@@ -561,6 +598,7 @@ bool PropertyManager::setBoolValueAction(std::string const &iPropertyPath, bool
 {
   auto value = fDevice->getBool(iPropertyPath);
   fDevice->setBool(iPropertyPath, iValue);
+  onValueChanged(iPropertyPath);
   return value;
 }
 
@@ -592,6 +630,7 @@ std::string PropertyManager::setStringValueAction(std::string const &iPropertyPa
       res = fDevice->getRTString(iPropertyPath);
       fDevice->setRTString(iPropertyPath, iValue);
     }
+    onValueChanged(iPropertyPath);
   }
   return res;
 }
@@ -604,6 +643,7 @@ Num PropertyManager::setNumValueAction(std::string const &iPropertyPath, Num iVa
 {
   auto value = fDevice->getNum<Num>(iPropertyPath);
   fDevice->setNum<Num>(iPropertyPath, iValue);
+  onValueChanged(iPropertyPath);
   return value;
 }
 
@@ -24,6 +24,8 @@
 #include <vector>
 #include <optional>
 #include <set>
+#include <cstdint>
+#include <unordered_map>
 #include <re/mock/Rack.h>
 #include "fs.h"
 #include "UndoManager.h"
@@ -60,12 +62,12 @@ public:
   mock::Info init(fs::path const &iDirectory);
   re::mock::Info const &getDeviceInfo() const;
 
-  std::vector<Object const *> findObjects(Object::Filter const &iFilter) const;
-  std::vector<Object const *> findAllObjects() const;
+  std::vector<Object const *> const &findObjects(Object::Filter const &iFilter) const;
+  inline std::vector<Object const *> const &findAllObjects() const { return fAllObjects; }
   Object const *findObject(std::string const &iObjectPath) const;
 
-  std::vector<Property const *> findProperties(Property::Filter const &iFilter) const;
-  std::vector<Property const *> findAllProperties() const;
+  std::vector<Property const *> const &findProperties(Property::Filter const &iFilter) const;
+  inline std::vector<Property const *> const &findAllProperties() const { return fAllProperties; }
   std::vector<std::string> findPropertyNames(Property::Filter const &iFilter) const;
   void sortProperties(std::vector<std::string> &ioProperties, Property::Comparator const &iComparator) const;
   Property const *findProperty(std::string const &iPropertyPath) const;
@@ -75,8 +77,18 @@ public:
   int getValueAsInt(std::string const &iPropertyPath) const;
   void setValueAsInt(std::string const &iPropertyPath, int iValue);
 
+  PropertyHandle getPropertyHandle(std::string const &iPropertyPath) const;
+  constexpr bool isCurrent(PropertyHandle const &iHandle) const { return iHandle.fDeviceGeneration == fDeviceGeneration; }
+  inline int getValueAsInt(PropertyHandle const &iHandle) const
+  {
+    return iHandle.exists() && isCurrent(iHandle) ? fValuesAsInt[static_cast<std::size_t>(iHandle.fIndex)] : 0;
+  }
+
   constexpr int getUserSamplesCount() const { return fUserSamplesCount; }
 
+  //! Incremented every time a property value changes (including undo/redo)
+  constexpr std::uint64_t getValuesVersion() const { return fValuesVersion; }
+
   void editView(Property const *iProperty);
   inline void editView(std::string const &iPropertyPath) { editView(findProperty(iPropertyPath)); }
   void editViewAsInt(Property const *iProperty, std::function<void(int)> const &iOnChange) const;
@@ -95,6 +107,8 @@ protected:
 
   std::string setStringValueAction(std::string const &iPropertyPath, std::string const &iValue);
 
+  void onValueChanged(std::string const &iPropertyPath);
+
   template<typename T, typename F>
   void updateProperty(F &&f, std::string const &iPropertyPath, T iValue);
 
@@ -112,6 +126,18 @@ private:
   std::map<std::string, Property> fProperties{};
   std::map<std::string, Object> fObjects{};
   int fUserSamplesCount{};
+  std::uint64_t fDeviceGeneration;
+  std::uint64_t fValuesVersion;
+  std::unordered_map<std::string, int> fPropertyHandles{}; // path -> index in fValuesAsInt
+  std::vector<int> fValuesAsInt{};
+
+  // sorted by path (computed at init)
+  std::vector<Object const *> fAllObjects{};
+  std::vector<Property const *> fAllProperties{};
+
+  // outcome of each filter (Filter::fKey), computed on first use (a reloaded device is a new instance)
+  mutable std::unordered_map<std::uint64_t, std::vector<Object const *>> fObjectsByFilter{};
+  mutable std::unordered_map<std::uint64_t, std::vector<Property const *>> fPropertiesByFilter{};
 };
 
 }
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+
+#include "RLDrawList.h"
+#include "Errors.h"
+#include "UIContext.h"
+#include <algorithm>
+
+namespace re::edit {
+
+namespace impl {
+
+//------------------------------------------------------------------------
+// impl::overlaps (edges included)
+//------------------------------------------------------------------------
+constexpr bool overlaps(ReGui::Rect const &r1, ReGui::Rect const &r2)
+{
+  return r1.Min.x <= r2.Max.x && r2.Min.x <= r1.Max.x && r1.Min.y <= r2.Max.y && r2.Min.y <= r1.Max.y;
+}
+
+//------------------------------------------------------------------------
+// impl::merge
+//------------------------------------------------------------------------
+constexpr ReGui::Rect merge(ReGui::Rect const &r1, ReGui::Rect const &r2)
+{
+  return {std::min(r1.Min.x, r2.Min.x), std::min(r1.Min.y, r2.Min.y), std::max(r1.Max.x, r2.Max.x), std::max(r1.Max.y, r2.Max.y)};
+}
+
+//------------------------------------------------------------------------
+// impl::toBounds
+// Filtering may blend a pixel beyond the destination => 1 pixel margin
+//------------------------------------------------------------------------
+constexpr ReGui::Rect toBounds(Rectangle const &iRectangle)
+{
+  return {iRectangle.x - 1.0f, iRectangle.y - 1.0f, iRectangle.x + iRectangle.width + 1.0f, iRectangle.y + iRectangle.height + 1.0f};
+}
+
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::addTexture
+//------------------------------------------------------------------------
+void RLDrawList::addTexture(::Texture const &iTexture,
+                            Rectangle const &iSource,
+                            Rectangle const &iDestination,
+                            Color iColor,
+                            std::optional<ShaderFX> const &iShaderFX)
+{
+  auto &command = fCommands.emplace_back(Command{Type::kTexture, iTexture, iSource, iDestination, iColor, iShaderFX});
+  fBounds.emplace_back(impl::toBounds(iDestination));
+  fCommandStates.emplace_back(findOrAddState(command));
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::addRectangle
+//------------------------------------------------------------------------
+void RLDrawList::addRectangle(Rectangle const &iRectangle, Color iColor)
+{
+  auto &command = fCommands.emplace_back(Command{Type::kRectangle, {}, {}, iRectangle, iColor, std::nullopt});
+  fBounds.emplace_back(impl::toBounds(iRectangle));
+  fCommandStates.emplace_back(findOrAddState(command));
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::addRectangleLines
+//------------------------------------------------------------------------
+void RLDrawList::addRectangleLines(Rectangle const &iRectangle, Color iColor)
+{
+  auto &command = fCommands.emplace_back(Command{Type::kRectangleLines, {}, {}, iRectangle, iColor, std::nullopt});
+  fBounds.emplace_back(impl::toBounds(iRectangle));
+  fCommandStates.emplace_back(findOrAddState(command));
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::findOrAddState
+//------------------------------------------------------------------------
+int RLDrawList::findOrAddState(Command const &iCommand)
+{
+  State state{iCommand.fType, iCommand.fType == Type::kTexture ? iCommand.fTexture.id : 0, iCommand.fShaderFX};
+
+  // there are only a handful of distinct states (textures used by the visible widgets)
+  auto iter = std::find(fStates.begin(), fStates.end(), state);
+  if(iter != fStates.end())
+    return static_cast<int>(iter - fStates.begin());
+
+  fStates.emplace_back(state);
+  return static_cast<int>(fStates.size() - 1);
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::ComputeBatches
+//------------------------------------------------------------------------
+std::vector<RLDrawList::Batch> RLDrawList::ComputeBatches(std::vector<ReGui::Rect> const &iBounds,
+                                                          std::vector<int> const &iStates)
+{
+  RE_EDIT_INTERNAL_ASSERT(iBounds.size() == iStates.size());
+
+  std::vector<Batch> batches{};
+
+  for(std::size_t i = 0; i < iBounds.size(); i++)
+  {
+    auto const &bounds = iBounds[i];
+
+    // the command cannot be drawn before the last batch containing a command it overlaps
+    std::size_t first = 0;
+    for(auto b = batches.size(); b > 0; b--)
+    {
+      auto const &batch = batches[b - 1];
+      if(!impl::overlaps(batch.fBounds, bounds))
+        continue;
+      if(std::any_of(batch.fCommands.begin(), batch.fCommands.end(),
+                     [&iBounds, &bounds](auto c) { return impl::overlaps(iBounds[c], bounds); }))
+      {
+        first = b - 1;
+        break;
+      }
+    }
+
+    auto iter = std::find_if(batches.begin() + static_cast<std::ptrdiff_t>(first), batches.end(),
+                             [state = iStates[i]](auto const &batch) { return batch.fState == state; });
+
+    if(iter == batches.end())
+      batches.emplace_back(Batch{iStates[i], {i}, bounds});
+    else
+    {
+      iter->fCommands.emplace_back(i);
+      iter->fBounds = impl::merge(iter->fBounds, bounds);
+    }
+  }
+
+  return batches;
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::flush
+//------------------------------------------------------------------------
+void RLDrawList::flush(UIContext &iUIContext)
+{
+  fStats = {};
+  fStats.fCommandCount = static_cast<int>(fCommands.size());
+
+  auto const batches = ComputeBatches(fBounds, fCommandStates);
+  fStats.fBatchCount = static_cast<int>(batches.size());
+
+  // Implementation note: the FX parameters are uniforms which are set right away (not part of the raylib batch)
+  // => the shader must be ended (which flushes the batch) before it can be started again with different parameters
+  std::optional<ShaderFX> currentShaderFX{};
+
+  for(auto const &batch: batches)
+  {
+    auto const &shaderFX = fStates[batch.fState].fShaderFX;
+    if(shaderFX != currentShaderFX)
+    {
+      if(currentShaderFX)
+        iUIContext.endFXShader();
+      if(shaderFX)
+      {
+        iUIContext.beginFXShader(shaderFX->fTint, shaderFX->fBrightness, shaderFX->fContrast);
+        fStats.fShaderSwitchCount++;
+      }
+      currentShaderFX = shaderFX;
+    }
+
+    for(auto c: batch.fCommands)
+      submit(fCommands[c]);
+  }
+
+  if(currentShaderFX)
+    iUIContext.endFXShader();
+
+  fCommands.clear();
+  fStates.clear();
+  fBounds.clear();
+  fCommandStates.clear();
+}
+
+//------------------------------------------------------------------------
+// RLDrawList::submit
+//------------------------------------------------------------------------
+void RLDrawList::submit(Command const &iCommand)
+{
+  auto const &dest = iCommand.fDestination;
+  switch(iCommand.fType)
+  {
+    case Type::kTexture:
+      DrawTexturePro(iCommand.fTexture, iCommand.fSource, dest, {}, 0, iCommand.fColor);
+      break;
+
+    case Type::kRectangle:
+      DrawRectangle(static_cast<int>(dest.x), static_cast<int>(dest.y),
+                    static_cast<int>(dest.width), static_cast<int>(dest.height),
+                    iCommand.fColor);
+      break;
+
+    case Type::kRectangleLines:
+      DrawRectangleLines(static_cast<int>(dest.x), static_cast<int>(dest.y),
+                         static_cast<int>(dest.width), static_cast<int>(dest.height),
+                         iCommand.fColor);
+      break;
+  }
+}
+
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_RL_DRAW_LIST_H
+#define RE_EDIT_RL_DRAW_LIST_H
+
+#include "ReGui.h"
+#include <raylib.h>
+#include <optional>
+#include <vector>
+
+namespace re::edit {
+
+class UIContext;
+
+/**
+ * Records raylib draws (textures, rectangles) instead of submitting them right away so that, when flushed, they can
+ * be grouped by state (primitive, texture, FX shader parameters): every change of state breaks the raylib batch
+ * (and a change of FX shader parameters requires a flush), so grouping minimizes the number of draw calls.
+ *
+ * Draws are only reordered when it cannot be seen: a draw is never moved before a draw it overlaps which was
+ * recorded before it (z-order). */
+class RLDrawList
+{
+public:
+  //! Parameters of the FX shader (see `UIContext::beginFXShader`)
+  struct ShaderFX
+  {
+    ImVec4 fTint{1.0f, 1.0f, 1.0f, 1.0f};
+    float fBrightness{};
+    float fContrast{1.0f};
+
+    constexpr bool operator==(ShaderFX const &rhs) const
+    {
+      return fTint.x == rhs.fTint.x && fTint.y == rhs.fTint.y && fTint.z == rhs.fTint.z && fTint.w == rhs.fTint.w &&
+             fBrightness == rhs.fBrightness && fContrast == rhs.fContrast;
+    }
+    constexpr bool operator!=(ShaderFX const &rhs) const { return !(*this == rhs); }
+  };
+
+  struct Stats
+  {
+    int fCommandCount{};
+    int fBatchCount{};
+    int fShaderSwitchCount{};
+  };
+
+  //! A group of commands sharing the same state (indices in recording order)
+  struct Batch
+  {
+    int fState{};
+    std::vector<std::size_t> fCommands{};
+    ReGui::Rect fBounds{};
+  };
+
+public:
+  void addTexture(::Texture const &iTexture,
+                  Rectangle const &iSource,
+                  Rectangle const &iDestination,
+                  Color iColor,
+                  std::optional<ShaderFX> const &iShaderFX = std::nullopt);
+  void addRectangle(Rectangle const &iRectangle, Color iColor);
+  void addRectangleLines(Rectangle const &iRectangle, Color iColor);
+
+  inline bool empty() const { return fCommands.empty(); }
+
+  /**
+   * Submits (to raylib) all the commands recorded so far and clears them */
+  void flush(UIContext &iUIContext);
+
+  //! Stats of the last flush
+  constexpr Stats const &getStats() const { return fStats; }
+
+  /**
+   * Groups the commands (described by their bounds and state) into batches which, submitted in order, render the
+   * same result as submitting the commands in order. A command goes into the first batch with the same state
+   * located after every batch containing a command it overlaps. */
+  static std::vector<Batch> ComputeBatches(std::vector<ReGui::Rect> const &iBounds, std::vector<int> const &iStates);
+
+private:
+  enum class Type
+  {
+    kTexture,
+    kRectangle,
+    kRectangleLines
+  };
+
+  struct Command
+  {
+    Type fType{};
+    ::Texture fTexture{};
+    Rectangle fSource{};
+    Rectangle fDestination{};
+    Color fColor{};
+    std::optional<ShaderFX> fShaderFX{};
+  };
+
+  //! What breaks the raylib batch when it changes
+  struct State
+  {
+    Type fType{};
+    unsigned int fTextureId{};
+    std::optional<ShaderFX> fShaderFX{};
+
+    inline bool operator==(State const &rhs) const { return fType == rhs.fType && fTextureId == rhs.fTextureId && fShaderFX == rhs.fShaderFX; }
+  };
+
+  int findOrAddState(Command const &iCommand);
+  static void submit(Command const &iCommand);
+
+private:
+  std::vector<Command> fCommands{};
+  std::vector<State> fStates{};
+  std::vector<ReGui::Rect> fBounds{};
+  std::vector<int> fCommandStates{};
+  Stats fStats{};
+};
+
+}
+
+#endif //RE_EDIT_RL_DRAW_LIST_H
@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace re::edit {
+
+namespace impl {
+
+constexpr bool isContained(ImVec2 const &iPosition, ReGui::Rect const &iRect)
+{
+  return iPosition.x >= iRect.Min.x
+         && iPosition.y >= iRect.Min.y
+         && iPosition.x <= iRect.Max.x
+         && iPosition.y <= iRect.Max.y;
+}
+
+constexpr bool overlaps(ReGui::Rect const &iRect1, ReGui::Rect const &iRect2)
+{
+  return iRect1.Min.x <= iRect2.Max.x
+         && iRect1.Max.x >= iRect2.Min.x
+         && iRect1.Min.y <= iRect2.Max.y
+         && iRect1.Max.y >= iRect2.Min.y;
+}
+
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::toCell
+//------------------------------------------------------------------------
+int SpatialIndex::toCell(float iValue) const
+{
+  // clamped so that absurd coordinates do not overflow (they simply end up in the border cells)
+  constexpr float kMaxCell = 1 << 20;
+  return static_cast<int>(std::clamp(std::floor(iValue / fCellSize), -kMaxCell, kMaxCell));
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::computeCells
+//------------------------------------------------------------------------
+SpatialIndex::CellRange SpatialIndex::computeCells(ReGui::Rect const &iRect) const
+{
+  return {
+    toCell(std::min(iRect.Min.x, iRect.Max.x)),
+    toCell(std::min(iRect.Min.y, iRect.Max.y)),
+    toCell(std::max(iRect.Min.x, iRect.Max.x)),
+    toCell(std::max(iRect.Min.y, iRect.Max.y))
+  };
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::addToCells
+//------------------------------------------------------------------------
+void SpatialIndex::addToCells(id_t iId, CellRange const &iCells)
+{
+  if(iCells.isOversized())
+  {
+    fOversized.emplace_back(iId);
+    return;
+  }
+
+  for(auto y = iCells.fMinY; y <= iCells.fMaxY; y++)
+  {
+    for(auto x = iCells.fMinX; x <= iCells.fMaxX; x++)
+      fCells[cellKey(x, y)].emplace_back(iId);
+  }
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::removeFromCells
+//------------------------------------------------------------------------
+void SpatialIndex::removeFromCells(id_t iId, CellRange const &iCells)
+{
+  auto removeFrom = [iId](std::vector<id_t> &v) {
+    auto iter = std::find(v.begin(), v.end(), iId);
+    if(iter != v.end())
+    {
+      // order does not matter => swap with last
+      *iter = v.back();
+      v.pop_back();
+    }
+  };
+
+  if(iCells.isOversized())
+  {
+    removeFrom(fOversized);
+    return;
+  }
+
+  for(auto y = iCells.fMinY; y <= iCells.fMaxY; y++)
+  {
+    for(auto x = iCells.fMinX; x <= iCells.fMaxX; x++)
+    {
+      auto iter = fCells.find(cellKey(x, y));
+      if(iter != fCells.end())
+      {
+        removeFrom(iter->second);
+        if(iter->second.empty())
+          fCells.erase(iter);
+      }
+    }
+  }
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::update
+//------------------------------------------------------------------------
+void SpatialIndex::update(id_t iId, ReGui::Rect const &iRect)
+{
+  auto cells = computeCells(iRect);
+
+  auto iter = fEntries.find(iId);
+  if(iter == fEntries.end())
+  {
+    fEntries[iId] = Entry{iRect, cells};
+    addToCells(iId, cells);
+    return;
+  }
+
+  auto &entry = iter->second;
+  if(entry.fCells != cells)
+  {
+    removeFromCells(iId, entry.fCells);
+    addToCells(iId, cells);
+    entry.fCells = cells;
+  }
+  entry.fRect = iRect;
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::remove
+//------------------------------------------------------------------------
+void SpatialIndex::remove(id_t iId)
+{
+  auto iter = fEntries.find(iId);
+  if(iter != fEntries.end())
+  {
+    removeFromCells(iId, iter->second.fCells);
+    fEntries.erase(iter);
+  }
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::clear
+//------------------------------------------------------------------------
+void SpatialIndex::clear()
+{
+  fEntries.clear();
+  fCells.clear();
+  fOversized.clear();
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::findAt
+//------------------------------------------------------------------------
+void SpatialIndex::findAt(ImVec2 const &iPosition, std::vector<id_t> &oIds) const
+{
+  auto matches = [this, &iPosition](id_t iId) { return impl::isContained(iPosition, fEntries.at(iId).fRect); };
+
+  // a point is always in exactly 1 cell => no duplicates
+  auto iter = fCells.find(cellKey(toCell(iPosition.x), toCell(iPosition.y)));
+  if(iter != fCells.end())
+    std::copy_if(iter->second.begin(), iter->second.end(), std::back_inserter(oIds), matches);
+
+  std::copy_if(fOversized.begin(), fOversized.end(), std::back_inserter(oIds), matches);
+}
+
+//------------------------------------------------------------------------
+// SpatialIndex::findOverlapping
+//------------------------------------------------------------------------
+void SpatialIndex::findOverlapping(ReGui::Rect const &iRect, std::vector<id_t> &oIds) const
+{
+  auto matches = [this, &iRect](id_t iId) { return impl::overlaps(iRect, fEntries.at(iId).fRect); };
+
+  auto start = oIds.size();
+  auto cells = computeCells(iRect);
+
+  if(static_cast<std::size_t>(cells.fMaxX - cells.fMinX + 1) * static_cast<std::size_t>(cells.fMaxY - cells.fMinY + 1) > fCells.size())
+  {
+    // the query covers more cells than there are non-empty ones => iterate over the non-empty ones instead
+    for(auto const &[_, ids]: fCells)
+      std::copy_if(ids.begin(), ids.end(), std::back_inserter(oIds), matches);
+  }
+  else
+  {
+    for(auto y = cells.fMinY; y <= cells.fMaxY; y++)
+    {
+      for(auto x = cells.fMinX; x <= cells.fMaxX; x++)
+      {
+        auto iter = fCells.find(cellKey(x, y));
+        if(iter != fCells.end())
+          std::copy_if(iter->second.begin(), iter->second.end(), std::back_inserter(oIds), matches);
+      }
+    }
+  }
+
+  std::copy_if(fOversized.begin(), fOversized.end(), std::back_inserter(oIds), matches);
+
+  // an entry spanning several cells is found several times
+  std::sort(oIds.begin() + static_cast<std::ptrdiff_t>(start), oIds.end());
+  oIds.erase(std::unique(oIds.begin() + static_cast<std::ptrdiff_t>(start), oIds.end()), oIds.end());
+}
+
+}
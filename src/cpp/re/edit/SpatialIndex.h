@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_SPATIAL_INDEX_H
+#define RE_EDIT_SPATIAL_INDEX_H
+
+#include "ReGui.h"
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace re::edit {
+
+/**
+ * Uniform grid over (widget) bounding boxes: each id is registered in every cell its rectangle touches so that
+ * point and rectangle queries only look at the ids living in the cells covered by the query. Rectangles
+ * spanning too many cells are kept aside and always returned as candidates.
+ *
+ * Queries return *candidates* based on the indexed rectangles (edges included, like `Graphics::contains` and
+ * `Graphics::overlaps`): the caller is expected to confirm with the actual object. */
+class SpatialIndex
+{
+public:
+  using id_t = int;
+
+  static constexpr float kDefaultCellSize = 256.0f;
+  static constexpr int kMaxCellsPerEntry = 64;
+
+public:
+  explicit SpatialIndex(float iCellSize = kDefaultCellSize) : fCellSize{iCellSize} {}
+
+  void update(id_t iId, ReGui::Rect const &iRect);
+  void remove(id_t iId);
+  void clear();
+
+  inline bool contains(id_t iId) const { return fEntries.find(iId) != fEntries.end(); }
+  inline std::size_t size() const { return fEntries.size(); }
+
+  void findAt(ImVec2 const &iPosition, std::vector<id_t> &oIds) const;
+  void findOverlapping(ReGui::Rect const &iRect, std::vector<id_t> &oIds) const;
+
+private:
+  struct CellRange
+  {
+    int fMinX{};
+    int fMinY{};
+    int fMaxX{-1};
+    int fMaxY{-1};
+
+    constexpr bool isOversized() const { return static_cast<std::int64_t>(fMaxX - fMinX + 1) * (fMaxY - fMinY + 1) > kMaxCellsPerEntry; }
+    constexpr bool operator==(CellRange const &rhs) const { return fMinX == rhs.fMinX && fMinY == rhs.fMinY && fMaxX == rhs.fMaxX && fMaxY == rhs.fMaxY; }
+    constexpr bool operator!=(CellRange const &rhs) const { return !(*this == rhs); }
+  };
+
+  struct Entry
+  {
+    ReGui::Rect fRect{};
+    CellRange fCells{};
+  };
+
+  int toCell(float iValue) const;
+  CellRange computeCells(ReGui::Rect const &iRect) const;
+  void addToCells(id_t iId, CellRange const &iCells);
+  void removeFromCells(id_t iId, CellRange const &iCells);
+  static constexpr std::uint64_t cellKey(int x, int y) { return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) | static_cast<std::uint32_t>(y); }
+
+private:
+  float fCellSize;
+  std::unordered_map<id_t, Entry> fEntries{};
+  std::unordered_map<std::uint64_t, std::vector<id_t>> fCells{};
+  std::vector<id_t> fOversized{};
+};
+
+}
+
+#endif //RE_EDIT_SPATIAL_INDEX_H
@@ -17,29 +17,112 @@
  */
 
 #include "String.h"
-#include "imgui.h"
-
-extern IMGUI_API ImGuiID ImHashStr(const char* data, size_t data_size = 0, ImU32 seed = 0);
+#include "Errors.h"
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 namespace re::edit {
 
 //------------------------------------------------------------------------
-// StringWithHash::StringWithHash
+// SymbolTable
+//------------------------------------------------------------------------
+class SymbolTable
+{
+public:
+  static SymbolTable &GetDefault()
+  {
+    static SymbolTable kDefault{};
+    return kDefault;
+  }
+
+  SymbolTable()
+  {
+    fEmpty = &fStrings.emplace_back();
+    fIds[*fEmpty] = 0;
+  }
+
+  Symbol empty() const
+  {
+    // set once in the constructor (the deque itself is not accessed) => no lock required
+    return {0, fEmpty};
+  }
+
+  std::optional<Symbol> find(std::string_view s) const
+  {
+    std::shared_lock<std::shared_mutex> lock(fMutex);
+    auto iter = fIds.find(s);
+    if(iter != fIds.end())
+      return Symbol{iter->second, &fStrings[iter->second]};
+    else
+      return std::nullopt;
+  }
+
+  Symbol intern(std::string_view s)
+  {
+    if(auto symbol = find(s))
+      return *symbol;
+
+    std::unique_lock<std::shared_mutex> lock(fMutex);
+
+    // another thread may have added it in between
+    auto iter = fIds.find(s);
+    if(iter != fIds.end())
+      return Symbol{iter->second, &fStrings[iter->second]};
+
+    RE_EDIT_INTERNAL_ASSERT(fStrings.size() < std::numeric_limits<Symbol::id_t>::max());
+    auto id = static_cast<Symbol::id_t>(fStrings.size());
+    // deque: adding an element does not move the other ones => the views (keys) and cached pointers remain valid
+    auto const &str = fStrings.emplace_back(s);
+    fIds[str] = id;
+    return Symbol{id, &str};
+  }
+
+  std::size_t count() const
+  {
+    std::shared_lock<std::shared_mutex> lock(fMutex);
+    return fStrings.size();
+  }
+
+private:
+  mutable std::shared_mutex fMutex{};
+  std::deque<std::string> fStrings{};
+  std::unordered_map<std::string_view, Symbol::id_t> fIds{};
+  std::string const *fEmpty{};
+};
+
+//------------------------------------------------------------------------
+// Symbol::Symbol
 //------------------------------------------------------------------------
-StringWithHash::StringWithHash(std::string s) :
-  fValue{std::move(s)},
-  fHash{ImHashStr(fValue.c_str())}
+Symbol::Symbol() : Symbol{SymbolTable::GetDefault().empty()}
 {
   // empty
 }
 
 //------------------------------------------------------------------------
-// StringWithHash::StringWithHash
+// Symbol::Symbol
 //------------------------------------------------------------------------
-StringWithHash::StringWithHash(char const *s) :
-  fValue(s),
-  fHash{ImHashStr(fValue.c_str())}
+Symbol::Symbol(std::string_view s) : Symbol{SymbolTable::GetDefault().intern(s)}
 {
   // empty
 }
-}
\ No newline at end of file
+
+//------------------------------------------------------------------------
+// Symbol::find
+//------------------------------------------------------------------------
+std::optional<Symbol> Symbol::find(std::string_view s)
+{
+  return SymbolTable::GetDefault().find(s);
+}
+
+//------------------------------------------------------------------------
+// Symbol::count
+//------------------------------------------------------------------------
+std::size_t Symbol::count()
+{
+  return SymbolTable::GetDefault().count();
+}
+
+}
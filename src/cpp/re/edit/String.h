@@ -19,33 +19,68 @@
 #ifndef RE_EDIT_STRING_H
 #define RE_EDIT_STRING_H
 
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace re::edit {
 
-class StringWithHash
+/**
+ * Interned string: a process wide (thread safe) table stores each distinct string once and identifies it with a
+ * stable 32-bit id, so that symbols are compared and hashed as integers (exactly: 2 symbols are equal if and only
+ * if their strings are equal).
+ *
+ * Strings are never removed from the table: the string returned by `str()` is valid for the life of the process. */
+class Symbol
 {
 public:
-  using string_t = std::string;
-  using hash_t = unsigned int;
+  using id_t = std::uint32_t;
 
 public:
-  StringWithHash() = default;
-  explicit StringWithHash(char const *s);
-  explicit StringWithHash(std::string s);
+  //! The empty string (id 0)
+  Symbol();
+  explicit Symbol(std::string_view s);
+  explicit Symbol(char const *s) : Symbol{std::string_view{s}} {}
+  explicit Symbol(std::string const &s) : Symbol{std::string_view{s}} {}
+
+  //! @return the symbol for `s` if it has already been interned (does not add `s` to the table)
+  static std::optional<Symbol> find(std::string_view s);
+
+  //! @return the number of strings in the table
+  static std::size_t count();
 
-  inline string_t const &value() const { return fValue; }
-  inline char const *c_str() const { return fValue.c_str(); }
-  inline hash_t hash() const { return fHash; }
+  inline id_t id() const { return fId; }
+  inline bool empty() const { return fId == 0; }
+  inline std::string const &str() const { return *fString; }
+  inline char const *c_str() const { return fString->c_str(); }
+
+  friend bool operator==(Symbol const &l, Symbol const &r) { return l.fId == r.fId; }
+  friend bool operator!=(Symbol const &l, Symbol const &r) { return l.fId != r.fId; }
+  //! Order of creation (not alphabetical)
+  friend bool operator<(Symbol const &l, Symbol const &r) { return l.fId < r.fId; }
 
 private:
-  string_t fValue{};
-  hash_t fHash{};
-};
+  Symbol(id_t iId, std::string const *iString) : fId{iId}, fString{iString} {}
+
+  friend class SymbolTable;
 
+private:
+  id_t fId;
+  std::string const *fString; // owned by the table (cached to access the string without locking)
+};
 
 }
 
+namespace std {
+
+template<>
+struct hash<re::edit::Symbol>
+{
+  std::size_t operator()(re::edit::Symbol const &s) const noexcept { return std::hash<re::edit::Symbol::id_t>{}(s.id()); }
+};
 
+}
 
-#endif //RE_EDIT_STRING_H
\ No newline at end of file
+#endif //RE_EDIT_STRING_H
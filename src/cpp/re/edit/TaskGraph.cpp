@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#include "TaskGraph.h"
+#include "Errors.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <future>
+
+namespace re::edit {
+
+//------------------------------------------------------------------------
+// TaskGraph::add
+//------------------------------------------------------------------------
+TaskGraph::task_id_t TaskGraph::add(std::string iDescription, task_t iTask, std::vector<task_id_t> iDependencies)
+{
+  auto id = fTasks.size();
+  // dependencies must be added first => the graph cannot have a cycle
+  for(auto dependency: iDependencies)
+    RE_EDIT_INTERNAL_ASSERT(dependency < id);
+  fTasks.emplace_back(Task{std::move(iDescription), std::move(iTask), std::move(iDependencies)});
+  return id;
+}
+
+//------------------------------------------------------------------------
+// TaskGraph::run
+//------------------------------------------------------------------------
+void TaskGraph::run(Utils::CancellableSPtr const &iCancellable)
+{
+  enum class State { kPending, kRunning, kCompleted };
+
+  auto const count = fTasks.size();
+  auto &pool = ThreadPool::GetDefault();
+
+  std::mutex mutex{};
+  std::condition_variable cv{};
+  std::vector<State> states(count, State::kPending);
+  std::vector<std::future<void>> futures(count);
+  std::size_t runningCount{};
+  std::size_t completedCount{};
+  std::exception_ptr error{};
+  bool cancelled{};
+  std::string lastProgress{};
+
+  auto isReady = [this, &states](task_id_t iId) {
+    auto const &dependencies = fTasks[iId].fDependencies;
+    return std::all_of(dependencies.begin(), dependencies.end(), [&states](auto d) { return states[d] == State::kCompleted; });
+  };
+
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while(completedCount < count)
+  {
+    if(!cancelled && iCancellable->cancelled())
+      cancelled = true;
+
+    if(!error && !cancelled)
+    {
+      for(task_id_t id = 0; id < count; id++)
+      {
+        if(states[id] == State::kPending && isReady(id))
+        {
+          states[id] = State::kRunning;
+          runningCount++;
+          futures[id] = pool.submit(ThreadPool::Priority::kLoad, [this, id, &mutex, &cv, &states, &runningCount, &completedCount, &error] {
+            std::exception_ptr taskError{};
+            try
+            {
+              fTasks[id].fTask();
+            }
+            catch(...)
+            {
+              taskError = std::current_exception();
+            }
+            std::lock_guard<std::mutex> taskLock(mutex);
+            if(taskError && !error)
+              error = taskError;
+            states[id] = State::kCompleted;
+            runningCount--;
+            completedCount++;
+            cv.notify_all();
+          });
+        }
+      }
+
+      // the progress reflects what is currently running (only reported when it changes)
+      std::string progress{};
+      for(task_id_t id = 0; id < count; id++)
+      {
+        if(states[id] == State::kRunning)
+        {
+          if(!progress.empty())
+            progress += " | ";
+          progress += fTasks[id].fDescription;
+        }
+      }
+
+      try
+      {
+        if(!progress.empty() && progress != lastProgress)
+          iCancellable->progress(progress + "...");
+        lastProgress = std::move(progress);
+      }
+      catch(Utils::Cancellable::cancelled_t const &)
+      {
+        cancelled = true;
+      }
+    }
+
+    if(runningCount == 0)
+      break;
+
+    // the tasks run in the (shared) pool: helping instead of simply blocking guarantees progress even when called
+    // from a worker
+    auto previousCompletedCount = completedCount;
+    lock.unlock();
+    auto helped = pool.runPendingTask(ThreadPool::Priority::kLoad);
+    lock.lock();
+    if(!helped)
+      cv.wait(lock, [&completedCount, previousCompletedCount] { return completedCount != previousCompletedCount; });
+  }
+
+  lock.unlock();
+
+  for(auto &future: futures)
+  {
+    if(future.valid())
+      future.get();
+  }
+
+  if(error)
+    std::rethrow_exception(error);
+
+  if(cancelled)
+    throw Utils::Cancellable::cancelled_t();
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_TASK_GRAPH_H
+#define RE_EDIT_TASK_GRAPH_H
+
+#include "Utils.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace re::edit {
+
+/**
+ * A small graph of tasks: a task is started (in the shared `ThreadPool`) as soon as all the tasks it depends on are
+ * completed, so independent tasks run concurrently. `run` blocks until the graph is complete and reports the
+ * tasks currently running through the cancellable.
+ *
+ * If a task fails (or the cancellable is cancelled), no new task is started, the running ones are waited on and the
+ * (first) exception is rethrown. */
+class TaskGraph
+{
+public:
+  using task_id_t = std::size_t;
+  using task_t = std::function<void()>;
+
+public:
+  task_id_t add(std::string iDescription, task_t iTask, std::vector<task_id_t> iDependencies = {});
+  void run(Utils::CancellableSPtr const &iCancellable);
+
+  inline std::size_t size() const { return fTasks.size(); }
+
+private:
+  struct Task
+  {
+    std::string fDescription;
+    task_t fTask;
+    std::vector<task_id_t> fDependencies;
+  };
+
+private:
+  std::vector<Task> fTasks{};
+};
+
+}
+
+#endif //RE_EDIT_TASK_GRAPH_H
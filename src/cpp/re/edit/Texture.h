@@ -24,6 +24,8 @@
 #include "ReGui.h"
 #include "Errors.h"
 #include "fx.h"
+#include <atomic>
+#include <cstdint>
 
 namespace re::edit {
 
@@ -41,6 +43,7 @@ public:
 
     inline ImTextureID asImTextureID() const { return static_cast<ImTextureID>(fTexture.get()); }
     inline ::Texture asRLTexture() const { return *fTexture; }
+    inline int width() const { return fTexture->width; }
     inline int height() const { return fTexture->height; }
 
     void draw(bool iUseRLDraw,
@@ -87,6 +90,12 @@ public:
 
     void resize(ImVec2 const &iSize, ImVec2 const &iScale);
 
+    /**
+     * Changes every time something is rendered into this texture (`markContentChanged`) or when the underlying
+     * texture is recreated (content lost), so that a renderer can tell whether what it rendered last is still there */
+    constexpr std::uint64_t contentVersion() const { return fContentVersion; }
+    inline std::uint64_t markContentChanged() { return ++fContentVersion; }
+
     inline ImTextureID asImTextureID() const { return fRLRenderTexture.asImTextureID(); }
     inline ::RenderTexture asRLRenderTexture() const { return fRLRenderTexture.asRLRenderTexture(); }
 
@@ -98,6 +107,7 @@ public:
     RLRenderTexture fRLRenderTexture;
     ImVec2 fSize;
     ImVec2 fScale;
+    std::uint64_t fContentVersion{};
   };
 
 public:
@@ -108,6 +118,13 @@ public:
   key_t computeKey(texture::FX const &iEffects) const { return fFilmStrip->computeKey(iEffects); }
 
   inline bool isValid() const { return fFilmStrip->isValid(); }
+  inline bool isPending() const { return fFilmStrip->isPending(); }
+  inline bool isLoadedOnGPU() const { return !fGPUTextures.empty() || isFrameTiled(); }
+
+  /**
+   * A large filmstrip (see `kGPUFrameResidencyThreshold`) is not uploaded in full: it is split in tiles of frames
+   * which are uploaded (from the pixels kept in memory) only when one of their frames is drawn */
+  inline bool isFrameTiled() const { return fGPUFramesPerTile > 0; }
 
   constexpr float width() const { return static_cast<float>(fFilmStrip->width()); }
   constexpr float height() const { return static_cast<float>(fFilmStrip->height()); }
@@ -144,9 +161,40 @@ public:
 
   void loadOnGPU(const std::shared_ptr<FilmStrip>& iFilmStrip);
 
+  /**
+   * Enqueues the upload of the pixels to the GPU (see `UIContext::processGPUUploads`): the textures currently loaded
+   * (if any) are drawn until the upload completes */
   void loadOnGPUFromUIThread(std::shared_ptr<FilmStrip> const &iFilmStrip);
 
-  void unloadFromGPU() { fGPUTextures.clear(); }
+  //! Also abandons any upload in progress
+  void unloadFromGPU()
+  {
+    fGPUTextures.clear();
+    fGPUMipLevels.clear();
+    resetFrameTiles(0);
+    fGPUUploadGeneration++;
+    fGPUUploadPending = false;
+    kGPUVersion++;
+  }
+
+  /**
+   * Frame-range residency only: enqueues the upload of the tiles drawn during `iCurrentFrame` which are not on the
+   * GPU yet and unloads the ones not drawn for `kTextureEvictionFrameCount` frames. Must be called from the UI thread
+   * (after rendering). */
+  void updateFrameTiles(int iCurrentFrame);
+
+  /**
+   * Same effect as drawing the frame `iFrameNumber` of the texture as far as memory management is concerned (the
+   * texture, and the tile holding the frame if resident, are in use) */
+  void markDrawn(int iFrameNumber) const;
+
+  /**
+   * Changes every time what is drawn for any texture changes (upload completed or started, unloaded...) so that
+   * something rendered from textures can be cached as long as this version stays the same */
+  static std::uint64_t GetGPUVersion() { return kGPUVersion; }
+
+  //! Memory used by the textures loaded on the GPU
+  std::size_t gpuMemorySize() const;
 
   friend class TextureManager;
 
@@ -161,9 +209,38 @@ protected:
 
 //  void reloadOnGPU() const { doLoadOnGPU(fFilmStrip); }
 
+  /**
+   * @return the (downscaled) mip level texture to use when drawing a frame at `iSize` or `nullptr` when the full
+   *         resolution textures should be used */
+  RLTexture const *findMipLevel(ImVec2 const &iSize, bool iHasFullResolution) const;
+
+  //! @return the tile holding `iFrameNumber` if on the GPU (`nullptr` otherwise), marking it drawn in any case
+  RLTexture const *findFrameTile(int iFrameNumber) const;
+
+  void resetFrameTiles(int iFramesPerTile);
+
+private:
+  class GPUUpload;
+  class GPUFrameTileUpload;
+
 protected:
   std::shared_ptr<FilmStrip> fFilmStrip{};
   mutable std::vector<std::unique_ptr<RLTexture>> fGPUTextures{};
+  std::vector<std::unique_ptr<RLTexture>> fGPUMipLevels{}; // [i] is level i + 1 (nullptr until uploaded)
+  int fGPUMipLevelsNumFrames{};
+  // frame-range residency: fGPUFrameTiles[i] holds the frames [i * fGPUFramesPerTile, (i + 1) * fGPUFramesPerTile)
+  // (nullptr when not on the GPU)
+  int fGPUFramesPerTile{};
+  int fGPUFrameTilesNumFrames{};
+  std::vector<std::unique_ptr<RLTexture>> fGPUFrameTiles{};
+  mutable std::vector<int> fGPUFrameTilesLastDrawnFrame{};
+  std::vector<bool> fGPUFrameTilesUploading{};
+  mutable int fLastDrawnFrame{-1};
+  bool fEvicted{};
+  int fGPUUploadGeneration{};
+  bool fGPUUploadPending{};
+
+  inline static std::atomic<std::uint64_t> kGPUVersion{1};
 };
 
 struct Icon
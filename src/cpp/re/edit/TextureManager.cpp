@@ -21,10 +21,73 @@
 #include "ReGui.h"
 #include "imgui_internal.h"
 #include "UIContext.h"
+#include "RLDrawList.h"
 #include <raylib.h>
+#include <rlgl.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
 
 namespace re::edit {
 
+namespace impl {
+
+//------------------------------------------------------------------------
+// impl::multiply
+//------------------------------------------------------------------------
+constexpr Color multiply(Color const &c1, Color const &c2)
+{
+  auto m = [](unsigned char v1, unsigned char v2) { return static_cast<unsigned char>((v1 * v2 + 127) / 255); };
+  return Color{m(c1.r, c2.r), m(c1.g, c2.g), m(c1.b, c2.b), m(c1.a, c2.a)};
+}
+
+//------------------------------------------------------------------------
+// impl::toRLRectangle
+//------------------------------------------------------------------------
+constexpr Rectangle toRLRectangle(ReGui::Rect const &iRect)
+{
+  return Rectangle{iRect.Min.x, iRect.Min.y, iRect.GetWidth(), iRect.GetHeight()};
+}
+
+//------------------------------------------------------------------------
+// impl::uploadBand
+// Uploads the next band of rows (at most `kGPUUploadBandSize` bytes) of `iImage` (starting at `iImageY`) into
+// `iTexture` (starting at `iTextureY`) and returns how many rows were uploaded
+//------------------------------------------------------------------------
+int uploadBand(::Texture const &iTexture, int iTextureY, Image const &iImage, int iImageY)
+{
+  RE_EDIT_ASSERT(iImage.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 && iTexture.width == iImage.width);
+
+  auto const rowSize = static_cast<std::size_t>(iImage.width) * RLImageRGBA8::kBytesPerPixel;
+  auto const bandHeight = static_cast<int>(std::max<std::size_t>(kGPUUploadBandSize / rowSize, 1));
+  auto const h = std::min({bandHeight, iTexture.height - iTextureY, iImage.height - iImageY});
+
+  UpdateTextureRec(iTexture,
+                   Rectangle{0, static_cast<float>(iTextureY), static_cast<float>(iImage.width), static_cast<float>(h)},
+                   static_cast<unsigned char const *>(iImage.data) + static_cast<std::size_t>(iImageY) * rowSize);
+
+  return h;
+}
+
+//------------------------------------------------------------------------
+// impl::computeFramesPerTile
+// Frame-range residency: how many frames to put in a tile or 0 when the filmstrip should be uploaded in full
+//------------------------------------------------------------------------
+int computeFramesPerTile(FilmStrip const &iFilmStrip, int iMaxTextureSize)
+{
+  auto const frameHeight = iFilmStrip.frameHeight();
+  auto const frameSize = static_cast<std::size_t>(iFilmStrip.frameWidth()) * frameHeight * RLImageRGBA8::kBytesPerPixel;
+  auto const size = static_cast<std::size_t>(iFilmStrip.width()) * iFilmStrip.height() * RLImageRGBA8::kBytesPerPixel;
+
+  if(size < kGPUFrameResidencyThreshold || frameSize == 0 || frameHeight > iMaxTextureSize)
+    return 0;
+
+  auto const framesPerTile = std::clamp(static_cast<int>(kGPUFrameTileSize / frameSize), 1, iMaxTextureSize / frameHeight);
+  return framesPerTile < iFilmStrip.numFrames() ? framesPerTile : 0;
+}
+
+}
+
 //------------------------------------------------------------------------
 // TextureManager::init
 //------------------------------------------------------------------------
@@ -41,13 +104,15 @@ std::shared_ptr<Texture> TextureManager::getTexture(std::string const &iKey) con
   if(iKey.empty())
     return nullptr;
 
-  auto iter = fTextures.find(iKey);
+  auto const key = Symbol{iKey};
+
+  auto iter = fTextures.find(key);
   if(iter != fTextures.end())
     return iter->second;
 
   std::shared_ptr<Texture> texture = createTexture();
-  texture->loadOnGPU(fFilmStripMgr->getFilmStrip(iKey));
-  fTextures[iKey] = texture;
+  loadOnGPU(texture, fFilmStripMgr->getFilmStrip(iKey));
+  fTextures[key] = texture;
 
   return texture;
 }
@@ -76,16 +141,20 @@ std::shared_ptr<Texture> TextureManager::loadTexture(FilmStrip::key_t const &iKe
 //------------------------------------------------------------------------
 std::shared_ptr<Texture> TextureManager::findTexture(std::string const &iKey) const
 {
-  auto iter = fTextures.find(iKey);
-  if(iter != fTextures.end())
-    return iter->second;
+  // a key which has never been interned has no texture (and is not added to the table by the lookup)
+  if(auto key = Symbol::find(iKey))
+  {
+    auto iter = fTextures.find(*key);
+    if(iter != fTextures.end())
+      return iter->second;
+  }
 
   auto filmStrip = fFilmStripMgr->findFilmStrip(iKey);
   if(filmStrip && filmStrip->isValid())
   {
     std::shared_ptr<Texture> texture = createTexture();
-    texture->loadOnGPU(fFilmStripMgr->getFilmStrip(iKey));
-    fTextures[iKey] = texture;
+    loadOnGPU(texture, fFilmStripMgr->getFilmStrip(iKey));
+    fTextures[Symbol{iKey}] = texture;
 
     return texture;
   }
@@ -104,10 +173,11 @@ std::shared_ptr<Texture> TextureManager::findHDTexture(std::string const &iKey)
 //------------------------------------------------------------------------
 // TextureManager::scanDirectory
 //------------------------------------------------------------------------
-void TextureManager::scanDirectory()
+std::set<FilmStrip::key_t> TextureManager::scanDirectory()
 {
   auto keys = fFilmStripMgr->scanDirectory();
   std::for_each(keys.begin(), keys.end(), [this](auto const &k) { updateTexture(k); });
+  return keys;
 }
 
 //------------------------------------------------------------------------
@@ -128,19 +198,21 @@ std::optional<FilmStrip::key_t> TextureManager::importTexture(fs::path const &iT
 //------------------------------------------------------------------------
 // TextureManager::importBuiltIns
 //------------------------------------------------------------------------
-void TextureManager::importBuiltIns(std::set<FilmStrip::key_t> const &iKeys, UserError *oErrors)
+bool TextureManager::importBuiltIns(std::set<FilmStrip::key_t> const &iKeys, UserError *oErrors)
 {
   auto keys = fFilmStripMgr->importBuiltIns(iKeys, oErrors);
   std::for_each(keys.begin(), keys.end(), [this](auto const &k) { updateTexture(k); });
+  return !keys.empty();
 }
 
 //------------------------------------------------------------------------
 // TextureManager::applyEffects
 //------------------------------------------------------------------------
-void TextureManager::applyEffects(std::vector<FilmStripFX> const &iEffects, UserError *oErrors)
+bool TextureManager::applyEffects(std::vector<FilmStripFX> const &iEffects, UserError *oErrors)
 {
   auto keys = fFilmStripMgr->applyEffects(iEffects, oErrors);
   std::for_each(keys.begin(), keys.end(), [this](auto const &k) { updateTexture(k); });
+  return !keys.empty();
 }
 
 
@@ -164,11 +236,84 @@ std::optional<FilmStrip::key_t> TextureManager::applyEffects(FilmStrip::key_t co
 //------------------------------------------------------------------------
 void TextureManager::updateTexture(FilmStrip::key_t const &iKey)
 {
-  auto iter = fTextures.find(iKey);
-  if(iter != fTextures.end())
+  if(auto key = Symbol::find(iKey))
+  {
+    auto iter = fTextures.find(*key);
+    if(iter != fTextures.end())
+    {
+      loadOnGPU(iter->second, fFilmStripMgr->getFilmStrip(iKey));
+    }
+  }
+}
+
+//------------------------------------------------------------------------
+// TextureManager::loadOnGPU
+//------------------------------------------------------------------------
+void TextureManager::loadOnGPU(std::shared_ptr<Texture> const &iTexture, std::shared_ptr<FilmStrip> const &iFilmStrip) const
+{
+  // pixels were released => decode them again (the texture will be loaded on the GPU when done)
+  fFilmStripMgr->scheduleLoad(iFilmStrip);
+  iTexture->fEvicted = false;
+  iTexture->loadOnGPU(iFilmStrip);
+}
+
+//------------------------------------------------------------------------
+// TextureManager::enforceMemoryBudget
+//------------------------------------------------------------------------
+void TextureManager::enforceMemoryBudget(std::size_t iMemoryBudget)
+{
+  auto const currentFrame = ImGui::GetFrameCount();
+
+  std::size_t gpuMemorySize = 0;
+  std::vector<Texture *> candidates{};
+  std::set<FilmStrip const *> frameTiledFilmStrips{};
+
+  for(auto const &[key, texture]: fTextures)
+  {
+    // an evicted texture is needed again
+    if(texture->fEvicted && texture->fLastDrawnFrame == currentFrame)
+      loadOnGPU(texture, texture->fFilmStrip);
+
+    texture->updateFrameTiles(currentFrame);
+
+    if(texture->isFrameTiled() && texture->fFilmStrip)
+      frameTiledFilmStrips.emplace(texture->fFilmStrip.get());
+
+    if(texture->isLoadedOnGPU())
+    {
+      gpuMemorySize += texture->gpuMemorySize();
+      if(currentFrame - texture->fLastDrawnFrame > kTextureEvictionFrameCount)
+        candidates.emplace_back(texture.get());
+    }
+  }
+
+  auto cpuMemorySize = fFilmStripMgr->computeMemorySize();
+
+  if(iMemoryBudget > 0 && gpuMemorySize + cpuMemorySize > iMemoryBudget)
   {
-    iter->second->loadOnGPU(fFilmStripMgr->getFilmStrip(iKey));
+    // pixels which can be decoded again are released first, except the ones backing frame tiles: the tiles which
+    // are not resident are uploaded from them (releasing them would re-decode the texture and drop all its tiles)
+    cpuMemorySize -= fFilmStripMgr->releasePixels([&frameTiledFilmStrips](FilmStrip const &iFilmStrip) {
+      return frameTiledFilmStrips.find(&iFilmStrip) != frameTiledFilmStrips.end();
+    });
+
+    // least recently drawn first
+    std::sort(candidates.begin(), candidates.end(), [](auto t1, auto t2) { return t1->fLastDrawnFrame < t2->fLastDrawnFrame; });
+
+    for(auto texture: candidates)
+    {
+      if(gpuMemorySize + cpuMemorySize <= iMemoryBudget)
+        break;
+      gpuMemorySize -= texture->gpuMemorySize();
+      texture->unloadFromGPU();
+      texture->fEvicted = true;
+      fMemoryStats.fEvictedCount++;
+    }
   }
+
+  fMemoryStats.fCPUMemorySize = cpuMemorySize;
+  fMemoryStats.fGPUMemorySize = gpuMemorySize;
+  fMemoryStats.fPeakMemorySize = std::max(fMemoryStats.fPeakMemorySize, fMemoryStats.memorySize());
 }
 
 //------------------------------------------------------------------------
@@ -196,12 +341,15 @@ bool TextureManager::remove(FilmStrip::key_t const &iKey)
   auto const deleted = fFilmStripMgr->remove(iKey);
   if(deleted)
   {
-    auto iter = fTextures.find(iKey);
-    if(iter != fTextures.end())
+    if(auto key = Symbol::find(iKey))
     {
-      iter->second->unloadFromGPU();
+      auto iter = fTextures.find(*key);
+      if(iter != fTextures.end())
+      {
+        iter->second->unloadFromGPU();
+        fTextures.erase(iter);
+      }
     }
-    fTextures.erase(iKey);
   }
   return deleted;
 }
@@ -228,7 +376,16 @@ void Texture::loadOnGPU(std::shared_ptr<FilmStrip> const &iFilmStrip)
 {
   fFilmStrip = iFilmStrip;
 
-  if(fFilmStrip->isValid() && UIContext::HasCurrent())
+  // the pixels are still being decoded in the background: a placeholder is drawn until then
+  auto pending = fFilmStrip->deferUntilLoaded([weakTexture = weak_from_this(), filmStrip = iFilmStrip] {
+    auto texture = weakTexture.lock();
+    if(texture && texture->fFilmStrip == filmStrip)
+      texture->loadOnGPU(filmStrip);
+  });
+
+  if(pending)
+    unloadFromGPU();
+  else if(fFilmStrip->isLoaded() && UIContext::HasCurrent())
   {
     UIContext::GetCurrent().execute([texture = shared_from_this(), filmStrip = iFilmStrip] {
       texture->loadOnGPUFromUIThread(filmStrip);
@@ -238,31 +395,389 @@ void Texture::loadOnGPU(std::shared_ptr<FilmStrip> const &iFilmStrip)
     unloadFromGPU();
 }
 
+//------------------------------------------------------------------------
+// class Texture::GPUUpload
+// Uploads the pixels of a filmstrip in bands of rows (sub-image updates of textures allocated upfront) so that a
+// large filmstrip does not stall a frame. The textures replace the ones of the texture only when complete.
+// The (much smaller) mip levels of the filmstrip are uploaded first, smallest first, and are used as soon as each
+// one is complete so that a zoomed out panel shows something quickly.
+//------------------------------------------------------------------------
+class Texture::GPUUpload : public UIContext::GPUUpload
+{
+public:
+  GPUUpload(std::shared_ptr<Texture> const &iTexture, std::shared_ptr<FilmStrip> iFilmStrip, int iMaxTextureSize) :
+    fTexture{iTexture},
+    fFilmStrip{std::move(iFilmStrip)},
+    fGeneration{iTexture->fGPUUploadGeneration},
+    fMaxTextureSize{iMaxTextureSize},
+    fMipLevel{fFilmStrip->numMipLevels()},
+    fMipLevelsNumFrames{fFilmStrip->numFrames()}
+  {}
+
+  bool isVisible() const override
+  {
+    auto texture = fTexture.lock();
+    return texture && texture->fLastDrawnFrame >= ImGui::GetFrameCount() - 1;
+  }
+
+  bool uploadNextStep() override
+  {
+    auto texture = fTexture.lock();
+
+    // superseded by another upload or unloaded
+    if(!texture || texture->fGPUUploadGeneration != fGeneration)
+      return false;
+
+    // the pixels may have been released in the meantime
+    if(!fFilmStrip->isLoaded())
+    {
+      texture->unloadFromGPU();
+      texture->fEvicted = true;
+      return false;
+    }
+
+    if(fMipLevel > 0)
+    {
+      uploadMipLevelNextStep(*texture);
+      return true;
+    }
+
+    // large filmstrip => only the tiles of frames which are drawn are uploaded (on demand), pixels are kept
+    if(fY == 0 && fTextures.empty())
+    {
+      if(auto framesPerTile = impl::computeFramesPerTile(*fFilmStrip, fMaxTextureSize); framesPerTile > 0)
+      {
+        texture->fGPUTextures.clear();
+        texture->resetFrameTiles(framesPerTile);
+        texture->fGPUUploadPending = false;
+        kGPUVersion++;
+        return false;
+      }
+    }
+
+    auto const &image = fFilmStrip->rlImage();
+
+    // a filmstrip taller than what the GPU supports is split into multiple textures
+    if(fTextures.empty() || fTextureY == fTextures.back()->height())
+    {
+      auto h = std::min(image.height - fY, fMaxTextureSize);
+      auto id = rlLoadTexture(nullptr, image.width, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+      fTextures.emplace_back(std::make_unique<RLTexture>(::Texture{id, image.width, h, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8}));
+      fTextureY = 0;
+    }
+
+    auto const h = impl::uploadBand(fTextures.back()->asRLTexture(), fTextureY, image, fY);
+
+    fY += h;
+    fTextureY += h;
+
+    if(fY < image.height)
+      return true;
+
+    texture->fGPUTextures = std::move(fTextures);
+    texture->resetFrameTiles(0);
+    texture->fGPUUploadPending = false;
+    kGPUVersion++;
+
+    // the pixels are now on the GPU (they can be decoded again if ever needed)
+    fFilmStrip->releasePixels();
+
+    return false;
+  }
+
+private:
+  void uploadMipLevelNextStep(Texture &iTexture)
+  {
+    // the levels are gone if the number of frames changed in the meantime
+    if(fMipLevel > fFilmStrip->numMipLevels() || fFilmStrip->numFrames() != fMipLevelsNumFrames)
+    {
+      fMipLevel = 0;
+      return;
+    }
+
+    auto const &image = fFilmStrip->mipLevel(fMipLevel);
+
+    // never split (the full resolution is used instead) and never big enough to require frame-range residency
+    if(image.height > fMaxTextureSize ||
+       static_cast<std::size_t>(image.width) * image.height * RLImageRGBA8::kBytesPerPixel >= kGPUFrameResidencyThreshold)
+    {
+      fMipLevel--;
+      return;
+    }
+
+    if(!fMipTexture)
+    {
+      auto id = rlLoadTexture(nullptr, image.width, image.height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+      fMipTexture = std::make_unique<RLTexture>(::Texture{id, image.width, image.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8});
+      fY = 0;
+    }
+
+    fY += impl::uploadBand(fMipTexture->asRLTexture(), fY, image, fY);
+
+    if(fY < image.height)
+      return;
+
+    // the level is usable right away
+    if(iTexture.fGPUMipLevelsNumFrames != fMipLevelsNumFrames)
+      iTexture.fGPUMipLevels.clear();
+    iTexture.fGPUMipLevels.resize(std::max<std::size_t>(iTexture.fGPUMipLevels.size(), fMipLevel));
+    iTexture.fGPUMipLevels[fMipLevel - 1] = std::move(fMipTexture);
+    iTexture.fGPUMipLevelsNumFrames = fMipLevelsNumFrames;
+    kGPUVersion++;
+
+    fMipLevel--;
+    fY = 0;
+  }
+
+private:
+  std::weak_ptr<Texture> fTexture;
+  std::shared_ptr<FilmStrip> fFilmStrip;
+  int fGeneration;
+  int fMaxTextureSize;
+  int fMipLevel;
+  int fMipLevelsNumFrames;
+  std::unique_ptr<RLTexture> fMipTexture{};
+  std::vector<std::unique_ptr<RLTexture>> fTextures{};
+  int fY{};
+  int fTextureY{};
+};
+
+//------------------------------------------------------------------------
+// class Texture::GPUFrameTileUpload
+// Uploads one tile of frames (frame-range residency) from the pixels kept in memory
+//------------------------------------------------------------------------
+class Texture::GPUFrameTileUpload : public UIContext::GPUUpload
+{
+public:
+  GPUFrameTileUpload(std::shared_ptr<Texture> const &iTexture, int iTile) :
+    fTexture{iTexture},
+    fFilmStrip{iTexture->fFilmStrip},
+    fGeneration{iTexture->fGPUUploadGeneration},
+    fNumFrames{iTexture->fGPUFrameTilesNumFrames},
+    fTile{iTile}
+  {}
+
+  bool isVisible() const override
+  {
+    auto texture = fTexture.lock();
+    return texture && texture->fLastDrawnFrame >= ImGui::GetFrameCount() - 1;
+  }
+
+  bool uploadNextStep() override
+  {
+    auto texture = fTexture.lock();
+
+    // superseded by another upload, unloaded or the tiles have changed
+    if(!texture || texture->fGPUUploadGeneration != fGeneration || texture->fGPUFrameTilesNumFrames != fNumFrames ||
+       fTile >= static_cast<int>(texture->fGPUFrameTiles.size()))
+      return false;
+
+    // the pixels have been released in the meantime => they need to be decoded again
+    if(!fFilmStrip->isLoaded())
+    {
+      texture->fGPUFrameTilesUploading[fTile] = false;
+      texture->fEvicted = true;
+      return false;
+    }
+
+    auto const &image = fFilmStrip->rlImage();
+    auto const frameHeight = fFilmStrip->frameHeight();
+    auto const startY = fTile * texture->fGPUFramesPerTile * frameHeight;
+
+    if(!fTileTexture)
+    {
+      auto h = std::min(texture->fGPUFramesPerTile, fNumFrames - fTile * texture->fGPUFramesPerTile) * frameHeight;
+      auto id = rlLoadTexture(nullptr, image.width, h, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+      fTileTexture = std::make_unique<RLTexture>(::Texture{id, image.width, h, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8});
+    }
+
+    fY += impl::uploadBand(fTileTexture->asRLTexture(), fY, image, startY + fY);
+
+    if(fY < fTileTexture->height())
+      return true;
+
+    texture->fGPUFrameTiles[fTile] = std::move(fTileTexture);
+    texture->fGPUFrameTilesUploading[fTile] = false;
+    kGPUVersion++;
+
+    return false;
+  }
+
+private:
+  std::weak_ptr<Texture> fTexture;
+  std::shared_ptr<FilmStrip> fFilmStrip;
+  int fGeneration;
+  int fNumFrames;
+  int fTile;
+  std::unique_ptr<RLTexture> fTileTexture{};
+  int fY{};
+};
+
+//------------------------------------------------------------------------
+// Texture::resetFrameTiles
+//------------------------------------------------------------------------
+void Texture::resetFrameTiles(int iFramesPerTile)
+{
+  fGPUFramesPerTile = iFramesPerTile;
+  fGPUFrameTiles.clear();
+  fGPUFrameTilesLastDrawnFrame.clear();
+  fGPUFrameTilesUploading.clear();
+
+  if(iFramesPerTile > 0)
+  {
+    fGPUFrameTilesNumFrames = numFrames();
+    auto const numTiles = static_cast<std::size_t>((fGPUFrameTilesNumFrames + iFramesPerTile - 1) / iFramesPerTile);
+    fGPUFrameTiles.resize(numTiles);
+    fGPUFrameTilesLastDrawnFrame.resize(numTiles, -1);
+    fGPUFrameTilesUploading.resize(numTiles, false);
+  }
+  else
+    fGPUFrameTilesNumFrames = 0;
+}
+
+//------------------------------------------------------------------------
+// Texture::updateFrameTiles
+//------------------------------------------------------------------------
+void Texture::updateFrameTiles(int iCurrentFrame)
+{
+  if(!isFrameTiled() || fGPUUploadPending)
+    return;
+
+  // the number of frames has been overridden => the tiles no longer match the frames
+  if(fGPUFrameTilesNumFrames != numFrames())
+  {
+    loadOnGPUFromUIThread(fFilmStrip);
+    return;
+  }
+
+  for(std::size_t tile = 0; tile < fGPUFrameTiles.size(); tile++)
+  {
+    auto const lastDrawnFrame = fGPUFrameTilesLastDrawnFrame[tile];
+    if(lastDrawnFrame == iCurrentFrame)
+    {
+      if(!fGPUFrameTiles[tile] && !fGPUFrameTilesUploading[tile])
+      {
+        fGPUFrameTilesUploading[tile] = true;
+        UIContext::GetCurrent().enqueueGPUUpload(std::make_shared<GPUFrameTileUpload>(shared_from_this(), static_cast<int>(tile)));
+      }
+    }
+    // Implementation note: the GPU version is not bumped as nothing currently displayed changes (a canvas rendered
+    // with this tile keeps it until rendered again, at which point the tile is requested again)
+    else if(fGPUFrameTiles[tile] && iCurrentFrame - lastDrawnFrame > kTextureEvictionFrameCount)
+      fGPUFrameTiles[tile] = nullptr;
+  }
+}
+
 //------------------------------------------------------------------------
 // Texture::loadOnGPUFromUIThread
 //------------------------------------------------------------------------
 void Texture::loadOnGPUFromUIThread(std::shared_ptr<FilmStrip> const &iFilmStrip)
 {
-  auto const maxTextureSize = UIContext::GetCurrent().maxTextureSize();
+  // the pixels may have been released in the meantime
+  if(!iFilmStrip->isLoaded())
+  {
+    unloadFromGPU();
+    fEvicted = true;
+    return;
+  }
+
+  auto &uiContext = UIContext::GetCurrent();
+
+  // abandons any upload in progress (the levels are uploaded again first)
+  fGPUUploadGeneration++;
+  fGPUUploadPending = true;
+  fGPUMipLevels.clear();
+  kGPUVersion++;
+
+  uiContext.enqueueGPUUpload(std::make_shared<GPUUpload>(shared_from_this(), iFilmStrip, uiContext.maxTextureSize()));
+}
+
+//------------------------------------------------------------------------
+// Texture::gpuMemorySize
+//------------------------------------------------------------------------
+std::size_t Texture::gpuMemorySize() const
+{
+  std::size_t res = 0;
+  for(auto const &texture: fGPUTextures)
+    res += static_cast<std::size_t>(texture->width()) * texture->height() * RLImageRGBA8::kBytesPerPixel;
+  for(auto const &texture: fGPUMipLevels)
+  {
+    if(texture)
+      res += static_cast<std::size_t>(texture->width()) * texture->height() * RLImageRGBA8::kBytesPerPixel;
+  }
+  for(auto const &texture: fGPUFrameTiles)
+  {
+    if(texture)
+      res += static_cast<std::size_t>(texture->width()) * texture->height() * RLImageRGBA8::kBytesPerPixel;
+  }
+  return res;
+}
+
+//------------------------------------------------------------------------
+// Texture::findMipLevel
+//------------------------------------------------------------------------
+Texture::RLTexture const *Texture::findMipLevel(ImVec2 const &iSize, bool iHasFullResolution) const
+{
+  if(fGPUMipLevels.empty() || fGPUMipLevelsNumFrames != numFrames())
+    return nullptr;
 
-  auto image = iFilmStrip->rlImage();
-  RE_EDIT_ASSERT(image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+  auto const numLevels = static_cast<int>(fGPUMipLevels.size());
 
-  auto pixels = static_cast<unsigned char *>(image.data);
-  auto height = image.height;
+  // level n is 1/2^n of the size => the largest level which is not smaller than what is drawn
+  auto const scale = std::max(iSize.x / frameWidth(), iSize.y / frameHeight());
+  auto const level = scale > 0.5f || scale <= 0 ? 0 : std::min(static_cast<int>(std::floor(std::log2(1.0f / scale))), numLevels);
 
-  fGPUTextures.clear();
+  if(level > 0)
+  {
+    // when not uploaded yet, a coarser level (uploaded first) is better than the full resolution
+    for(auto l = level; l <= numLevels; l++)
+    {
+      if(fGPUMipLevels[l - 1])
+        return fGPUMipLevels[l - 1].get();
+    }
+  }
 
-  do
+  // full resolution not uploaded yet => finest level available
+  if(!iHasFullResolution)
   {
-    auto h = std::min(height, maxTextureSize);
-    image.height = h;
-    image.data = pixels;
-    fGPUTextures.emplace_back(std::make_unique<RLTexture>(LoadTextureFromImage(image)));
-    height -= h;
-    pixels += 4 * image.width * h;
+    for(auto const &texture: fGPUMipLevels)
+    {
+      if(texture)
+        return texture.get();
+    }
+  }
+
+  return nullptr;
+}
+
+//------------------------------------------------------------------------
+// Texture::findFrameTile
+//------------------------------------------------------------------------
+Texture::RLTexture const *Texture::findFrameTile(int iFrameNumber) const
+{
+  if(!isFrameTiled() || fGPUFrameTilesNumFrames != numFrames() || iFrameNumber < 0 || iFrameNumber >= fGPUFrameTilesNumFrames)
+    return nullptr;
+
+  auto const tile = static_cast<std::size_t>(iFrameNumber / fGPUFramesPerTile);
+  // requests the tile (see updateFrameTiles)
+  fGPUFrameTilesLastDrawnFrame[tile] = ImGui::GetFrameCount();
+  return fGPUFrameTiles[tile].get();
+}
+
+//------------------------------------------------------------------------
+// Texture::markDrawn
+//------------------------------------------------------------------------
+void Texture::markDrawn(int iFrameNumber) const
+{
+  fLastDrawnFrame = ImGui::GetFrameCount();
+
+  // unlike findFrameTile, a tile which is not resident is not requested (nothing is actually drawn)
+  if(isFrameTiled() && fGPUFrameTilesNumFrames == numFrames() && iFrameNumber >= 0 && iFrameNumber < fGPUFrameTilesNumFrames)
+  {
+    auto const tile = static_cast<std::size_t>(iFrameNumber / fGPUFramesPerTile);
+    if(fGPUFrameTiles[tile])
+      fGPUFrameTilesLastDrawnFrame[tile] = ImGui::GetFrameCount();
   }
-  while(height != 0);
 }
 
 //------------------------------------------------------------------------
@@ -276,7 +791,10 @@ void Texture::doDraw(bool iAddItem,
                      ImU32 iTextureColor,
                      texture::FX const &iTextureFX) const
 {
-  if(fGPUTextures.empty())
+  fLastDrawnFrame = ImGui::GetFrameCount();
+
+  // nothing to draw unless the pixels are being (re)loaded in which case a placeholder is drawn
+  if(fGPUTextures.empty() && !isFrameTiled() && !isPending() && !fEvicted && !fGPUUploadPending)
     return;
 
   auto const size = ImVec2{iSize.x == 0 ? frameWidth()  : iSize.x, iSize.y == 0 ? frameHeight() : iSize.y};
@@ -297,16 +815,44 @@ void Texture::doDraw(bool iAddItem,
   const auto frameHeight = this->frameHeight();
   const auto frameY = frameHeight * static_cast<float>(iFrameNumber);
 
-  auto data = fGPUTextures[0].get();
+  auto const frameTile = findFrameTile(iFrameNumber);
 
-  if(fGPUTextures.size() == 1)
+  if(auto mipLevel = findMipLevel(size, frameTile || !fGPUTextures.empty()))
+  {
+    auto const mipFrameWidth = static_cast<float>(mipLevel->width());
+    auto const mipFrameHeight = static_cast<float>(mipLevel->height() / numFrames());
+    auto const mipFrameY = mipFrameHeight * static_cast<float>(iFrameNumber);
+    ReGui::Rect source{0, mipFrameY, mipFrameWidth, mipFrameY + mipFrameHeight};
+    mipLevel->draw(!iAddItem, source, dest, iTextureColor, iTextureFX);
+  }
+  else if(frameTile)
+  {
+    auto const tileFrameY = frameHeight * static_cast<float>(iFrameNumber % fGPUFramesPerTile);
+    ReGui::Rect source{0, tileFrameY, frameWidth(), tileFrameY + frameHeight};
+    frameTile->draw(!iAddItem, source, dest, iTextureColor, iTextureFX);
+  }
+  else if(fGPUTextures.empty())
+  {
+    // placeholder until the filmstrip is decoded (see FilmStripMgr) and uploaded, or reloaded after eviction
+    if(iAddItem)
+      drawList->AddRectFilled(dest.Min, dest.Max, ReGui::GetColorU32(kPendingTextureColor));
+    else if(auto rlDrawList = UIContext::GetCurrent().getRLDrawList())
+      rlDrawList->addRectangle(impl::toRLRectangle(dest), ReGui::GetRLColor(kPendingTextureColor));
+    else
+      DrawRectangle(static_cast<int>(dest.Min.x), static_cast<int>(dest.Min.y),
+                    static_cast<int>(dest.GetWidth()), static_cast<int>(dest.GetHeight()),
+                    ReGui::GetRLColor(kPendingTextureColor));
+  }
+  else if(fGPUTextures.size() == 1)
   {
     // most frequent use case
     ReGui::Rect source{0, frameY, 0 + frameWidth(), frameY + frameHeight};
-    data->draw(!iAddItem, source, dest, iTextureColor, iTextureFX);
+    fGPUTextures[0]->draw(!iAddItem, source, dest, iTextureColor, iTextureFX);
   }
   else
   {
+    auto data = fGPUTextures[0].get();
+
     // used only if a filmstrip had to be split into multiple textures due to GPU limitations (ex: on macOS/metal, the
     // limit is 16384 pixels for a texture height)
 
@@ -356,6 +902,8 @@ void Texture::doDraw(bool iAddItem,
   {
     if(iAddItem)
       drawList->AddRect(dest.Min, dest.Max, iBorderColor, 0.0f);
+    else if(auto rlDrawList = UIContext::GetCurrent().getRLDrawList())
+      rlDrawList->addRectangleLines(impl::toRLRectangle(dest), ReGui::GetRLColor(iBorderColor));
     else
       DrawRectangleLines(static_cast<int>(dest.Min.x), static_cast<int>(dest.Min.y),
                          static_cast<int>(dest.GetWidth()), static_cast<int>(dest.GetHeight()),
@@ -405,29 +953,45 @@ void Texture::RLTexture::draw(bool iUseRLDraw,
       iDestination.GetWidth(),
       iDestination.GetHeight()
     };
-    bool useFXShader = false;
-
     if(iTextureFX.isFlippedX())
       source.width = -source.width;
 
     if(iTextureFX.isFlippedY())
       source.height = -source.height;
 
-    if(iTextureFX.hasShaderFX())
+    auto color = ReGui::GetRLColor(iTextureColor);
+    std::optional<RLDrawList::ShaderFX> shaderFX{};
+
+    if(iTextureFX.hasBrightness() || iTextureFX.hasContrast())
     {
       auto contrast = static_cast<float>(iTextureFX.fContrast);
       contrast = (100.0f + contrast) / 100.0f;
       contrast *= contrast;
-      UIContext::GetCurrent().beginFXShader(ReGui::GetColorImVec4(iTextureFX.fTint),
-                                            static_cast<float>(iTextureFX.fBrightness) / 255.0f,
-                                            contrast);
-      useFXShader = true;
+      shaderFX = RLDrawList::ShaderFX{ReGui::GetColorImVec4(iTextureFX.fTint),
+                                      static_cast<float>(iTextureFX.fBrightness) / 255.0f,
+                                      contrast};
+    }
+    else if(iTextureFX.hasTint())
+    {
+      // without brightness/contrast, the shader simply multiplies by the tint, which is what the default shader
+      // does with the color => no need to switch shader (which breaks the batch)
+      color = impl::multiply(color, ReGui::GetRLColor(iTextureFX.fTint));
     }
 
-    DrawTexturePro(asRLTexture(), source, destination, {}, 0, ReGui::GetRLColor(iTextureColor));
+    auto &uiContext = UIContext::GetCurrent();
 
-    if(useFXShader)
-      UIContext::GetCurrent().endFXShader();
+    if(auto drawList = uiContext.getRLDrawList())
+      drawList->addTexture(asRLTexture(), source, destination, color, shaderFX);
+    else
+    {
+      if(shaderFX)
+        uiContext.beginFXShader(shaderFX->fTint, shaderFX->fBrightness, shaderFX->fContrast);
+
+      DrawTexturePro(asRLTexture(), source, destination, {}, 0, color);
+
+      if(shaderFX)
+        uiContext.endFXShader();
+    }
   }
   else
   {
@@ -477,6 +1041,7 @@ void Texture::RenderTexture::resize(ImVec2 const &iSize, ImVec2 const &iScale)
   fRLRenderTexture = RLRenderTexture(static_cast<int>(iSize.x * iScale.x), static_cast<int>(iSize.y * iScale.y));
   fSize = iSize;
   fScale = iScale;
+  markContentChanged();
 }
 
 }
@@ -21,13 +21,25 @@
 
 #include "FilmStrip.h"
 #include "Texture.h"
-#include <map>
+#include "String.h"
 #include <memory>
+#include <unordered_map>
 
 namespace re::edit {
 
 class TextureManager
 {
+public:
+  struct MemoryStats
+  {
+    std::size_t fCPUMemorySize{};
+    std::size_t fGPUMemorySize{};
+    std::size_t fPeakMemorySize{};
+    int fEvictedCount{};
+
+    inline std::size_t memorySize() const { return fCPUMemorySize + fGPUMemorySize; }
+  };
+
 public:
   TextureManager() = default;
   virtual ~TextureManager() = default;
@@ -39,14 +51,14 @@ public:
   std::shared_ptr<Texture> findTexture(std::string const &iKey) const;
   std::shared_ptr<Texture> findHDTexture(std::string const &iKey) const;
 
-  void scanDirectory();
+  std::set<FilmStrip::key_t> scanDirectory();
   inline std::vector<std::string> getTextureKeys() const { return fFilmStripMgr->getKeys(); };
   inline std::vector<std::string> findTextureKeys(FilmStrip::Filter const &iFilter) const { return fFilmStripMgr->findKeys(iFilter); }
   inline bool checkTextureKeyMatchesFilter(FilmStrip::key_t const &iKey, FilmStrip::Filter const &iFilter) const { return fFilmStripMgr->checkKeyMatchesFilter(iKey, iFilter); }
   int overrideNumFrames(std::string const &iKey, int iNumFrames) const;
   std::optional<FilmStrip::key_t> importTexture(fs::path const &iTexturePath);
-  void importBuiltIns(std::set<FilmStrip::key_t> const &iKeys, UserError *oErrors = nullptr);
-  void applyEffects(std::vector<FilmStripFX> const &iEffects, UserError *oErrors = nullptr);
+  bool importBuiltIns(std::set<FilmStrip::key_t> const &iKeys, UserError *oErrors = nullptr);
+  bool applyEffects(std::vector<FilmStripFX> const &iEffects, UserError *oErrors = nullptr);
 
   /**
    * If no effects or no filmstrip found for `iKey` returns `std::nullopt` otherwise returns the key of the new texture */
@@ -54,13 +66,25 @@ public:
 
   bool remove(FilmStrip::key_t const &iKey);
 
+  /**
+   * Should be called once per frame (from the UI thread), after rendering. Reloads the textures which were evicted
+   * but have been drawn during this frame, and, if the memory used is above `iMemoryBudget` (0 means no budget),
+   * evicts the least recently drawn textures from the GPU (only the ones not drawn for at least
+   * `kTextureEvictionFrameCount` frames) and releases the pixels kept in memory. Also pages in/out the tiles of
+   * frames of the large filmstrips (see `Texture::updateFrameTiles`). */
+  void enforceMemoryBudget(std::size_t iMemoryBudget);
+
+  constexpr MemoryStats const &getMemoryStats() const { return fMemoryStats; }
+
 protected:
   std::unique_ptr<Texture> createTexture() const;
   void updateTexture(FilmStrip::key_t const &iKey);
+  void loadOnGPU(std::shared_ptr<Texture> const &iTexture, std::shared_ptr<FilmStrip> const &iFilmStrip) const;
 
 private:
   std::unique_ptr<FilmStripMgr> fFilmStripMgr{};
-  mutable std::map<std::string, std::shared_ptr<Texture>> fTextures{};
+  mutable std::unordered_map<Symbol, std::shared_ptr<Texture>> fTextures{}; // key (interned) -> texture
+  MemoryStats fMemoryStats{};
 };
 
 }
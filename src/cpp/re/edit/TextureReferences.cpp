@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#include "TextureReferences.h"
+#include <algorithm>
+
+namespace re::edit {
+
+//------------------------------------------------------------------------
+// TextureReferences::update
+//------------------------------------------------------------------------
+bool TextureReferences::update(owner_t iOwner, sources_t const &iSources, std::uint64_t iVersion)
+{
+  auto iter = fOwners.find(iOwner);
+
+  if(iter != fOwners.end())
+  {
+    auto &owner = iter->second;
+    owner.fVersion = iVersion;
+    if(owner.fValid && owner.fSources == iSources)
+      return false;
+    removeEdges(iOwner, owner);
+  }
+  else
+  {
+    if(iSources.empty())
+    {
+      // no need to track an owner which does not reference anything
+      return false;
+    }
+    iter = fOwners.try_emplace(iOwner).first;
+  }
+
+  auto &owner = iter->second;
+  owner.fSources = iSources;
+  owner.fVersion = iVersion;
+  owner.fValid = true;
+  addEdges(iOwner, owner);
+  return true;
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::invalidate
+//------------------------------------------------------------------------
+void TextureReferences::invalidate(owner_t iOwner)
+{
+  auto iter = fOwners.find(iOwner);
+  if(iter != fOwners.end())
+    iter->second.fValid = false;
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::remove
+//------------------------------------------------------------------------
+void TextureReferences::remove(owner_t iOwner)
+{
+  auto iter = fOwners.find(iOwner);
+  if(iter != fOwners.end())
+  {
+    removeEdges(iOwner, iter->second);
+    fOwners.erase(iter);
+  }
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::removeStale
+//------------------------------------------------------------------------
+void TextureReferences::removeStale(std::uint64_t iVersion)
+{
+  for(auto iter = fOwners.begin(); iter != fOwners.end();)
+  {
+    if(iter->second.fVersion != iVersion)
+    {
+      removeEdges(iter->first, iter->second);
+      iter = fOwners.erase(iter);
+    }
+    else
+      ++iter;
+  }
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::clear
+//------------------------------------------------------------------------
+void TextureReferences::clear()
+{
+  fOwners.clear();
+  fNodes.clear();
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::findNode
+//------------------------------------------------------------------------
+TextureReferences::Node const *TextureReferences::findNode(FilmStrip::key_t const &iKey) const
+{
+  // a key which has never been interned cannot be referenced (and is not added to the table by the lookup)
+  if(auto key = Symbol::find(iKey))
+  {
+    auto iter = fNodes.find(*key);
+    if(iter != fNodes.end())
+      return &iter->second;
+  }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::findOwners
+//------------------------------------------------------------------------
+void TextureReferences::findOwners(FilmStrip::key_t const &iKey, std::vector<owner_t> &oOwners) const
+{
+  if(auto node = findNode(iKey))
+  {
+    auto first = oOwners.size();
+    for(auto const &[owner, _]: node->fOwners)
+      oOwners.emplace_back(owner);
+    std::sort(oOwners.begin() + static_cast<std::ptrdiff_t>(first), oOwners.end());
+  }
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::addEdges
+//------------------------------------------------------------------------
+void TextureReferences::addEdges(owner_t iOwner, Owner &oOwner)
+{
+  for(auto const &source: oOwner.fSources)
+  {
+    if(source.fKey.empty())
+      continue;
+
+    Symbol key{source.fKey};
+
+    // the generated texture can only be known when the number of frames is known (see FilmStrip::computeKey)
+    if(source.fEffects.hasAny() && source.fNumFrames > 0)
+    {
+      addEdge(iOwner, oOwner, key, Usage::kAsSource);
+      FilmStripFX fx{source.fKey, source.fEffects};
+      addEdge(iOwner, oOwner, Symbol{FilmStrip::computeKey(source.fKey, source.fNumFrames, source.fEffects)}, Usage::kGenerated, &fx);
+    }
+    else
+      addEdge(iOwner, oOwner, key, Usage::kAsIs);
+  }
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::addEdge
+//------------------------------------------------------------------------
+void TextureReferences::addEdge(owner_t iOwner, Owner &oOwner, Symbol const &iKey, Usage iUsage, FilmStripFX const *iFX)
+{
+  auto &node = fNodes[iKey];
+  node.fOwners[iOwner]++;
+  switch(iUsage)
+  {
+    case Usage::kAsIs:
+      node.fAsIsCount++;
+      break;
+    case Usage::kAsSource:
+      node.fAsSourceCount++;
+      break;
+    case Usage::kGenerated:
+      // the key of the generated texture is derived from the source key and effects => they are the same for
+      // all the owners
+      if(node.fGeneratedCount++ == 0)
+        node.fFX = *iFX;
+      break;
+  }
+  oOwner.fEdges.emplace_back(Edge{iKey, iUsage});
+}
+
+//------------------------------------------------------------------------
+// TextureReferences::removeEdges
+//------------------------------------------------------------------------
+void TextureReferences::removeEdges(owner_t iOwner, Owner &oOwner)
+{
+  for(auto const &edge: oOwner.fEdges)
+  {
+    auto iter = fNodes.find(edge.fKey);
+    if(iter == fNodes.end())
+      continue;
+
+    auto &node = iter->second;
+
+    switch(edge.fUsage)
+    {
+      case Usage::kAsIs:
+        node.fAsIsCount--;
+        break;
+      case Usage::kAsSource:
+        node.fAsSourceCount--;
+        break;
+      case Usage::kGenerated:
+        node.fGeneratedCount--;
+        break;
+    }
+
+    auto owner = node.fOwners.find(iOwner);
+    if(owner != node.fOwners.end() && --owner->second == 0)
+      node.fOwners.erase(owner);
+
+    if(node.fOwners.empty())
+      fNodes.erase(iter);
+  }
+  oOwner.fEdges.clear();
+}
+
+}
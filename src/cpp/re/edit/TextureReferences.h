@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_TEXTURE_REFERENCES_H
+#define RE_EDIT_TEXTURE_REFERENCES_H
+
+#include "FilmStrip.h"
+#include "String.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace re::edit {
+
+/**
+ * Bidirectional graph between owners (widgets) and the textures they reference: for each owner, the textures it
+ * uses and, for each texture, the owners using it.
+ *
+ * An owner is described by its `Source`s (the texture keys and effects set in its attributes): a source with effects
+ * references both the original texture and the texture generated by the effects (whose key, computed with
+ * `FilmStrip::computeKey`, is only recomputed when the source changes).
+ *
+ * The graph only deals with keys: whether a texture exists, is valid, has a path... is resolved by the caller on the
+ * (distinct) textures returned. */
+class TextureReferences
+{
+public:
+  using owner_t = int;
+
+  struct Source
+  {
+    FilmStrip::key_t fKey{};
+    texture::FX fEffects{};
+    int fNumFrames{}; // the key of the texture generated by the effects depends on it
+
+    bool operator==(Source const &rhs) const { return fKey == rhs.fKey && fEffects == rhs.fEffects && fNumFrames == rhs.fNumFrames; }
+    bool operator!=(Source const &rhs) const { return !(*this == rhs); }
+  };
+
+  using sources_t = std::vector<Source>;
+
+  class Node
+  {
+  public:
+    //! `true` if at least one owner uses the texture as is
+    constexpr bool isUsedAsIs() const { return fAsIsCount > 0; }
+
+    //! `true` if at least one owner uses the texture as the source of effects
+    constexpr bool isUsedAsSource() const { return fAsSourceCount > 0; }
+
+    //! `true` if the texture is generated by applying effects to another texture (`getFX`)
+    constexpr bool isGenerated() const { return fGeneratedCount > 0; }
+    inline FilmStripFX const &getFX() const { return fFX; }
+
+    inline std::size_t getOwnerCount() const { return fOwners.size(); }
+
+    friend class TextureReferences;
+
+  private:
+    std::unordered_map<owner_t, int> fOwners{}; // owner -> number of references
+    int fAsIsCount{};
+    int fAsSourceCount{};
+    int fGeneratedCount{};
+    FilmStripFX fFX{};
+  };
+
+public:
+  /**
+   * Sets the sources of `iOwner` (`iVersion` is recorded, see `removeStale`). The graph is only modified when the
+   * sources differ from the previous ones.
+   *
+   * @return `true` if the graph was modified */
+  bool update(owner_t iOwner, sources_t const &iSources, std::uint64_t iVersion = 0);
+
+  //! Forces the next `update` of `iOwner` to modify the graph (even if its sources have not changed)
+  void invalidate(owner_t iOwner);
+
+  void remove(owner_t iOwner);
+
+  //! Removes all the owners which have not been updated with `iVersion`
+  void removeStale(std::uint64_t iVersion);
+
+  void clear();
+
+  inline bool contains(owner_t iOwner) const { return fOwners.find(iOwner) != fOwners.end(); }
+  inline std::size_t getOwnerCount() const { return fOwners.size(); }
+  inline std::size_t getTextureCount() const { return fNodes.size(); }
+
+  //! @return the node for `iKey` or `nullptr` if no owner references this texture
+  Node const *findNode(FilmStrip::key_t const &iKey) const;
+
+  //! Adds the owners referencing `iKey` (sorted, no duplicate) to `oOwners`
+  void findOwners(FilmStrip::key_t const &iKey, std::vector<owner_t> &oOwners) const;
+
+  //! Calls `f(Symbol const &iKey, Node const &iNode)` for each (distinct) texture referenced
+  template<typename F>
+  void forEach(F &&f) const { for(auto const &[key, node]: fNodes) f(key, node); }
+
+private:
+  enum class Usage { kAsIs, kAsSource, kGenerated };
+
+  struct Edge
+  {
+    Symbol fKey{};
+    Usage fUsage{};
+  };
+
+  struct Owner
+  {
+    sources_t fSources{};
+    std::vector<Edge> fEdges{};
+    std::uint64_t fVersion{};
+    bool fValid{true};
+  };
+
+  void addEdges(owner_t iOwner, Owner &oOwner);
+  void removeEdges(owner_t iOwner, Owner &oOwner);
+  void addEdge(owner_t iOwner, Owner &oOwner, Symbol const &iKey, Usage iUsage, FilmStripFX const *iFX = nullptr);
+
+private:
+  std::unordered_map<owner_t, Owner> fOwners{};
+  std::unordered_map<Symbol, Node> fNodes{};
+};
+
+}
+
+#endif //RE_EDIT_TEXTURE_REFERENCES_H
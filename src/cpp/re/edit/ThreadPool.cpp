@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#include "ThreadPool.h"
+#include "Errors.h"
+#include <algorithm>
+
+namespace re::edit {
+
+namespace impl {
+
+struct CurrentWorker
+{
+  ThreadPool const *fPool{};
+  std::size_t fIndex{};
+};
+
+static thread_local CurrentWorker tCurrentWorker{};
+
+static thread_local int tParallelForDepth{};
+
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::ThreadPool
+//------------------------------------------------------------------------
+ThreadPool::ThreadPool(unsigned int iNumThreads)
+{
+  iNumThreads = std::max(iNumThreads, 1u);
+
+  // all workers must exist before any of them starts stealing
+  for(unsigned int i = 0; i < iNumThreads; i++)
+    fWorkers.emplace_back(std::make_unique<Worker>());
+
+  for(std::size_t i = 0; i < fWorkers.size(); i++)
+    fWorkers[i]->fThread = std::thread([this, i] { run(i); });
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::~ThreadPool
+//------------------------------------------------------------------------
+ThreadPool::~ThreadPool()
+{
+  shutdown();
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::shutdown
+//------------------------------------------------------------------------
+void ThreadPool::shutdown()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if(fStopped)
+      return;
+    fStopped = true;
+  }
+  fCondition.notify_all();
+
+  // the workers only exit once there is nothing left to do
+  for(auto &worker: fWorkers)
+  {
+    if(worker->fThread.joinable())
+      worker->fThread.join();
+  }
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::GetDefault
+//------------------------------------------------------------------------
+ThreadPool &ThreadPool::GetDefault()
+{
+  // leaves one core for the UI thread
+  static ThreadPool kDefault{std::max(std::thread::hardware_concurrency(), 3u) - 1};
+  return kDefault;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::currentWorker
+//------------------------------------------------------------------------
+ThreadPool::Worker *ThreadPool::currentWorker() const
+{
+  if(impl::tCurrentWorker.fPool == this)
+    return fWorkers[impl::tCurrentWorker.fIndex].get();
+  return nullptr;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::parallelForDepth
+//------------------------------------------------------------------------
+int &ThreadPool::parallelForDepth()
+{
+  return impl::tParallelForDepth;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::push
+//------------------------------------------------------------------------
+void ThreadPool::push(Priority iPriority, task_t iTask)
+{
+  auto const priority = static_cast<std::size_t>(iPriority);
+
+  {
+    // counted before being queued (so that it never goes below the number of queued tasks) and under the lock so
+    // that a worker about to sleep cannot miss it
+    std::unique_lock<std::mutex> lock(fMutex);
+    if(fStopped && !currentWorker())
+    {
+      // the workers may be gone (or about to exit) => nobody would run it
+      lock.unlock();
+      execute(iTask);
+      return;
+    }
+    fPendingCount++;
+  }
+
+  if(auto worker = currentWorker())
+  {
+    std::lock_guard<std::mutex> lock(worker->fMutex);
+    worker->fQueues[priority].emplace_back(std::move(iTask));
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fQueues[priority].emplace_back(std::move(iTask));
+  }
+
+  fCondition.notify_one();
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::pop
+//------------------------------------------------------------------------
+bool ThreadPool::pop(Priority iMinPriority, task_t &oTask)
+{
+  auto const maxPriority = static_cast<std::size_t>(iMinPriority);
+  auto const self = currentWorker();
+
+  auto take = [this, &oTask](std::deque<task_t> &iQueue, bool iBack) {
+    if(iQueue.empty())
+      return false;
+    if(iBack)
+    {
+      oTask = std::move(iQueue.back());
+      iQueue.pop_back();
+    }
+    else
+    {
+      oTask = std::move(iQueue.front());
+      iQueue.pop_front();
+    }
+    fPendingCount--;
+    return true;
+  };
+
+  for(std::size_t priority = 0; priority <= maxPriority; priority++)
+  {
+    // 1. own queue (most recent first: it is most likely still hot in the cache)
+    if(self)
+    {
+      std::lock_guard<std::mutex> lock(self->fMutex);
+      if(take(self->fQueues[priority], true))
+        return true;
+    }
+
+    // 2. shared queue
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if(take(fQueues[priority], false))
+        return true;
+    }
+
+    // 3. steal (oldest first)
+    for(auto &worker: fWorkers)
+    {
+      if(worker.get() == self)
+        continue;
+      std::lock_guard<std::mutex> lock(worker->fMutex);
+      if(take(worker->fQueues[priority], false))
+        return true;
+    }
+  }
+
+  return false;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::execute
+//------------------------------------------------------------------------
+void ThreadPool::execute(task_t const &iTask) noexcept
+{
+  try
+  {
+    iTask();
+  }
+  catch(std::exception const &e)
+  {
+    RE_EDIT_LOG_WARNING("Error while executing task: %s", e.what());
+  }
+  catch(...)
+  {
+    RE_EDIT_LOG_WARNING("Unknown error while executing task");
+  }
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::post
+//------------------------------------------------------------------------
+void ThreadPool::post(Priority iPriority, task_t iTask)
+{
+  push(iPriority, std::move(iTask));
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::runPendingTask
+//------------------------------------------------------------------------
+bool ThreadPool::runPendingTask(Priority iMinPriority)
+{
+  task_t task{};
+  if(!pop(iMinPriority, task))
+    return false;
+  execute(task);
+  return true;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::run
+//------------------------------------------------------------------------
+void ThreadPool::run(std::size_t iWorkerIndex)
+{
+  impl::tCurrentWorker = {this, iWorkerIndex};
+
+  while(true)
+  {
+    task_t task{};
+    if(pop(Priority::kBackground, task))
+    {
+      execute(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    fCondition.wait(lock, [this] { return fStopped || fPendingCount > 0; });
+    // when stopped, keeps going until all the queued tasks have been processed
+    if(fStopped && fPendingCount == 0)
+      return;
+  }
+}
+
+}
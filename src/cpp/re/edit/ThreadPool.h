@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_THREAD_POOL_H
+#define RE_EDIT_THREAD_POOL_H
+
+#include "Utils.h"
+#include "UIContext.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace re::edit {
+
+/**
+ * Process wide pool of worker threads shared by all background work (texture decoding, effects, project loading,
+ * update checks...) so that the number of threads stays bounded.
+ *
+ * Each worker owns a queue (per priority): tasks submitted from a worker go to its own queue (and are processed
+ * LIFO by this worker), tasks submitted from any other thread go to a shared queue, and an idle worker steals from
+ * the other workers. Higher priority tasks are always picked first.
+ *
+ * A thread waiting on work submitted to the pool should use `runPendingTask` (like `TaskGraph` does) instead of
+ * simply blocking, so that waiting from a worker can never exhaust the pool. `parallelFor` does not need to: the
+ * calling thread processes the indices itself and only waits for the ones already being processed. */
+class ThreadPool
+{
+public:
+  enum class Priority : int
+  {
+    kInteractive = 0,
+    kLoad = 1,
+    kBackground = 2
+  };
+
+  using task_t = std::function<void()>;
+
+  static constexpr std::size_t kPriorityCount = 3;
+
+public:
+  explicit ThreadPool(unsigned int iNumThreads);
+  ~ThreadPool();
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+
+  static ThreadPool &GetDefault();
+
+  /**
+   * Stops accepting work: the workers complete all the queued tasks (including the ones submitted while draining)
+   * then exit and are joined. Tasks submitted after this call are executed synchronously by the calling thread.
+   *
+   * Must be called before destroying what the tasks may use (since the default pool is a static, it outlives
+   * `main`). Calling it more than once is a no-op. */
+  void shutdown();
+
+  inline std::size_t numThreads() const { return fWorkers.size(); }
+
+  /**
+   * Fire and forget: exceptions thrown by `iTask` are logged */
+  void post(Priority iPriority, task_t iTask);
+
+  /**
+   * @return a future holding the result (or the exception) of `f()` */
+  template<typename F>
+  auto submit(Priority iPriority, F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+  /**
+   * Same as `submit` but `f` is skipped (and the future holds `Utils::Cancellable::cancelled_t`) if `iCancellable`
+   * is cancelled before the task starts. `f` is expected to check `iCancellable` while running (cooperative). */
+  template<typename F>
+  auto submit(Priority iPriority, Utils::CancellableSPtr iCancellable, F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+  /**
+   * Runs `f()` in the pool then `iContinuation(result)` on the UI thread (through `UIContext::execute`) where
+   * `result` is a (ready) `std::shared_future` so that exceptions are handled by the continuation.
+   *
+   * @return a future which completes when `f()` completes (the continuation may not have run yet) */
+  template<typename F, typename C>
+  std::future<void> submitThenOnUIThread(Priority iPriority, UIContext &iUIContext, F &&f, C &&iContinuation);
+
+  /**
+   * Calls `iFunction(i)` for `i` in `[0, iCount)` in the pool (the calling thread participates) and waits for
+   * completion. Nested calls (made, directly or not, from any `iFunction` running on the current thread) run
+   * serially. The first exception thrown is rethrown. */
+  template<typename F>
+  void parallelFor(Priority iPriority, int iCount, F const &iFunction);
+
+  /**
+   * Runs (on the calling thread) one pending task with a priority at least `iMinPriority` if there is one.
+   *
+   * @return `true` if a task was run */
+  bool runPendingTask(Priority iMinPriority = Priority::kBackground);
+
+  /**
+   * @return the number of tasks waiting to be picked up */
+  inline std::size_t pendingCount() const { return fPendingCount; }
+
+private:
+  using Queues = std::array<std::deque<task_t>, kPriorityCount>;
+
+  struct Worker
+  {
+    std::mutex fMutex{};
+    Queues fQueues{};
+    std::thread fThread{};
+  };
+
+  void run(std::size_t iWorkerIndex);
+  void push(Priority iPriority, task_t iTask);
+  bool pop(Priority iMinPriority, task_t &oTask);
+  Worker *currentWorker() const;
+
+  static void execute(task_t const &iTask) noexcept;
+
+  //! Number of `parallelFor` functions being executed by the current thread (shared by all instantiations)
+  static int &parallelForDepth();
+
+private:
+  std::vector<std::unique_ptr<Worker>> fWorkers{};
+
+  mutable std::mutex fMutex{};
+  std::condition_variable fCondition{};
+  Queues fQueues{};
+  std::atomic<std::size_t> fPendingCount{};
+  bool fStopped{};
+};
+
+//------------------------------------------------------------------------
+// ThreadPool::submit
+//------------------------------------------------------------------------
+template<typename F>
+auto ThreadPool::submit(Priority iPriority, F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+{
+  using result_t = std::invoke_result_t<std::decay_t<F>>;
+
+  // std::function requires a copyable callable
+  auto task = std::make_shared<std::packaged_task<result_t()>>(std::forward<F>(f));
+  auto future = task->get_future();
+  push(iPriority, [task] { (*task)(); });
+  return future;
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::submit
+//------------------------------------------------------------------------
+template<typename F>
+auto ThreadPool::submit(Priority iPriority, Utils::CancellableSPtr iCancellable, F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+{
+  return submit(iPriority, [cancellable = std::move(iCancellable), f = std::forward<F>(f)]() mutable {
+    if(cancellable && cancellable->cancelled())
+      throw Utils::Cancellable::cancelled_t();
+    return f();
+  });
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::submitThenOnUIThread
+//------------------------------------------------------------------------
+template<typename F, typename C>
+std::future<void> ThreadPool::submitThenOnUIThread(Priority iPriority, UIContext &iUIContext, F &&f, C &&iContinuation)
+{
+  return submit(iPriority, [uiContext = &iUIContext, f = std::forward<F>(f), continuation = std::forward<C>(iContinuation)]() mutable {
+    using result_t = std::invoke_result_t<decltype(f)>;
+    std::packaged_task<result_t()> task{std::move(f)};
+    std::shared_future<result_t> result = task.get_future().share();
+    task();
+    uiContext->execute([continuation = std::move(continuation), result]() mutable { continuation(result); });
+  });
+}
+
+//------------------------------------------------------------------------
+// ThreadPool::parallelFor
+//------------------------------------------------------------------------
+template<typename F>
+void ThreadPool::parallelFor(Priority iPriority, int iCount, F const &iFunction)
+{
+  auto const numTasks = std::min(static_cast<int>(numThreads()) + 1, iCount);
+
+  if(parallelForDepth() > 0 || numTasks <= 1)
+  {
+    for(int i = 0; i < iCount; i++)
+      iFunction(i);
+    return;
+  }
+
+  // the helpers may start after this call returns (when all the work has already been done) => shared state
+  struct State
+  {
+    std::atomic<int> fNext{0};
+    std::mutex fMutex{};
+    std::condition_variable fCondition{};
+    int fDone{};
+    std::exception_ptr fError{};
+  };
+
+  auto state = std::make_shared<State>();
+
+  // note that iFunction is only accessed while some work remains => it is still valid
+  auto worker = [state, iCount, function = &iFunction] {
+    parallelForDepth()++;
+    auto deferred = Utils::defer([] { parallelForDepth()--; });
+    for(auto i = state->fNext++; i < iCount; i = state->fNext++)
+    {
+      std::exception_ptr error{};
+      try
+      {
+        (*function)(i);
+      }
+      catch(...)
+      {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(state->fMutex);
+      if(error && !state->fError)
+        state->fError = error;
+      if(++state->fDone == iCount)
+        state->fCondition.notify_all();
+    }
+  };
+
+  for(int i = 1; i < numTasks; i++)
+    push(iPriority, worker);
+
+  worker();
+
+  std::unique_lock<std::mutex> lock(state->fMutex);
+  // all indices have been claimed at this point => only waiting on the ones being processed
+  state->fCondition.wait(lock, [&state, iCount] { return state->fDone == iCount; });
+
+  if(state->fError)
+    std::rethrow_exception(state->fError);
+}
+
+}
+
+#endif //RE_EDIT_THREAD_POOL_H
@@ -19,6 +19,9 @@
 #include "UIContext.h"
 #include <imgui.h>
 #include <raylib.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
 
 namespace re::edit {
 
@@ -85,11 +88,24 @@ void UIContext::execute(ui_action_t iAction)
     iAction();
   else
   {
-    std::lock_guard<std::mutex> lock(fMutex);
-    fUIActions.emplace_back(std::move(iAction));
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fUIActions.emplace_back(std::move(iAction));
+    }
+    if(fWakeUpHandler)
+      fWakeUpHandler();
   }
 }
 
+//------------------------------------------------------------------------
+// UIContext::hasUIActions
+//------------------------------------------------------------------------
+bool UIContext::hasUIActions() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return !fUIActions.empty();
+}
+
 
 //------------------------------------------------------------------------
 // UIContext::collectUIActions
@@ -100,6 +116,60 @@ std::vector<UIContext::ui_action_t> UIContext::collectUIActions()
   return std::move(fUIActions);
 }
 
+//------------------------------------------------------------------------
+// UIContext::enqueueGPUUpload
+//------------------------------------------------------------------------
+void UIContext::enqueueGPUUpload(std::shared_ptr<GPUUpload> iUpload)
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fEnqueuedGPUUploads.emplace_back(std::move(iUpload));
+  }
+  if(std::this_thread::get_id() != fUIThreadId && fWakeUpHandler)
+    fWakeUpHandler();
+}
+
+//------------------------------------------------------------------------
+// UIContext::processGPUUploads
+//------------------------------------------------------------------------
+void UIContext::processGPUUploads(float iBudgetMs)
+{
+  RE_EDIT_INTERNAL_ASSERT(std::this_thread::get_id() == fUIThreadId);
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    std::move(fEnqueuedGPUUploads.begin(), fEnqueuedGPUUploads.end(), std::back_inserter(fGPUUploads));
+    fEnqueuedGPUUploads.clear();
+  }
+
+  if(fGPUUploads.empty())
+    return;
+
+  // visible first (otherwise in order)
+  std::stable_partition(fGPUUploads.begin(), fGPUUploads.end(), [](auto const &u) { return u->isVisible(); });
+
+  auto const start = std::chrono::steady_clock::now();
+  auto const budget = std::chrono::duration<float, std::milli>(iBudgetMs);
+
+  while(!fGPUUploads.empty())
+  {
+    if(!fGPUUploads.front()->uploadNextStep())
+      fGPUUploads.pop_front();
+
+    if(iBudgetMs > 0 && std::chrono::steady_clock::now() - start >= budget)
+      break;
+  }
+}
+
+//------------------------------------------------------------------------
+// UIContext::getGPUUploadQueueDepth
+//------------------------------------------------------------------------
+std::size_t UIContext::getGPUUploadQueueDepth() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fEnqueuedGPUUploads.size() + fGPUUploads.size();
+}
+
 //------------------------------------------------------------------------
 // UIContext::beginFXShader
 //------------------------------------------------------------------------
@@ -20,7 +20,9 @@
 #define RE_EDIT_UI_CONTEXT_H
 
 #include "Errors.h"
+#include <deque>
 #include <functional>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <thread>
@@ -30,11 +32,28 @@ struct Shader;
 
 namespace re::edit {
 
+class RLDrawList;
+
 class UIContext
 {
 public:
   using ui_action_t = std::function<void()>;
 
+  /**
+   * A (potentially large) upload to the GPU performed in small steps so that it can be spread over several frames
+   * (see `processGPUUploads`) */
+  class GPUUpload
+  {
+  public:
+    virtual ~GPUUpload() = default;
+
+    //! Visible uploads are processed first
+    virtual bool isVisible() const = 0;
+
+    //! Performs the next step of the upload (from the UI thread). Returns `false` when there is nothing left to do.
+    virtual bool uploadNextStep() = 0;
+  };
+
 public:
   explicit UIContext(int iMaxTextureSize, std::thread::id iUIThreadId = std::this_thread::get_id());
 
@@ -48,12 +67,35 @@ public:
    * synchronously. Otherwise, the action is enqueued and will be executed on the UI thread in the next frame loop. */
   void execute(ui_action_t iAction);
 
-  inline bool hasUIActions() const { return !fUIActions.empty(); }
+  bool hasUIActions() const;
   std::vector<ui_action_t> collectUIActions();
 
+  /**
+   * Invoked (from the calling thread) when an action or upload is enqueued from a thread other than the UI thread
+   * so that a UI thread blocked waiting for events can wake up. */
+  inline void setWakeUpHandler(std::function<void()> iHandler) { fWakeUpHandler = std::move(iHandler); }
+
+  /**
+   * Enqueues an upload which will be processed by `processGPUUploads`. Can be called from any thread. */
+  void enqueueGPUUpload(std::shared_ptr<GPUUpload> iUpload);
+
+  /**
+   * Processes the queued uploads (visible ones first) until `iBudgetMs` is exhausted (0 means no budget). At least
+   * one step is always performed so that the queue keeps making progress. Must be called from the UI thread. */
+  void processGPUUploads(float iBudgetMs);
+
+  //! Number of uploads waiting to be processed or in progress
+  std::size_t getGPUUploadQueueDepth() const;
+
   void beginFXShader(ImVec4 const &iTint, float iBrightness, float iContrast);
   void endFXShader();
 
+  /**
+   * While set, the textures drawn with raylib (`Texture::draw`) are recorded in this draw list (to be batched when
+   * flushed) instead of being drawn right away */
+  inline void setRLDrawList(RLDrawList *iDrawList) { fRLDrawList = iDrawList; }
+  inline RLDrawList *getRLDrawList() const { return fRLDrawList; }
+
   constexpr int maxTextureSize() const { return fMaxTextureSize; }
 
   inline static UIContext *kCurrent{};
@@ -82,7 +124,11 @@ private:
   int fShaderTintLocation{};
   int fShaderBrightnessLocation{};
   int fShaderContrastLocation{};
+  RLDrawList *fRLDrawList{};
   std::vector<ui_action_t> fUIActions{};
+  std::function<void()> fWakeUpHandler{};
+  std::vector<std::shared_ptr<GPUUpload>> fEnqueuedGPUUploads{};
+  std::deque<std::shared_ptr<GPUUpload>> fGPUUploads{};
 };
 
 }
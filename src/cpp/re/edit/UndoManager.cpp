@@ -60,7 +60,9 @@ void UndoManager::addOrMerge(std::unique_ptr<Action> iAction)
     auto last = getLastUndoAction();
     if(last && last->fMergeKey == iAction->getMergeKey())
     {
+      untrack(last);
       iAction = last->merge(std::move(iAction));
+      track(last);
       if(iAction)
       {
         if(dynamic_cast<NoOpAction *>(iAction.get()))
@@ -108,11 +110,88 @@ void UndoManager::addAction(std::unique_ptr<Action> iAction)
   auto last = stl::last(fUndoHistory);
   if(last)
     last->resetMergeKey();
+  track(iAction.get());
   fUndoHistory.emplace_back(std::move(iAction));
 
+  for(auto const &action: fRedoHistory)
+    untrack(action.get());
   fRedoHistory.clear();
 }
 
+//------------------------------------------------------------------------
+// UndoManager::track
+//------------------------------------------------------------------------
+void UndoManager::track(Action *iAction)
+{
+  // Implementation note: the size is remembered as what an action holds on to changes (ex: a deleted widget moves
+  // back to the panel on undo) => it is computed again whenever the action moves between histories or is merged
+  iAction->fTrackedMemorySize = iAction->getMemorySize();
+  fMemorySize += iAction->fTrackedMemorySize;
+  fMemorySizeStale = true;
+}
+
+//------------------------------------------------------------------------
+// UndoManager::untrack
+//------------------------------------------------------------------------
+void UndoManager::untrack(Action const *iAction)
+{
+  fMemorySize -= std::min(fMemorySize, iAction->fTrackedMemorySize);
+}
+
+//------------------------------------------------------------------------
+// UndoManager::remeasure
+//------------------------------------------------------------------------
+void UndoManager::remeasure()
+{
+  fMemorySize = 0;
+  for(auto const &action: fUndoHistory)
+    track(action.get());
+  for(auto const &action: fRedoHistory)
+    track(action.get());
+  fMemorySizeStale = false;
+}
+
+//------------------------------------------------------------------------
+// UndoManager::enforceHistoryLimits
+//------------------------------------------------------------------------
+void UndoManager::enforceHistoryLimits(int iMaxCount, std::size_t iMaxMemorySize)
+{
+  // the values shared between the actions and the widgets (stl::cow) are counted in proportion of their copies at the
+  // time an action is tracked: any change since then (always recorded as an action) may have changed the shares
+  if(iMaxMemorySize > 0 && fMemorySizeStale)
+    remeasure();
+
+  auto count = fUndoHistory.size() + fRedoHistory.size();
+
+  auto isOverLimits = [this, &count, iMaxCount, iMaxMemorySize] {
+    return (iMaxCount > 0 && count > static_cast<std::size_t>(iMaxCount)) ||
+           (iMaxMemorySize > 0 && fMemorySize > iMaxMemorySize);
+  };
+
+  if(!isOverLimits())
+    return;
+
+  // oldest first
+  auto iter = fUndoHistory.begin();
+  while(isOverLimits() && fUndoHistory.end() - iter > 1)
+  {
+    untrack(iter->get());
+    iter++;
+    count--;
+  }
+  fUndoHistory.erase(fUndoHistory.begin(), iter);
+
+  // then the redo actions furthest from the current state (the last one is the next to redo)
+  iter = fRedoHistory.begin();
+  while(isOverLimits() && iter != fRedoHistory.end())
+  {
+    untrack(iter->get());
+    iter++;
+    count--;
+  }
+  fRedoHistory.erase(fRedoHistory.begin(), iter);
+}
+
 //------------------------------------------------------------------------
 // UndoManager::undoLastAction
 //------------------------------------------------------------------------
@@ -123,6 +202,7 @@ void UndoManager::undoLastAction()
   {
     action->resetMergeKey();
     action->undo();
+    track(action.get());
     fRedoHistory.emplace_back(std::move(action));
   }
 }
@@ -135,7 +215,9 @@ void UndoManager::redoLastAction()
   auto action = stl::popLastOrDefault(fRedoHistory);
   if(action)
   {
+    untrack(action.get());
     action->redo();
+    track(action.get());
     fUndoHistory.emplace_back(std::move(action));
   }
 }
@@ -164,7 +246,10 @@ std::unique_ptr<Action> UndoManager::popLastUndoAction()
   if(!isEnabled())
     return nullptr;
 
-  return stl::popLastOrDefault(fUndoHistory);
+  auto action = stl::popLastOrDefault(fUndoHistory);
+  if(action)
+    untrack(action.get());
+  return action;
 }
 
 //------------------------------------------------------------------------
@@ -174,6 +259,7 @@ void UndoManager::clear()
 {
   fUndoHistory.clear();
   fRedoHistory.clear();
+  fMemorySize = 0;
 }
 
 //------------------------------------------------------------------------
@@ -293,6 +379,17 @@ std::unique_ptr<Action> Action::merge(std::unique_ptr<Action> iAction)
   return doMerge(std::move(iAction));
 }
 
+//------------------------------------------------------------------------
+// CompositeAction::getMemorySize
+//------------------------------------------------------------------------
+std::size_t CompositeAction::getMemorySize() const
+{
+  auto res = sizeof(*this) + fDescription.capacity() + fActions.capacity() * sizeof(std::unique_ptr<Action>);
+  for(auto const &action: fActions)
+    res += action->getMemorySize();
+  return res;
+}
+
 //------------------------------------------------------------------------
 // CompositeAction::undo
 //------------------------------------------------------------------------
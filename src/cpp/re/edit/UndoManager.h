@@ -19,6 +19,7 @@
 #ifndef RE_EDIT_UNDO_MANAGER_H
 #define RE_EDIT_UNDO_MANAGER_H
 
+#include <atomic>
 #include <string>
 #include <functional>
 #include <vector>
@@ -29,15 +30,18 @@ namespace re::edit {
 
 struct MergeKey {
   void *fKey{};
+  int fIndex{};
 
-  constexpr void reset() { fKey = nullptr; }
+  constexpr void reset() { fKey = nullptr; fIndex = 0; }
   constexpr bool empty() const { return fKey == nullptr; }
 
-  constexpr bool operator==(MergeKey const &rhs) const { return fKey == rhs.fKey; }
+  constexpr bool operator==(MergeKey const &rhs) const { return fKey == rhs.fKey && fIndex == rhs.fIndex; }
   constexpr bool operator!=(MergeKey const &rhs) const { return !(rhs == *this); }
 
   constexpr static MergeKey none() { return {}; }
   constexpr static MergeKey from(void *iKey) { return { iKey }; }
+  //! For an element of a list owned by `iKey` (the address of the element itself may change)
+  constexpr static MergeKey from(void *iKey, int iIndex) { return { iKey, iIndex }; }
 };
 
 class Action
@@ -55,6 +59,14 @@ public:
   std::string const &getDescription() const { return fDescription; }
   void setDescription(std::string iDescription) { fDescription = std::move(iDescription); }
 
+  //! Unique (never reused) id of this action
+  inline long getId() const { return fId; }
+
+  /**
+   * Approximate memory used by this action, including what it holds on to (values, widgets...). Subclasses holding
+   * on to more than a few fields should override. */
+  virtual std::size_t getMemorySize() const { return sizeof(Action) + fDescription.capacity(); }
+
 protected:
   virtual bool canMergeWith(Action const *iAction) const { return false; }
 
@@ -68,6 +80,14 @@ protected:
 public:
   std::string fDescription{};
   MergeKey fMergeKey{};
+
+private:
+  long fId{fActionIota++};
+  std::size_t fTrackedMemorySize{}; // see UndoManager
+
+  static inline std::atomic<long> fActionIota{1}; // actions can be created from any thread
+
+  friend class UndoManager;
 };
 
 class NoOpAction : public Action
@@ -89,6 +109,8 @@ public:
 
   std::vector<std::unique_ptr<Action>> const &getActions() const { return fActions; }
 
+  std::size_t getMemorySize() const override;
+
 protected:
   std::vector<std::unique_ptr<Action>> fActions{};
 };
@@ -156,6 +178,11 @@ public:
   T const &getValue() const { return fValue; }
   T const &getPreviousValue() const { return fValue; }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) - 2 * sizeof(T) + this->fDescription.capacity() + stl::memorySize(fValue) + stl::memorySize(fPreviousValue);
+  }
+
 protected:
 
   virtual void updateDescriptionOnSuccessfulMerge() {}
@@ -218,6 +245,15 @@ public:
   std::vector<std::unique_ptr<Action>> const &getRedoHistory() const { return fRedoHistory; }
   void clear();
 
+  //! Approximate memory used by the undo and redo histories (values shared with other copies are counted in part)
+  inline std::size_t getMemorySize() const { return fMemorySize; }
+
+  /**
+   * Drops the oldest undo actions, then the redo actions furthest from the current state, while there are more
+   * than `iMaxCount` actions (undo and redo) or they use more than `iMaxMemorySize` bytes (0 means no limit).
+   * The most recent undo action is always kept. */
+  void enforceHistoryLimits(int iMaxCount, std::size_t iMaxMemorySize);
+
   template<typename R, typename A = Action>
   R execute(std::unique_ptr<ExecutableAction<R, A>> iAction);
 
@@ -230,6 +266,10 @@ public:
 protected:
   void addAction(std::unique_ptr<Action> iAction);
 
+  void track(Action *iAction);
+  void untrack(Action const *iAction);
+  void remeasure();
+
 private:
   bool fEnabled{true};
   std::unique_ptr<UndoTx> fUndoTx{};
@@ -237,6 +277,8 @@ private:
   std::optional<std::string> fNextUndoActionDescription{};
   std::vector<std::unique_ptr<Action>> fUndoHistory{};
   std::vector<std::unique_ptr<Action>> fRedoHistory{};
+  std::size_t fMemorySize{};
+  bool fMemorySizeStale{}; // see enforceHistoryLimits
 };
 
 //------------------------------------------------------------------------
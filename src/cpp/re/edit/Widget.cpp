@@ -49,35 +49,15 @@ Widget::Widget(Widget const &iOther) :
   fType(iOther.fType),
   fName(iOther.fName)
 {
+  fAttributes.reserve(iOther.fAttributes.size());
   for(auto &attribute: iOther.fAttributes)
-  {
-    auto newAttribute = attribute->clone();
-    auto graphics = dynamic_cast<widget::attribute::Graphics *>(newAttribute.get());
-    if(graphics)
-    {
-#if __clang__
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "LocalValueEscapesScope"
-#endif
-      fGraphics = graphics;
-#if __clang__
-#pragma clang diagnostic pop
-#endif
-    }
-    auto visibility = dynamic_cast<widget::attribute::Visibility *>(newAttribute.get());
-    if(visibility)
-    {
-#if __clang__
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "LocalValueEscapesScope"
-#endif
-      fVisibilityAttribute = visibility;
-#if __clang__
-#pragma clang diagnostic pop
-#endif
-    }
-    addAttribute(std::move(newAttribute));
-  }
+    addAttribute(attribute->clone());
+
+  // same layout => same ids
+  if(iOther.fGraphics)
+    fGraphics = findAttributeByIdAndType<widget::attribute::Graphics>(iOther.fGraphics->fId);
+  if(iOther.fVisibilityAttribute)
+    fVisibilityAttribute = findAttributeByIdAndType<widget::attribute::Visibility>(iOther.fVisibilityAttribute->fId);
 }
 
 //------------------------------------------------------------------------
@@ -215,6 +195,19 @@ bool Widget::checkForErrors(AppContext &iCtx)
   return hasErrors();
 }
 
+//------------------------------------------------------------------------
+// Widget::commitEditedName
+//------------------------------------------------------------------------
+void Widget::commitEditedName()
+{
+  if(fEditedName)
+  {
+    if(*fEditedName != fName.str())
+      setName(*fEditedName);
+    fEditedName = std::nullopt;
+  }
+}
+
 //------------------------------------------------------------------------
 // Widget::editView
 //------------------------------------------------------------------------
@@ -222,8 +215,8 @@ void Widget::editView(AppContext &iCtx)
 {
   ImGui::PushID("Widget");
 
-  auto editedHashedName = fName;
-  std::string editedName = editedHashedName.value();
+  if(!fEditedName)
+    fEditedName = fName.str();
 
   ImGui::PushID("ResetName");
   if(ReGui::ResetButton())
@@ -234,10 +227,13 @@ void Widget::editView(AppContext &iCtx)
 
   ImGui::SameLine();
 
-  if(ImGui::InputText("name", &editedName))
-  {
-    setName(editedName);
-  }
+  ImGui::InputText("name", &*fEditedName);
+
+  // the name is only set (and interned, see Symbol) once done editing, not for each character typed
+  if(ImGui::IsItemDeactivatedAfterEdit())
+    commitEditedName();
+  else if(!ImGui::IsItemActive())
+    fEditedName = std::nullopt;
 
   fGraphics->editPositionView(iCtx);
 
@@ -282,56 +278,41 @@ void Widget::editView(AppContext &iCtx)
 //------------------------------------------------------------------------
 std::string Widget::hdgui2D() const
 {
-  if(isPanelDecal())
-    return "";
-
-  attribute_list_t atts{};
-
-  for(auto &att: fAttributes)
-    att->hdgui2D(atts);
-
-  std::vector<std::string> l{};
-  std::transform(atts.begin(), atts.end(), std::back_inserter(l), [](auto &att) {
-    return re::mock::fmt::printf("  %s = %s", att.fName, att.fValue);
-  });
-
-  return re::mock::fmt::printf("jbox.%s {\n%s\n}", toString(fType), re::mock::stl::join_to_string(l, ",\n"));
+  lua::Writer writer{};
+  hdgui2D(writer);
+  return writer.release();
 }
 
 //------------------------------------------------------------------------
-// Widget::collectUsedTexturePaths
+// Widget::hdgui2D
 //------------------------------------------------------------------------
-void Widget::collectUsedTexturePaths(std::set<fs::path> &oPaths) const
+void Widget::hdgui2D(lua::Writer &oWriter) const
 {
-  for(auto &att: fAttributes)
-    att->collectUsedTexturePaths(oPaths);
-}
+  if(isPanelDecal())
+    return;
 
-//------------------------------------------------------------------------
-// Widget::collectAllUsedTextureKeys
-//------------------------------------------------------------------------
-void Widget::collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const
-{
-  for(auto &att: fAttributes)
-    att->collectAllUsedTextureKeys(oKeys);
-}
+  attribute_list_t atts{};
 
-//------------------------------------------------------------------------
-// Widget::collectFilmStripEffects
-//------------------------------------------------------------------------
-void Widget::collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const
-{
   for(auto &att: fAttributes)
-    att->collectFilmStripEffects(oEffects);
+    att->hdgui2D(atts);
+
+  oWriter.printf("jbox.%s {\n", toString(fType));
+  for(auto i = atts.begin(); i != atts.end(); i++)
+  {
+    if(i != atts.begin())
+      oWriter << ",\n";
+    oWriter << "  " << i->fName << " = " << i->fValue;
+  }
+  oWriter << "\n}";
 }
 
 //------------------------------------------------------------------------
-// Widget::hdgui2D
+// Widget::collectTextureSources
 //------------------------------------------------------------------------
-void Widget::collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const
+void Widget::collectTextureSources(TextureReferences::sources_t &oSources) const
 {
   for(auto &att: fAttributes)
-    att->collectUsedTextureBuiltIns(oKeys);
+    att->collectTextureSources(oSources);
 }
 
 //------------------------------------------------------------------------
@@ -652,7 +633,7 @@ std::unique_ptr<Widget> Widget::momentary_button(std::optional<std::string> cons
     return (p.type() == Property::Type::kBoolean || p.isDiscrete()) && kDocGuiOwnerFilter(p);
   }, "Must be a discrete (stepped) number or boolean property (document_owner or gui_owner)"};
 
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &iFilmStrip) { return iFilmStrip.numFrames() == 2; },
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &iMetadata) { return iMetadata.numFrames() == 2; },
                                                  "Must have exactly 2 frames"};
 
   auto w = std::make_unique<Widget>(WidgetType::kMomentaryButton, iName);
@@ -759,7 +740,7 @@ std::unique_ptr<Widget> Widget::radio_button(std::optional<std::string> const &i
     return (p.type() == Property::Type::kBoolean || p.isDiscrete()) && kDocGuiOwnerFilter(p);
   }, "Must be a discrete (stepped) number or boolean property (document_owner or gui_owner)"};
 
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &f) { return f.numFrames() == 2; }, "Must have exactly 2 frames"};
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &f) { return f.numFrames() == 2; }, "Must have exactly 2 frames"};
 
   auto w = std::make_unique<Widget>(WidgetType::kRadioButton, iName);
   w ->value(kValueFilter)
@@ -853,7 +834,7 @@ std::unique_ptr<Widget> Widget::sequence_meter(std::optional<std::string> const
 std::unique_ptr<Widget> Widget::static_decoration(std::optional<std::string> const &iName)
 {
   // GUIDefValidation.GUIDefError: RE2DRender: Error in hdgui_2D.lua: Widget type 'static_decoration': Wrong number of frames (2)
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &f) { return f.numFrames() == 1; }, "Must have exactly 1 frame"};
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &f) { return f.numFrames() == 1; }, "Must have exactly 1 frame"};
 
   auto w = std::make_unique<Widget>(WidgetType::kStaticDecoration, iName);
   w ->blend_mode()
@@ -873,7 +854,7 @@ std::unique_ptr<Widget> Widget::step_button(std::optional<std::string> const &iN
     return (p.type() == Property::Type::kBoolean || p.isDiscrete()) && kDocGuiOwnerFilter(p);
   }, "Must be a discrete (stepped) number or boolean property (document_owner or gui_owner)"};
 
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &f) {
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &f) {
     return f.numFrames() == 2 || f.numFrames() == 4;
   }, "Must have 2 or 4 frame"};
 
@@ -900,7 +881,7 @@ std::unique_ptr<Widget> Widget::toggle_button(std::optional<std::string> const &
     return (p.type() == Property::Type::kBoolean || p.isDiscrete()) && kDocGuiOwnerFilter(p);
   }, "Must be a discrete (stepped) number or boolean property (document_owner or gui_owner)"};
 
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &f) {
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &f) {
     return f.numFrames() == 2 || f.numFrames() == 4;
   }, "Must have 2 or 4 frame"};
 
@@ -926,7 +907,7 @@ std::unique_ptr<Widget> Widget::up_down_button(std::optional<std::string> const
     return p.isDiscrete() && kDocGuiOwnerFilter(p);
   }, "Must be a discrete (stepped) number property (document_owner or gui_owner)"};
 
-  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip const &f) { return f.numFrames() == 3; }, "Must have exactly 3 frame"};
+  static const FilmStrip::Filter kGraphicsFilter{[](FilmStrip::Metadata const &f) { return f.numFrames() == 3; }, "Must have exactly 3 frame"};
 
   auto w = std::make_unique<Widget>(WidgetType::kUpDownButton, iName);
   w ->value(kValueFilter)
@@ -1030,6 +1011,17 @@ std::unique_ptr<Widget> Widget::fullClone() const
   return w;
 }
 
+//------------------------------------------------------------------------
+// Widget::getMemorySize
+//------------------------------------------------------------------------
+std::size_t Widget::getMemorySize() const
+{
+  auto res = sizeof(Widget) + fAttributes.capacity() * sizeof(std::unique_ptr<widget::Attribute>);
+  for(auto const &attribute: fAttributes)
+    res += attribute->getMemorySize();
+  return res;
+}
+
 //------------------------------------------------------------------------
 // Widget::copyFrom
 //------------------------------------------------------------------------
@@ -1041,7 +1033,7 @@ bool Widget::copyFrom(Widget const &iWidget)
   bool res = false;
   for(auto &att: fAttributes)
   {
-    auto otherAtt = iWidget.findAttributeByName(att->fName);
+    auto otherAtt = iWidget.findAttributeLike(att.get());
     if(otherAtt)
       res |= att->copyFrom(otherAtt);
   }
@@ -1062,7 +1054,7 @@ bool Widget::copyFromAction(Widget const &iWidget)
   bool res = false;
   for(auto &att: fAttributes)
   {
-    auto otherAtt = iWidget.findAttributeByName(att->fName);
+    auto otherAtt = iWidget.findAttributeLike(att.get());
     if(otherAtt)
       res |= att->copyFromAction(otherAtt);
   }
@@ -1078,7 +1070,7 @@ bool Widget::copyFromAction(Widget const &iWidget)
 //------------------------------------------------------------------------
 bool Widget::copyFrom(widget::Attribute const *iAttribute)
 {
-  auto att = findAttributeByName(iAttribute->fName);
+  auto att = findAttributeLike(iAttribute);
   if(att)
   {
     auto res = att->copyFrom(iAttribute);
@@ -1095,7 +1087,7 @@ bool Widget::copyFrom(widget::Attribute const *iAttribute)
 //------------------------------------------------------------------------
 bool Widget::copyFromAction(widget::Attribute const *iAttribute)
 {
-  auto att = findAttributeByName(iAttribute->fName);
+  auto att = findAttributeLike(iAttribute);
   if(att)
   {
     auto res = att->copyFromAction(iAttribute);
@@ -1175,7 +1167,7 @@ void Widget::renderVisibilityToggle(AppContext &iCtx)
 //------------------------------------------------------------------------
 // Widget::findAttributeByName
 //------------------------------------------------------------------------
-widget::Attribute *Widget::findAttributeByName(std::string const &iAttributeName) const
+widget::Attribute *Widget::findAttributeByName(std::string_view iAttributeName) const
 {
   auto iter = std::find_if(fAttributes.begin(), fAttributes.end(), [&iAttributeName](auto &a) { return a->fName == iAttributeName; });
   if(iter != fAttributes.end())
@@ -1184,6 +1176,21 @@ widget::Attribute *Widget::findAttributeByName(std::string const &iAttributeName
     return nullptr;
 }
 
+//------------------------------------------------------------------------
+// Widget::findAttributeLike
+//------------------------------------------------------------------------
+widget::Attribute *Widget::findAttributeLike(widget::Attribute const *iAttribute) const
+{
+  // widgets of the same type are built by the same factory => the attribute has the same id (and name)
+  if(iAttribute->fWidgetType == fType && iAttribute->fId >= 0 && iAttribute->fId < static_cast<int>(fAttributes.size()))
+  {
+    auto attribute = fAttributes[iAttribute->fId].get();
+    if(attribute->fName == iAttribute->fName)
+      return attribute;
+  }
+  return findAttributeByName(iAttribute->fName);
+}
+
 //------------------------------------------------------------------------
 // Widget::addAttribute
 //------------------------------------------------------------------------
@@ -1220,6 +1227,14 @@ void Widget::sortByName(std::vector<Widget *> &iWidgets)
 
 }
 
+//------------------------------------------------------------------------
+// Widget::isSortedByName
+//------------------------------------------------------------------------
+bool Widget::isSortedByName(std::vector<Widget *> const &iWidgets)
+{
+  return std::is_sorted(iWidgets.begin(), iWidgets.end(), re::edit::impl::sortByNameCompare);
+}
+
 //------------------------------------------------------------------------
 // Widget::selectByType
 //------------------------------------------------------------------------
@@ -27,8 +27,10 @@
 #include "Errors.h"
 #include "String.h"
 #include "Clipboard.h"
+#include "lua/Writer.h"
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <variant>
@@ -59,8 +61,8 @@ public:
 
   inline PanelType getPanelType() const { return fPanelType; }
 
-  inline std::string const &getName() const { return fName.value(); }
-  inline StringWithHash::hash_t getNameHash() const { return fName.hash(); }
+  inline std::string const &getName() const { return fName.str(); }
+  inline Symbol getNameSymbol() const { return fName; }
   void setName(const std::string& iName);
   constexpr int getId() const { return fId; }
   constexpr WidgetType getType() const { return fType; }
@@ -79,8 +81,8 @@ public:
   constexpr void setSelected(bool b) { fSelected = b; }
 
   constexpr bool isHidden() const { return fHidden; }
-  constexpr bool canBeShown() const { return fHidden && fVisibilityAttribute && !fVisibilityAttribute->fSwitch.fValue.empty() && !fVisibilityAttribute->fValues.fValue.empty(); }
-  constexpr bool hasVisibility() const { return fVisibilityAttribute && !fVisibilityAttribute->fSwitch.fValue.empty(); }
+  constexpr bool canBeShown() const { return fHidden && fVisibilityAttribute && !fVisibilityAttribute->fSwitch.fValue->empty() && !fVisibilityAttribute->fValues.fValue->empty(); }
+  constexpr bool hasVisibility() const { return fVisibilityAttribute && !fVisibilityAttribute->fSwitch.fValue->empty(); }
   constexpr bool hasVisibilityAttribute() const { return fVisibilityAttribute != nullptr; }
   bool hasVisibility(std::string const &iPropertyPath, int iPropertyValue) const;
   void setVisibility(widget::Visibility iVisibility);
@@ -98,10 +100,7 @@ public:
     fGraphics->initTextureKey(iTextureKey, iOriginalTextureKey, iEffects); fEdited |= fGraphics->isEdited();
   }
   inline void setSize(ImVec2 const &iSize) { fGraphics->setSize(iSize); fEdited |= fGraphics->isEdited(); }
-  void collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const;
-  void collectUsedTexturePaths(std::set<fs::path> &oPaths) const;
-  void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const;
-  void collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const;
+  void collectTextureSources(TextureReferences::sources_t &oSources) const;
 
   constexpr int getFrameNumber() const { return fGraphics->fFrameNumber; }
   constexpr int &getFrameNumber() { return fGraphics->fFrameNumber; }
@@ -113,6 +112,8 @@ public:
   void init(AppContext &iCtx);
   void draw(AppContext &iCtx, ReGui::Canvas &iCanvas);
   void editView(AppContext &iCtx);
+  //! Sets the name being edited in editView, if any (ex: when the widget is no longer shown before done editing)
+  void commitEditedName();
   void commitTextureEffects(AppContext &iCtx);
   bool checkForErrors(AppContext &iCtx) override;
   void markEdited() override;
@@ -120,11 +121,15 @@ public:
   void resetEdited() override;
 
   std::string hdgui2D() const;
+  void hdgui2D(lua::Writer &oWriter) const;
   std::string device2D() const { return fGraphics->device2D(); }
 
   std::unique_ptr<Widget> copy(std::string iName) const;
   std::unique_ptr<Widget> clone() const;
   std::unique_ptr<Widget> fullClone() const; // includes id/selected
+
+  //! Approximate memory used by this widget (including its attributes)
+  std::size_t getMemorySize() const;
 //  bool eq(Widget *iWidget) const;
   bool copyFrom(Widget const &iWidget);
   bool copyFrom(widget::Attribute const *iAttribute);
@@ -165,15 +170,18 @@ public:
   static std::unique_ptr<Widget> zero_snap_knob(std::optional<std::string> const &iName = std::nullopt);
 
   template<typename T>
-  T *findAttributeByNameAndType(std::string const &iAttributeName) const;
+  T *findAttributeByNameAndType(std::string_view iAttributeName) const;
 
   template<typename T>
   T *findAttributeByIdAndType(int id) const;
 
-  widget::Attribute *findAttributeByName(std::string const &iAttributeName) const;
+  widget::Attribute *findAttributeByName(std::string_view iAttributeName) const;
 
   widget::Attribute *findAttributeById(int id) const { return fAttributes[id].get(); }
 
+  //! @return the attribute of this widget matching `iAttribute` (same name) which may belong to another widget
+  widget::Attribute *findAttributeLike(widget::Attribute const *iAttribute) const;
+
 //
 //  template<typename T>
 //  typename T::value_t *findAttributeValue(std::string const &iAttributeName) const;
@@ -185,6 +193,7 @@ public:
   static void resetWidgetIota() { fWidgetIota = 1; }
 
   static void sortByName(std::vector<Widget *> &iWidgets);
+  static bool isSortedByName(std::vector<Widget *> const &iWidgets);
   static void selectByType(std::vector<Widget *> const &iWidgets, WidgetType iType, bool iIncludeHiddenWidgets);
 
   friend class Panel;
@@ -228,7 +237,8 @@ private:
   int fId{-1};
   PanelType fPanelType{PanelType::kUnknown};
   WidgetType fType{};
-  StringWithHash fName{};
+  Symbol fName{};
+  std::optional<std::string> fEditedName{}; // while the name is being edited (see editView)
   bool fSelected{};
   widget::Visibility fVisibility{widget::Visibility::kByProperty};
   bool fHidden{};
@@ -246,9 +256,10 @@ private:
 // Widget::findAttributeByNameAndType
 //------------------------------------------------------------------------
 template<typename T>
-T *Widget::findAttributeByNameAndType(std::string const &iAttributeName) const
+T *Widget::findAttributeByNameAndType(std::string_view iAttributeName) const
 {
-  return dynamic_cast<T *>(findAttributeByName(iAttributeName));
+  auto attribute = findAttributeByName(iAttributeName);
+  return attribute && attribute->isKindOf<T>() ? static_cast<T *>(attribute) : nullptr;
 }
 
 //------------------------------------------------------------------------
@@ -257,7 +268,8 @@ T *Widget::findAttributeByNameAndType(std::string const &iAttributeName) const
 template<typename T>
 T *Widget::findAttributeByIdAndType(int id) const
 {
-  return dynamic_cast<T *>(fAttributes[id].get());
+  auto attribute = fAttributes[id].get();
+  return attribute && attribute->isKindOf<T>() ? static_cast<T *>(attribute) : nullptr;
 }
 
 namespace clipboard {
@@ -43,6 +43,18 @@ public:
     return this->getPanel()->findWidget(fId);
   }
 
+  void execute() override
+  {
+    markWidgetChanged();
+    ValueAction<Widget, T, PanelAction>::execute();
+  }
+
+  void undo() override
+  {
+    markWidgetChanged();
+    ValueAction<Widget, T, PanelAction>::undo();
+  }
+
   void init(int iWidgetId,
             typename ValueAction<Widget, T>::update_function_t iUpdateFunction,
             T iValue,
@@ -64,6 +76,12 @@ protected:
     return false;
   }
 
+  void markWidgetChanged() const
+  {
+    this->markPanelModified();
+    this->getPanel()->markWidgetChanged(fId);
+  }
+
 protected:
   int fId{-1};
 };
@@ -123,8 +141,8 @@ void Widget::setPosition(ImVec2 const &iPosition)
 //------------------------------------------------------------------------
 std::string Widget::setNameAction(std::string iName)
 {
-  auto res = fName.value();
-  fName = StringWithHash(std::move(iName));
+  auto res = fName.str();
+  fName = Symbol{iName};
   fEdited = true;
   return res;
 }
@@ -168,10 +168,10 @@ std::string UIText::getValueAsLua() const
 //------------------------------------------------------------------------
 std::string PropertyPathList::getValueAsLua() const
 {
-  if(fValue.empty())
+  if(fValue->empty())
     return "{}";
   std::vector<std::string> l{};
-  std::transform(fValue.begin(), fValue.end(), std::back_inserter(l), escapeString);
+  std::transform(fValue->begin(), fValue->end(), std::back_inserter(l), escapeString);
   return re::mock::fmt::printf("{ %s }", re::mock::stl::join_to_string(l));
 }
 
@@ -180,10 +180,10 @@ std::string PropertyPathList::getValueAsLua() const
 //------------------------------------------------------------------------
 std::string DiscretePropertyValueList::getValueAsLua() const
 {
-  if(fValue.empty())
+  if(fValue->empty())
     return "{}";
   std::vector<std::string> l{};
-  std::transform(fValue.begin(), fValue.end(), std::back_inserter(l), [](auto i) { return std::to_string(i); } );
+  std::transform(fValue->begin(), fValue->end(), std::back_inserter(l), [](auto i) { return std::to_string(i); } );
   return re::mock::fmt::printf("{ %s }", re::mock::stl::join_to_string(l));
 }
 
@@ -200,7 +200,7 @@ void DiscretePropertyValueList::editView(int iMin,
   auto const itemWidth = AppContext::GetCurrent().fItemWidth;
 
   int deleteItemIdx = -1;
-  for(int i = 0; i < fValue.size(); i++)
+  for(int i = 0; i < fValue->size(); i++)
   {
     ImGui::PushID(i);
     if(ImGui::Button("-"))
@@ -209,7 +209,7 @@ void DiscretePropertyValueList::editView(int iMin,
 
     ImGui::PushItemWidth(itemWidth - (ImGui::GetCursorPosX() - offset));
 
-    int editedValue = fValue[i];
+    int editedValue = fValue->at(i);
     if(ImGui::SliderInt(re::mock::fmt::printf("%s [%d]", fName, i).c_str(), &editedValue, iMin, iMax))
       iOnUpdate(i, editedValue);
 
@@ -221,7 +221,7 @@ void DiscretePropertyValueList::editView(int iMin,
   if(deleteItemIdx >= 0)
     iOnDelete(deleteItemIdx);
 
-  ImGui::PushID(static_cast<int>(fValue.size()));
+  ImGui::PushID(static_cast<int>(fValue->size()));
 
   if(ImGui::Button("+"))
     iOnAdd();
@@ -239,7 +239,7 @@ void DiscretePropertyValueList::editView(int iMin,
 //------------------------------------------------------------------------
 bool DiscretePropertyValueList::contains(int iValue) const
 {
-  return std::find(fValue.begin(), fValue.end(), iValue) != fValue.end();
+  return std::find(fValue->begin(), fValue->end(), iValue) != fValue->end();
 }
 
 //------------------------------------------------------------------------
@@ -279,8 +279,7 @@ void Value::editView(AppContext &iCtx)
                             if(updateAttribute([this, p] {
                               fValueSwitch.fValue = p->path();
                               fValueSwitch.fProvided = true;
-                              fValues.fValue.clear();
-                              fValues.fValue.resize(p->stepCount());
+                              fValues.fValue = std::vector<std::string>(p->stepCount());
                             }, &fValueSwitch))
                             {
                               fValueSwitch.markEdited();
@@ -309,7 +308,7 @@ void Value::editView(AppContext &iCtx)
                                  fValue.fFilter,
                                  [this](int iIndex, const Property *p) { // onSelect
                                    if(update([this, iIndex, p] {
-                                               fValues.fValue[iIndex] = p->path();
+                                               fValues.fValue.mutate()[iIndex] = p->path();
                                                fValues.fProvided = true;
                                              },
                                              computeUpdateAttributeDescription(&fValues, iIndex)))
@@ -422,13 +421,13 @@ std::string const &Value::findActualPropertyPath(AppContext &iCtx) const
 
   if(fUseSwitch)
   {
-    if(fValueSwitch.fValue.empty())
+    if(fValueSwitch.fValue->empty())
       return kNoProperty;
     else
     {
-      auto index = iCtx.getPropertyValueAsInt(fValueSwitch.fValue);
-      RE_EDIT_INTERNAL_ASSERT(fValues.fValue.size() > index);
-      return fValues.fValue.at(index);
+      auto index = fValueSwitch.getValueAsInt(iCtx);
+      RE_EDIT_INTERNAL_ASSERT(fValues.fValue->size() > index);
+      return fValues.fValue->at(index);
     }
   }
   else
@@ -457,9 +456,9 @@ std::string Value::toString() const
 std::string Value::toValueString() const
 {
   if(fUseSwitch)
-    return fmt::printf("%s = \"%s\" ([%ld] values)", fValueSwitch.fName, fValueSwitch.fValue, fValues.fValue.size());
+    return fmt::printf("%s = \"%s\" ([%ld] values)", fValueSwitch.fName, fValueSwitch.fValue->c_str(), fValues.fValue->size());
   else
-    return fmt::printf("%s = \"%s\"", fValue.fName, fValue.fValue);
+    return fmt::printf("%s = \"%s\"", fValue.fName, fValue.fValue->c_str());
 }
 
 //------------------------------------------------------------------------
@@ -513,7 +512,7 @@ void Value::resetEdited()
 //------------------------------------------------------------------------
 bool Value::copyFromAction(Attribute const *iAttribute)
 {
-  auto fromAttribute = dynamic_cast<Value const *>(iAttribute);
+  auto fromAttribute = iAttribute->as<Value>();
   if(fromAttribute)
   {
     fUseSwitch = fromAttribute->fUseSwitch;
@@ -524,7 +523,7 @@ bool Value::copyFromAction(Attribute const *iAttribute)
     return true;
   }
 
-  auto pathAttribute = dynamic_cast<PropertyPath const *>(iAttribute);
+  auto pathAttribute = iAttribute->as<PropertyPath>();
   if(pathAttribute)
   {
     reset();
@@ -550,7 +549,7 @@ void Value::updateFilters(Property::Filter iValueFilter, Property::Filter iValue
 //------------------------------------------------------------------------
 void Visibility::hdgui2D(attribute_list_t &oAttributes) const
 {
-  if(!fSwitch.fValue.empty())
+  if(!fSwitch.fValue->empty())
   {
     fSwitch.hdgui2D(oAttributes);
     fValues.hdgui2D(oAttributes);
@@ -596,22 +595,23 @@ void Visibility::editView(AppContext &iCtx)
       fValues.editView(0, stepCount - 1,
                        [this]() { // onAdd
                          updateAttribute([this] {
-                                           fValues.fValue.emplace_back(0);
+                                           fValues.fValue.mutate().emplace_back(0);
                                            fValues.fProvided = true;
                                          },
                                          &fValues);
                        },
                        [this](int iIndex, int iValue) { // onUpdate
                          update([this, iIndex, iValue] {
-                                  fValues.fValue[iIndex] = iValue;
+                                  fValues.fValue.mutate()[iIndex] = iValue;
                                   fValues.fProvided = true;
                                 },
                                 computeUpdateAttributeDescription(&fValues, iIndex),
-                                MergeKey::from(&fValues.fValue[iIndex]));
+                                MergeKey::from(&fValues, iIndex));
                        },
                        [this](int iIndex) { // onDelete
                          updateAttribute([this, iIndex] {
-                                           fValues.fValue.erase(fValues.fValue.begin() + iIndex);
+                                           auto &values = fValues.fValue.mutate();
+                                           values.erase(values.begin() + iIndex);
                                            fValues.fProvided = true;
                                          },
                                          &fValues);
@@ -637,7 +637,7 @@ void Visibility::addVisibility(std::string const &iPropertyPath, int iPropertyVa
     if(!fValues.contains(iPropertyValue))
     {
       updateAttribute([this, iPropertyValue] {
-        fValues.fValue.emplace_back(iPropertyValue);
+        fValues.fValue.mutate().emplace_back(iPropertyValue);
       });
     }
   }
@@ -666,7 +666,7 @@ void Visibility::removeVisibility(std::string const &iPropertyPath, int iPropert
     if(fValues.contains(iPropertyValue))
     {
       updateAttribute([this, iPropertyValue] {
-        auto &v = fValues.fValue;
+        auto &v = fValues.fValue.mutate();
         v.erase(std::remove(v.begin(), v.end(), iPropertyValue), v.end());
         if(v.empty())
           fSwitch.reset();
@@ -692,11 +692,11 @@ void Visibility::findErrors(AppContext &iCtx, UserError &oErrors) const
       if(stepCount == 0)
         oErrors.add("The property must be a discrete property");
 
-      if(fValues.fValue.empty())
+      if(fValues.fValue->empty())
         oErrors.add("You must provide at least 1 value");
 
       int i = 0;
-      for(auto v: fValues.fValue)
+      for(auto v: *fValues.fValue)
       {
         if(v < 0 || v >= stepCount)
           oErrors.add("Invalid value [%d] (%d outside of bound)", i, v);
@@ -747,11 +747,10 @@ void Visibility::reset()
 //------------------------------------------------------------------------
 bool Visibility::isHidden(AppContext const &iCtx) const
 {
-  auto switchPropertyPath = fSwitch.fValue;
-  if(switchPropertyPath.empty() || fValues.empty())
+  if(fSwitch.fValue->empty() || fValues.empty())
     return false;
   else
-    return !fValues.contains(iCtx.getPropertyValueAsInt(switchPropertyPath));
+    return !fValues.contains(fSwitch.getValueAsInt(iCtx));
 }
 
 //------------------------------------------------------------------------
@@ -771,7 +770,7 @@ std::string Visibility::toString() const
 //------------------------------------------------------------------------
 std::string Visibility::toValueString() const
 {
-  return fmt::printf("%s = \"%s\" ([%ld] values)", fSwitch.fName, fSwitch.fValue, fValues.fValue.size());
+  return fmt::printf("%s = \"%s\" ([%ld] values)", fSwitch.fName, fSwitch.fValue->c_str(), fValues.fValue->size());
 }
 
 static const Property::Filter kVisibilitySwitchFilter{[](const Property &p) {
@@ -788,7 +787,7 @@ Visibility::Visibility() : CompositeAttribute("visibility"), fSwitch{"visibility
 //------------------------------------------------------------------------
 bool Visibility::copyFromAction(Attribute const *iAttribute)
 {
-  auto fromAttribute = dynamic_cast<Visibility const *>(iAttribute);
+  auto fromAttribute = iAttribute->as<Visibility>();
   if(fromAttribute)
   {
     fSwitch.copyFromAction(&fromAttribute->fSwitch);
@@ -808,7 +807,7 @@ void String::editView(AppContext &iCtx)
   menuView(iCtx);
   ImGui::SameLine();
 
-  auto editedValue = fValue;
+  std::string editedValue = fValue;
 
   if(ImGui::InputText(fName, &editedValue))
   {
@@ -883,9 +882,9 @@ void PropertyPath::editView(AppContext &iCtx,
   if(oComboPosition)
     *oComboPosition = ImGui::GetCursorPos();
 
-  if(ImGui::BeginCombo(fName, fValue.c_str()))
+  if(ImGui::BeginCombo(fName, fValue->c_str()))
   {
-    auto properties = ReGui::IsFilterEnabled() ? iCtx.findProperties(fFilter) : iCtx.findAllProperties();
+    auto const &properties = ReGui::IsFilterEnabled() ? iCtx.findProperties(fFilter) : iCtx.findAllProperties();
     for(auto &p: properties)
     {
       auto const isSelected = p->path() == fValue;
@@ -897,7 +896,7 @@ void PropertyPath::editView(AppContext &iCtx,
     ImGui::EndCombo();
   }
 
-  if(!fValue.empty())
+  if(!fValue->empty())
   {
     if(ReGui::ShowQuickView())
     {
@@ -993,7 +992,7 @@ void PropertyPath::findErrors(AppContext &iCtx, UserError &oErrors) const
     {
       if(fFilter)
       {
-        auto properties = iCtx.findProperties(fFilter);
+        auto const &properties = iCtx.findProperties(fFilter);
         if(std::find(properties.begin(), properties.end(), property) == properties.end())
           oErrors.add("Invalid property (%s)", fFilter.fDescription);
       }
@@ -1006,15 +1005,27 @@ void PropertyPath::findErrors(AppContext &iCtx, UserError &oErrors) const
   }
 }
 
+//------------------------------------------------------------------------
+// PropertyPath::getPropertyHandle
+//------------------------------------------------------------------------
+PropertyHandle PropertyPath::getPropertyHandle(AppContext const &iCtx) const
+{
+  if(!iCtx.isCurrentPropertyHandle(fPropertyHandle))
+    fPropertyHandle = iCtx.getPropertyHandle(fValue);
+  return fPropertyHandle;
+}
+
 //------------------------------------------------------------------------
 // PropertyPath::copyFromAction
 //------------------------------------------------------------------------
 bool PropertyPath::copyFromAction(Attribute const *iFromAttribute)
 {
+  invalidatePropertyHandle();
+
   if(SingleAttribute::copyFromAction(iFromAttribute))
     return true;
 
-  auto valueAttribute = dynamic_cast<Value const *>(iFromAttribute);
+  auto valueAttribute = iFromAttribute->as<Value>();
   if(valueAttribute)
   {
     if(!valueAttribute->fUseSwitch)
@@ -1033,9 +1044,9 @@ void ObjectPath::editView(AppContext &iCtx)
 
   ImGui::SameLine();
 
-  if(ImGui::BeginCombo(fName, fValue.c_str()))
+  if(ImGui::BeginCombo(fName, fValue->c_str()))
   {
-    auto objects = ReGui::IsFilterEnabled() ? iCtx.findObjects(fFilter) : iCtx.findAllObjects();
+    auto const &objects = ReGui::IsFilterEnabled() ? iCtx.findObjects(fFilter) : iCtx.findAllObjects();
     for(auto &o: objects)
     {
       auto const isSelected = o->path() == fValue;
@@ -1064,7 +1075,7 @@ void ObjectPath::findErrors(AppContext &iCtx, UserError &oErrors) const
     {
       if(fFilter)
       {
-        auto objects = iCtx.findObjects(fFilter);
+        auto const &objects = iCtx.findObjects(fFilter);
         if(std::find(objects.begin(), objects.end(), object) == objects.end())
           oErrors.add("Invalid (wrong type)");
       }
@@ -1084,17 +1095,17 @@ void Socket::editView(AppContext &iCtx)
 {
   ObjectPath::editView(iCtx);
 
-  if(!fValue.empty())
+  if(!fValue->empty())
   {
     if(ReGui::ShowQuickView())
     {
       ReGui::ToolTip([this, &iCtx] {
-        ImGui::TextUnformatted(iCtx.getPropertyInfo(re::mock::fmt::printf("%s/%s", fValue, "connected")).c_str());
+        ImGui::TextUnformatted(iCtx.getPropertyInfo(re::mock::fmt::printf("%s/%s", fValue->c_str(), "connected")).c_str());
         switch(fObjectType)
         {
           case re::mock::JboxObjectType::kAudioOutput:
           case re::mock::JboxObjectType::kCVOutput:
-            ImGui::TextUnformatted(iCtx.getPropertyInfo(re::mock::fmt::printf("%s/%s", fValue, "dsp_latency")).c_str());
+            ImGui::TextUnformatted(iCtx.getPropertyInfo(re::mock::fmt::printf("%s/%s", fValue->c_str(), "dsp_latency")).c_str());
             break;
           default:
             // nothing to do
@@ -1112,14 +1123,14 @@ void PropertyPathList::editStaticListView(AppContext &iCtx,
                                           Property::Filter const &iFilter,
                                           std::function<void(int iIndex, const Property *)> const &iOnSelect) const
 {
-  for(int i = 0; i < fValue.size(); i++)
+  for(int i = 0; i < fValue->size(); i++)
   {
     ImGui::PushID(i);
 
-    auto &value = fValue[i];
+    auto &value = fValue->at(i);
     if(ImGui::BeginCombo(re::mock::fmt::printf("%s [%d]", fName, i).c_str(), value.c_str()))
     {
-      auto properties = ReGui::IsFilterEnabled() ? iCtx.findProperties(iFilter) : iCtx.findAllProperties();
+      auto const &properties = ReGui::IsFilterEnabled() ? iCtx.findProperties(iFilter) : iCtx.findAllProperties();
       for(auto &p: properties)
       {
         auto const isSelected = p->path() == value;
@@ -1158,7 +1169,7 @@ void PropertyPathList::editView(AppContext &iCtx)
 
   auto const popupTitleName = re::mock::fmt::printf("%s Editor", fName);
 
-  if(ImGui::Button(re::mock::fmt::printf("[%d] properties", fValue.size()).c_str(), ImVec2{ImGui::CalcItemWidth(), 0}))
+  if(ImGui::Button(re::mock::fmt::printf("[%d] properties", fValue->size()).c_str(), ImVec2{ImGui::CalcItemWidth(), 0}))
   {
     auto sortBy = [&iCtx, this](std::vector<std::string> &ioString, std::string const &iSortCriteria) {
       fSortCriteria = iSortCriteria;
@@ -1215,11 +1226,11 @@ void PropertyPathList::editView(AppContext &iCtx)
 //------------------------------------------------------------------------
 void PropertyPathList::findErrors(AppContext &iCtx, UserError &oErrors) const
 {
-  auto properties = iCtx.findProperties(fFilter);
+  auto const &properties = iCtx.findProperties(fFilter);
 
   auto idx = 0;
 
-  for(auto &p: fValue)
+  for(auto &p: *fValue)
   {
     if(p.empty())
       oErrors.add("Required property [%d]", idx);
@@ -1248,7 +1259,7 @@ void StaticStringList::editView(AppContext &iCtx)
 {
   menuView(iCtx);
   ImGui::SameLine();
-  if(ImGui::BeginCombo(fName, fValue.c_str()))
+  if(ImGui::BeginCombo(fName, fValue->c_str()))
   {
     for(auto &p: fSelectionList)
     {
@@ -1347,7 +1358,7 @@ void UserSampleIndex::findErrors(AppContext &iCtx, UserError &oErrors) const
 //------------------------------------------------------------------------
 void Values::findErrors(AppContext &iCtx, UserError &oErrors) const
 {
-  if(fValue.empty())
+  if(fValue->empty())
     oErrors.add("The list must contain at least one entry");
   else
     PropertyPathList::findErrors(iCtx, oErrors);
@@ -1358,10 +1369,10 @@ void Values::findErrors(AppContext &iCtx, UserError &oErrors) const
 //------------------------------------------------------------------------
 std::string ValueTemplates::getValueAsLua() const
 {
-  if(fValue.empty())
+  if(fValue->empty())
     return "{}";
   std::vector<std::string> l{};
-  std::transform(fValue.begin(), fValue.end(), std::back_inserter(l), toUIText);
+  std::transform(fValue->begin(), fValue->end(), std::back_inserter(l), toUIText);
   return re::mock::fmt::printf("{ %s }", re::mock::stl::join_to_string(l));
 }
 
@@ -1379,7 +1390,7 @@ void ValueTemplates::editView(AppContext &iCtx)
 
   ImGui::BeginGroup();
   int deleteItemIdx = -1;
-  for(int i = 0; i < fValue.size(); i++)
+  for(int i = 0; i < fValue->size(); i++)
   {
     ImGui::PushID(i);
     if(ImGui::Button("-"))
@@ -1388,15 +1399,15 @@ void ValueTemplates::editView(AppContext &iCtx)
 
     ImGui::PushItemWidth(itemWidth - (ImGui::GetCursorPosX() - offset));
 
-    auto editedValue = fValue[i];
+    auto editedValue = fValue->at(i);
     if(ImGui::InputText(re::mock::fmt::printf("%s [%d]", fName, i).c_str(), &editedValue))
     {
       update([this, i, &editedValue] {
-               fValue[i] = editedValue;
+               fValue.mutate()[i] = editedValue;
                fProvided = true;
              },
              computeUpdateAttributeDescription(this, i),
-             MergeKey::from(&fValue[i]));
+             MergeKey::from(this, i));
     }
 
     ImGui::PopItemWidth();
@@ -1407,16 +1418,17 @@ void ValueTemplates::editView(AppContext &iCtx)
   if(deleteItemIdx >= 0)
   {
     updateAttribute([this, deleteItemIdx] {
-      fValue.erase(fValue.begin() + deleteItemIdx);
+      auto &values = fValue.mutate();
+      values.erase(values.begin() + deleteItemIdx);
     });
   }
 
-  ImGui::PushID(static_cast<int>(fValue.size()));
+  ImGui::PushID(static_cast<int>(fValue->size()));
 
   if(ImGui::Button("+"))
   {
     updateAttribute([this] {
-      fValue.resize(fValue.size() + 1);
+      fValue.mutate().emplace_back();
     });
   }
 
@@ -1440,14 +1452,14 @@ void ValueTemplates::editView(AppContext &iCtx)
 //------------------------------------------------------------------------
 void ValueTemplates::findErrors(AppContext &iCtx, UserError &oErrors) const
 {
-  if(fValue.size() > 1)
+  if(fValue->size() > 1)
   {
     auto valueAtt = getParent()->findAttributeByIdAndType<Value>(fValueAttributeId);
     if(valueAtt->fUseSwitch)
     {
       auto property = iCtx.findProperty(valueAtt->fValueSwitch.fValue);
-      if(property && property->stepCount() != fValue.size())
-        oErrors.add("May contain one entry, or the same number of entries as the number of entries in values (%d)", fValue.size());
+      if(property && property->stepCount() != fValue->size())
+        oErrors.add("May contain one entry, or the same number of entries as the number of entries in values (%d)", fValue->size());
     }
     else
       oErrors.add("Only 1 value max allowed");
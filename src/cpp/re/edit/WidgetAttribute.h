@@ -21,15 +21,19 @@
 
 #include "Constants.h"
 #include "Texture.h"
+#include "TextureReferences.h"
 #include "AppContext.h"
 #include "Views.h"
 #include "ReGui.h"
 #include "Color.h"
+#include "stl.h"
 
 #include <string>
 #include <vector>
 #include <optional>
 #include <variant>
+#include <type_traits>
+#include <cstdint>
 
 namespace re::edit {
 
@@ -81,6 +85,37 @@ protected:
 
 namespace widget {
 
+namespace attribute {
+
+//! Type tag of an attribute class (one bit per class). The tag of a class includes the tags of the classes it
+//! derives from so that `Attribute::isKindOf<T>` is a mask check instead of a `dynamic_cast`.
+using kind_t = std::uint32_t;
+
+namespace kind {
+constexpr kind_t kGraphics = 1u << 0;
+constexpr kind_t kBool = 1u << 1;
+constexpr kind_t kInteger = 1u << 2;
+constexpr kind_t kString = 1u << 3;
+constexpr kind_t kPropertyPath = 1u << 4;
+constexpr kind_t kUIText = 1u << 5;
+constexpr kind_t kPropertyPathList = 1u << 6;
+constexpr kind_t kDiscretePropertyValueList = 1u << 7;
+constexpr kind_t kValue = 1u << 8;
+constexpr kind_t kVisibility = 1u << 9;
+constexpr kind_t kStaticStringList = 1u << 10;
+constexpr kind_t kObjectPath = 1u << 11;
+constexpr kind_t kSocket = 1u << 12;
+constexpr kind_t kColor3 = 1u << 13;
+constexpr kind_t kValues = 1u << 14;
+constexpr kind_t kValueTemplates = 1u << 15;
+constexpr kind_t kReadOnly = 1u << 16;
+constexpr kind_t kIndex = 1u << 17;
+constexpr kind_t kUserSampleIndex = 1u << 18;
+constexpr kind_t kBackground = 1u << 19;
+}
+
+}
+
 class Attribute : public Editable
 {
 public:
@@ -93,11 +128,24 @@ public:
   Attribute &operator=(Attribute &&iOther) = delete;
 
   virtual void hdgui2D(attribute_list_t &oAttributes) const {}
-  virtual void collectFilmStripEffects(std::vector<FilmStripFX> &oEffects) const {};
-  virtual void collectUsedTexturePaths(std::set<fs::path> &oPaths) const {}
-  virtual void collectAllUsedTextureKeys(std::set<FilmStrip::key_t> &oKeys) const {};
-  virtual void collectUsedTextureBuiltIns(std::set<FilmStrip::key_t> &oKeys) const {}
-//  virtual Kind getKind() const = 0;
+  //! Adds the textures (keys and effects) this attribute references (see `Panel::textureReferences`)
+  virtual void collectTextureSources(TextureReferences::sources_t &oSources) const {}
+
+  //! Type tag of the (concrete) class of this attribute
+  virtual attribute::kind_t getKind() const = 0;
+
+  //! @return `true` if this attribute is a `T` (or derives from `T`)
+  template<typename T>
+  inline bool isKindOf() const
+  {
+    // a 0 tag would match any attribute
+    static_assert(T::kKind != 0, "T::kKind must be a (non empty) attribute::kind tag");
+    return (getKind() & T::kKind) == T::kKind;
+  }
+
+  //! Equivalent of `dynamic_cast<T const *>(this)` (without RTTI)
+  template<typename T>
+  inline T const *as() const { return isKindOf<T>() ? static_cast<T const *>(this) : nullptr; }
 
   virtual void reset() {}
   virtual void editView(AppContext &iCtx) {}
@@ -105,6 +153,9 @@ public:
   virtual std::string toString() const;
   virtual std::string toValueString() const { return "TBD"; }
 
+  //! Approximate memory used by this attribute (including what it allocates)
+  virtual std::size_t getMemorySize() const { return sizeof(Attribute); }
+
   template<typename T, typename... ConstructorArgs>
   static std::unique_ptr<T> build(char const *iName, bool iRequired, typename T::value_t const &iDefaultValue, ConstructorArgs&& ...iArgs);
 
@@ -166,6 +217,9 @@ class SingleAttribute : public Attribute
 public:
   using value_t = T;
 
+  //! Values allocating memory (strings, lists...) are shared between clones of the attribute (copy on write)
+  using storage_t = std::conditional_t<std::is_trivially_copyable_v<T>, T, stl::cow<T>>;
+
 public:
   explicit SingleAttribute(char const *iName) : Attribute{iName} {}
   void hdgui2D(attribute_list_t &oAttributes) const override;
@@ -174,6 +228,11 @@ public:
   std::string toValueString() const override { return fmt::printf("%s = %s", fName, getValueAsLua()); }
   void reset() override;
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) - 2 * sizeof(storage_t) + stl::memorySize(fDefaultValue) + stl::memorySize(fValue);
+  }
+
   bool copyFromAction(Attribute const *iFromAttribute) override;
 
   std::string toString() const override;
@@ -183,8 +242,8 @@ public:
   bool mergeUpdate(T const &iNewValue);
 
 public:
-  value_t fDefaultValue{};
-  value_t fValue{};
+  storage_t fDefaultValue{};
+  storage_t fValue{};
   bool fProvided{};
 };
 
@@ -199,6 +258,9 @@ public:
 class Bool : public SingleAttribute<bool>
 {
 public:
+  static constexpr kind_t kKind = kind::kBool;
+  kind_t getKind() const override { return kKind; }
+
   explicit Bool(char const *iName) : SingleAttribute<bool>{iName} {}
   std::string getValueAsLua() const override { return fmt::Bool::to_string(fValue); }
   void editView(AppContext &iCtx) override;
@@ -214,6 +276,9 @@ public:
 class Integer : public SingleAttribute<int>
 {
 public:
+  static constexpr kind_t kKind = kind::kInteger;
+  kind_t getKind() const override { return kKind; }
+
   explicit Integer(char const *iName) : SingleAttribute<int>{iName} {}
   std::string getValueAsLua() const override { return std::to_string(fValue); }
   void editView(AppContext &iCtx) override;
@@ -229,7 +294,9 @@ public:
 class String : public SingleAttribute<std::string>
 {
 public:
-//  Kind getKind() const override { return Kind::kString; }
+  static constexpr kind_t kKind = kind::kString;
+  kind_t getKind() const override { return kKind; }
+
   explicit String(char const *iName) : SingleAttribute<std::string>{iName} {}
   std::string getValueAsLua() const override;
   void editView(AppContext &iCtx) override;
@@ -245,6 +312,9 @@ public:
 class PropertyPath : public String
 {
 public:
+  static constexpr kind_t kKind = kind::kPropertyPath | String::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit PropertyPath(char const *iName, Property::Filter iFilter = {}) : String{iName}, fFilter{std::move(iFilter)} {}
   void editView(AppContext &iCtx) override;
 
@@ -252,6 +322,10 @@ public:
 
   bool copyFromAction(Attribute const *iFromAttribute) override;
 
+  // every change of fValue goes through one of these (directly or from the owning attribute)
+  void reset() override { String::reset(); invalidatePropertyHandle(); }
+  void markEdited() override { String::markEdited(); invalidatePropertyHandle(); }
+
   void findErrors(AppContext &iCtx, UserError &oErrors) const override;
 
   bool eq(Attribute const *iAttribute) const override
@@ -287,14 +361,26 @@ public:
 
   static void tooltipPropertyView(AppContext &iCtx, std::string const &iPropertyPath);
 
+  //! Handle of the property (resolved only when the path or the device changes)
+  PropertyHandle getPropertyHandle(AppContext const &iCtx) const;
+  inline int getValueAsInt(AppContext const &iCtx) const { return iCtx.getPropertyValueAsInt(getPropertyHandle(iCtx)); }
+
 public:
   Property::Filter fFilter;
+
+private:
+  inline void invalidatePropertyHandle() { fPropertyHandle = {}; }
+
+private:
+  mutable PropertyHandle fPropertyHandle{};
 };
 
 class UIText : public String
 {
 public:
-//  Kind getKind() const override { return Kind::kUIText; }
+  static constexpr kind_t kKind = kind::kUIText | String::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit UIText(char const *iName) : String{iName} {}
   std::string getValueAsLua() const override;
 
@@ -309,13 +395,15 @@ public:
 class PropertyPathList : public SingleAttribute<std::vector<std::string>>
 {
 public:
-//  Kind getKind() const override { return Kind::kPropertyPathList; }
+  static constexpr kind_t kKind = kind::kPropertyPathList;
+  kind_t getKind() const override { return kKind; }
+
   explicit PropertyPathList(char const *iName, Property::Filter iFilter = {}) :
     SingleAttribute<std::vector<std::string>>{iName},
     fFilter{std::move(iFilter)}
     {}
   std::string getValueAsLua() const override;
-  std::string toValueString() const override { return fmt::printf("%s = [%ld] properties", fName, fValue.size()); }
+  std::string toValueString() const override { return fmt::printf("%s = [%ld] properties", fName, fValue->size()); }
   void editView(AppContext &iCtx) override;
   void editStaticListView(AppContext &iCtx,
                           Property::Filter const &iFilter,
@@ -341,11 +429,14 @@ public:
 class DiscretePropertyValueList : public SingleAttribute<std::vector<int>>
 {
 public:
+  static constexpr kind_t kKind = kind::kDiscretePropertyValueList;
+  kind_t getKind() const override { return kKind; }
+
   explicit DiscretePropertyValueList(char const *iName) : SingleAttribute<std::vector<int>>{iName} {}
   std::string getValueAsLua() const override;
 
   bool contains(int iValue) const;
-  bool empty() const { return fValue.empty(); }
+  bool empty() const { return fValue->empty(); }
 
   using Attribute::editView;
 
@@ -366,6 +457,9 @@ public:
 class Value : public CompositeAttribute
 {
 public:
+  static constexpr kind_t kKind = kind::kValue;
+  kind_t getKind() const override { return kKind; }
+
   Value(Property::Filter iValueFilter, Property::Filter iValueSwitchFilter) :
     CompositeAttribute("value"),
     fValue{"value", std::move(iValueFilter)},
@@ -405,6 +499,12 @@ public:
 
   bool copyFromAction(Attribute const *iAttribute) override;
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) - sizeof(fValue) - sizeof(fValueSwitch) - sizeof(fValues) +
+           fValue.getMemorySize() + fValueSwitch.getMemorySize() + fValues.getMemorySize();
+  }
+
   void updateFilters(Property::Filter iValueFilter, Property::Filter iValueSwitchFilter);
 
 protected:
@@ -420,6 +520,9 @@ public:
 class Visibility : public CompositeAttribute
 {
 public:
+  static constexpr kind_t kKind = kind::kVisibility;
+  kind_t getKind() const override { return kKind; }
+
   Visibility();
   void hdgui2D(attribute_list_t &oAttributes) const override;
   void editView(AppContext &iCtx) override;
@@ -442,6 +545,11 @@ public:
 
   std::unique_ptr<Attribute> clone() const override { return Attribute::clone<Visibility>(*this); }
 
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) - sizeof(fSwitch) - sizeof(fValues) + fSwitch.getMemorySize() + fValues.getMemorySize();
+  }
+
   bool eq(Attribute const *iAttribute) const override
   {
     return Attribute::eq(this, iAttribute, [](auto *l, auto *r) {
@@ -459,8 +567,10 @@ public:
 class StaticStringList : public String
 {
 public:
+  static constexpr kind_t kKind = kind::kStaticStringList | String::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit StaticStringList(char const *iName, std::vector<std::string> const &iSelectionList) : String{iName}, fSelectionList(iSelectionList) {}
-//  Kind getKind() const override { return Kind::kStaticStringList; }
   void editView(AppContext &iCtx) override;
 
   std::unique_ptr<Attribute> clone() const override { return Attribute::clone<StaticStringList>(*this); }
@@ -477,6 +587,9 @@ public:
 class ObjectPath : public String
 {
 public:
+  static constexpr kind_t kKind = kind::kObjectPath | String::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit ObjectPath(char const *iName, re::mock::JboxObjectType iObjectType, Object::Filter iFilter = {}) :
     String{iName},
     fObjectType{iObjectType},
@@ -499,6 +612,9 @@ public:
 class Socket : public ObjectPath
 {
 public:
+  static constexpr kind_t kKind = kind::kSocket | ObjectPath::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit Socket(re::mock::JboxObjectType iSocketType, Object::Filter iFilter = {}) : ObjectPath{"socket", iSocketType, std::move(iFilter)} {}
   void editView(AppContext &iCtx) override;
 
@@ -513,6 +629,9 @@ public:
 class Color3 : public SingleAttribute<JboxColor3>
 {
 public:
+  static constexpr kind_t kKind = kind::kColor3;
+  kind_t getKind() const override { return kKind; }
+
   explicit Color3(char const *iName) : SingleAttribute<JboxColor3>{iName} {}
   std::string getValueAsLua() const override;
   void editView(AppContext &iCtx) override;
@@ -528,6 +647,9 @@ public:
 class Values : public PropertyPathList
 {
 public:
+  static constexpr kind_t kKind = kind::kValues | PropertyPathList::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit Values(char const *iName, Property::Filter iFilter = {}) :
     PropertyPathList{iName, std::move(iFilter)}
   {}
@@ -545,12 +667,15 @@ public:
 class ValueTemplates : public SingleAttribute<std::vector<std::string>>
 {
 public:
+  static constexpr kind_t kKind = kind::kValueTemplates;
+  kind_t getKind() const override { return kKind; }
+
   ValueTemplates(char const *iName, int iValueAttributeId) :
     SingleAttribute<std::vector<std::string>>{iName}, fValueAttributeId{iValueAttributeId} {}
   std::string getValueAsLua() const override;
   void editView(AppContext &iCtx) override;
 
-  std::string toValueString() const override { return fmt::printf("%s = [%ld] templates", fName, fValue.size()); }
+  std::string toValueString() const override { return fmt::printf("%s = [%ld] templates", fName, fValue->size()); }
 
   void findErrors(AppContext &iCtx, UserError &oErrors) const override;
 
@@ -568,6 +693,9 @@ protected:
 class ReadOnly : public Bool
 {
 public:
+  static constexpr kind_t kKind = kind::kReadOnly | Bool::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit ReadOnly(char const *iName, int iValueAttributeId) :
     Bool{iName}, fValueAttributeId{iValueAttributeId} {}
   void editView(AppContext &iCtx) override;
@@ -595,6 +723,9 @@ protected:
 class Index : public Integer
 {
 public:
+  static constexpr kind_t kKind = kind::kIndex | Integer::kKind;
+  kind_t getKind() const override { return kKind; }
+
   Index(char const *iName, int iValueAttributeId) :
     Integer{iName},
     fValueAttributeId{iValueAttributeId} {}
@@ -617,6 +748,9 @@ protected:
 class UserSampleIndex : public Integer
 {
 public:
+  static constexpr kind_t kKind = kind::kUserSampleIndex | Integer::kKind;
+  kind_t getKind() const override { return kKind; }
+
   explicit UserSampleIndex(char const *iName) : Integer{iName} {}
 
   void editView(AppContext &iCtx) override;
@@ -688,7 +822,10 @@ std::string SingleAttribute<T>::toString() const
 template<typename T>
 bool SingleAttribute<T>::copyFromAction(Attribute const *iFromAttribute)
 {
-  auto fromAttribute = dynamic_cast<SingleAttribute<T> const *>(iFromAttribute);
+  // same class (most common case) => no need for RTTI
+  auto fromAttribute = iFromAttribute->getKind() == getKind() ?
+                       static_cast<SingleAttribute<T> const *>(iFromAttribute) :
+                       dynamic_cast<SingleAttribute<T> const *>(iFromAttribute);
   if(fromAttribute && strcmp(fName, iFromAttribute->fName) == 0)
   {
     fValue = fromAttribute->fValue;
@@ -712,7 +849,7 @@ std::unique_ptr<T> Attribute::build(char const *iName, bool iRequired, typename
   attribute->fName = iName;
   attribute->fRequired = iRequired;
   attribute->fDefaultValue = iDefaultValue;
-  attribute->fValue = iDefaultValue;
+  attribute->fValue = attribute->fDefaultValue;
   return attribute;
 }
 
@@ -722,6 +859,8 @@ std::unique_ptr<T> Attribute::build(char const *iName, bool iRequired, typename
 template<typename T>
 std::unique_ptr<Attribute> Attribute::clone(T const &iAttribute)
 {
+  // T must define its own kKind (and getKind) otherwise isKindOf/as would misidentify the clone
+  RE_EDIT_INTERNAL_ASSERT(iAttribute.getKind() == T::kKind, "%s: getKind() does not match T::kKind", iAttribute.fName);
   return std::make_unique<T>(iAttribute);
 }
 
@@ -731,7 +870,7 @@ std::unique_ptr<Attribute> Attribute::clone(T const &iAttribute)
 template<typename T, typename Eq>
 bool Attribute::eq(T const *iLeftAttribute, Attribute const *iRightAttribute, Eq &&eq)
 {
-  auto r = dynamic_cast<T const *>(iRightAttribute);
+  auto r = iRightAttribute ? iRightAttribute->template as<T>() : nullptr;
   return r && eq(iLeftAttribute, r);
 }
 
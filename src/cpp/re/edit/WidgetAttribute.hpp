@@ -43,6 +43,7 @@ public:
   void execute() override
   {
     // action has already taken place
+    markWidgetChanged();
   }
 
   void undo() override
@@ -58,6 +59,7 @@ public:
 protected:
   void copyFromAction(widget::Attribute const *iAttribute)
   {
+    markWidgetChanged();
     auto widget = getWidget();
     if(widget)
     {
@@ -72,6 +74,12 @@ protected:
     return getPanel()->findWidget(fWidgetId);
   }
 
+  void markWidgetChanged() const
+  {
+    markPanelModified();
+    getPanel()->markWidgetChanged(fWidgetId);
+  }
+
   bool canMergeWith(Action const *iAction) const override
   {
     if(typeid(*this) != typeid(*iAction))
@@ -80,6 +88,14 @@ protected:
     return action && action->fWidgetId == fWidgetId && action->fPreviousValue->eq(fValue.get());
   }
 
+public:
+  std::size_t getMemorySize() const override
+  {
+    return sizeof(*this) + fDescription.capacity() +
+           (fValue ? fValue->getMemorySize() : 0) + (fPreviousValue ? fPreviousValue->getMemorySize() : 0);
+  }
+
+protected:
   std::unique_ptr<Action> doMerge(std::unique_ptr<Action> iAction) override
   {
     auto action = dynamic_cast<AttributeUpdateAction *>(iAction.get());
@@ -107,6 +123,10 @@ bool Attribute::update(F &&f, std::string const &iDescription, MergeKey const &i
   {
     f();
     markEdited();
+    // same notifications as AttributeUpdateAction::execute
+    auto panel = ctx.getPanel(getParent()->getPanelType());
+    panel->markModified();
+    panel->markWidgetChanged(getParent()->getId());
     return true;
   }
   else
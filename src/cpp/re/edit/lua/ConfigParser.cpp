@@ -44,6 +44,10 @@ config::Global GlobalConfigParser::getConfig()
     withOptionalValue(L.getTableValueAsOptionalInteger("target_frame_rate"), [&c](auto v) { c.fTargetFrameRate = v; });
     withOptionalValue(L.getTableValueAsOptionalBoolean("vsync_enabled"), [&c](auto v) { c.fVSyncEnabled = v; });
     withOptionalValue(L.getTableValueAsOptionalBoolean("show_performance"), [&c](auto v) { c.fShowPerformance = v; });
+    withOptionalValue(L.getTableValueAsOptionalInteger("texture_memory_budget"), [&c](auto v) { c.fTextureMemoryBudget = v; });
+    withOptionalValue(L.getTableValueAsOptionalInteger("gpu_upload_budget"), [&c](auto v) { c.fGPUUploadBudget = v; });
+    withOptionalValue(L.getTableValueAsOptionalInteger("undo_history_max_count"), [&c](auto v) { c.fUndoHistoryMaxCount = v; });
+    withOptionalValue(L.getTableValueAsOptionalInteger("undo_history_memory_budget"), [&c](auto v) { c.fUndoHistoryMemoryBudget = v; });
     withOptionalValue(L.getTableValueAsOptionalString("style"), [&c](auto v) {
       v = Utils::str_tolower(v);
       if(v == "light")
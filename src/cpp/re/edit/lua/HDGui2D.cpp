@@ -821,9 +821,9 @@ void HDGui2D::populate(PropertyPathList *oList)
 {
   if(oList)
   {
-    oList->fValue.clear();
+    oList->fValue.mutate().clear();
     withField(-1, oList->fName, LUA_TTABLE, [this, oList]() {
-      iterateLuaArray([this, values = &oList->fValue](auto i) {
+      iterateLuaArray([this, values = &oList->fValue.mutate()](auto i) {
         if(lua_type(L, -1) == LUA_TSTRING)
           values->emplace_back(lua_tostring(L, -1));
       }, true, false);
@@ -851,9 +851,9 @@ void HDGui2D::populate(DiscretePropertyValueList *oList)
 {
   if(oList)
   {
-    oList->fValue.clear();
+    oList->fValue.mutate().clear();
     withField(-1, oList->fName, LUA_TTABLE, [this, oList]() {
-      iterateLuaArray([this, values = &oList->fValue](auto i) {
+      iterateLuaArray([this, values = &oList->fValue.mutate()](auto i) {
         if(lua_type(L, -1) == LUA_TNUMBER)
           values->emplace_back(static_cast<int>(lua_tonumber(L, -1)));
       }, true, false);
@@ -869,9 +869,9 @@ void HDGui2D::populate(ValueTemplates *oList)
 {
   if(oList)
   {
-    oList->fValue.clear();
+    oList->fValue.mutate().clear();
     withField(-1, oList->fName, LUA_TTABLE, [this, oList]() {
-      iterateLuaArray([this, values = &oList->fValue](auto i) {
+      iterateLuaArray([this, values = &oList->fValue.mutate()](auto i) {
         auto ui_text = toOptional<impl::jbox_ui_text>(getObjectOnTopOfStack());
         if(ui_text)
           values->emplace_back(ui_text->fText);
@@ -950,9 +950,25 @@ std::shared_ptr<jbox_panel> HDGui2D::getPanel(char const *iPanelName)
 // HDGui2D::populate
 //------------------------------------------------------------------------
 template<typename T>
-bool HDGui2D::populate(std::shared_ptr<jbox_widget> &oWidget, std::string const &iAttributeName)
+bool HDGui2D::populate(std::shared_ptr<jbox_widget> &oWidget, std::string_view iAttributeName)
 {
-  auto const attribute = oWidget->fWidget->findAttributeByNameAndType<T>(iAttributeName);
+  auto const &widget = *oWidget->fWidget;
+
+  // widgets of the same type are built by the same factory => the name is only looked up once per type
+  T *attribute{};
+  auto key = std::make_pair(widget.getType(), iAttributeName);
+  auto iter = fAttributeIds.find(key);
+  if(iter != fAttributeIds.end())
+  {
+    if(iter->second >= 0)
+      attribute = widget.findAttributeByIdAndType<T>(iter->second);
+  }
+  else
+  {
+    attribute = widget.findAttributeByNameAndType<T>(iAttributeName);
+    fAttributeIds[key] = attribute ? attribute->fId : -1;
+  }
+
   if(attribute)
   {
     populate(attribute);
@@ -137,10 +137,13 @@ protected:
    * Returns `true` if the widget has an attribute of the given type/name combination NOT if the population happens
    * (for example attribute not defined in the hdgui_2D.lua) */
   template<typename T>
-  bool populate(std::shared_ptr<jbox_widget> &oWidget, std::string const &iAttributeName);
+  bool populate(std::shared_ptr<jbox_widget> &oWidget, std::string_view iAttributeName);
 
 private:
   re::mock::ObjectManager<impl::jbox_object> fObjects{};
+
+  // (widget type, attribute name) -> id assigned by the factory (-1 when the widget has no such attribute)
+  std::map<std::pair<WidgetType, std::string_view>, int> fAttributeIds{};
 };
 
 
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2023 pongasoft
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations under
+ * the License.
+ *
+ * @author Yan Pujante
+ */
+
+#ifndef RE_EDIT_LUA_WRITER_H
+#define RE_EDIT_LUA_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <cstdio>
+#include <type_traits>
+#include "../String.h"
+
+namespace re::edit::lua {
+
+namespace impl {
+
+template<typename T>
+constexpr T const &printf_arg(T const &t) { return t; }
+inline char const *printf_arg(std::string const &s) { return s.c_str(); }
+inline char const *printf_arg(Symbol const &s) { return s.c_str(); }
+
+//! Only these types can be safely passed through `...` to snprintf (any other type is undefined behavior)
+template<typename T>
+constexpr bool is_printf_arg_v = std::is_arithmetic_v<T> || std::is_pointer_v<T>;
+
+}
+
+/**
+ * Accumulates generated lua in a single buffer. Formatting happens in place (no temporary string per
+ * `printf`) and `clear()` keeps the capacity so that the same writer can be reused. */
+class Writer
+{
+public:
+  Writer() = default;
+  explicit Writer(std::size_t iCapacity) { fBuffer.reserve(iCapacity); }
+
+  inline Writer &operator<<(std::string_view s) { fBuffer.append(s); return *this; }
+  inline Writer &operator<<(char c) { fBuffer.push_back(c); return *this; }
+
+  template<typename... Args>
+  Writer &printf(char const *iFormat, Args const &... args);
+
+  inline void reserve(std::size_t iCapacity) { fBuffer.reserve(iCapacity); }
+  inline void clear() { fBuffer.clear(); }
+  inline std::size_t size() const { return fBuffer.size(); }
+  inline std::string const &str() const { return fBuffer; }
+  inline std::string release() { return std::move(fBuffer); }
+
+private:
+  std::string fBuffer{};
+};
+
+//------------------------------------------------------------------------
+// Writer::printf
+//------------------------------------------------------------------------
+template<typename... Args>
+Writer &Writer::printf(char const *iFormat, Args const &... args)
+{
+  static_assert((impl::is_printf_arg_v<std::decay_t<decltype(impl::printf_arg(args))>> && ...),
+                "Writer::printf arguments must be arithmetic, pointers (char const *), std::string or Symbol");
+  auto size = std::snprintf(nullptr, 0, iFormat, impl::printf_arg(args)...);
+  if(size > 0)
+  {
+    auto offset = fBuffer.size();
+    fBuffer.resize(offset + static_cast<std::size_t>(size));
+    // note that snprintf writes the terminating '\0' at data()[size()] which std::string always provides
+    std::snprintf(fBuffer.data() + offset, static_cast<std::size_t>(size) + 1, iFormat, impl::printf_arg(args)...);
+  }
+  return *this;
+}
+
+}
+
+#endif //RE_EDIT_LUA_WRITER_H
@@ -291,6 +291,15 @@ void RLContext::setTargetFrameRate(int iFrameRate) const
   SetTargetFPS(iFrameRate);
 }
 
+//------------------------------------------------------------------------
+// RLContext::waitForEvents
+//------------------------------------------------------------------------
+void RLContext::waitForEvents(double iTimeoutSeconds) const
+{
+  // Implementation note: the events are dispatched to the raylib callbacks, so they are seen in the next frame
+  glfwWaitEventsTimeout(iTimeoutSeconds);
+}
+
 //------------------------------------------------------------------------
 // RLContext::setVSyncEnabled
 //------------------------------------------------------------------------
@@ -49,6 +49,8 @@ public:
 
   void setVSyncEnabled(bool iEnabled) const override;
 
+  void waitForEvents(double iTimeoutSeconds) const override;
+
   float getFontDpiScale() const { return getFontDpiScale(fWindow); }
 
   static float getFontDpiScale(GLFWwindow *iWindow);
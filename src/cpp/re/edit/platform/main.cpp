@@ -22,6 +22,7 @@
 #include <cstdlib>
 #include "NativeApplication.h"
 #include "nfd.h"
+#include "../ThreadPool.h"
 #include "../UIContext.h"
 #include "GLFW/glfw3.h"
 #include <version.h>
@@ -60,7 +61,9 @@ int doMain(int argc, char **argv)
 
   re::edit::UIContext uiContext{maxTextureSize};
   uiContext.init();
-  re::edit::UIContext::kCurrent = &uiContext;
+  // reset when leaving this function (after the thread pool has been shut down)
+  re::edit::Utils::StorageRAII<re::edit::UIContext> currentUIContext{&re::edit::UIContext::kCurrent, &uiContext};
+  uiContext.setWakeUpHandler([] { glfwPostEmptyEvent(); });
 
   ImGuiIO &io = ImGui::GetIO();
 
@@ -88,6 +91,10 @@ int doMain(int argc, char **argv)
 
   re::edit::Application application{ctx, config};
 
+  // the (process wide) thread pool outlives this function: the jobs still queued or running may use the
+  // application, the ui context or the window => they must complete before those are destroyed
+  auto shutdownThreadPool = re::edit::Utils::defer([] { re::edit::ThreadPool::GetDefault().shutdown(); });
+
   if(NFD_Init() != NFD_OKAY)
   {
     fprintf(stderr, "Error while initializing nfd");
@@ -103,6 +110,10 @@ int doMain(int argc, char **argv)
     if(WindowShouldClose())
       application.maybeExit();
 
+    // nothing is happening: no need to render until something does
+    if(application.running() && application.isIdle() && !application.waitForEvents())
+      continue;
+
     BeginDrawing();
 
     //       ca0->setClearColor(MTL::ClearColor::Make(application.clear_color[0] * application.clear_color[3],
@@ -21,6 +21,12 @@
 
 #include <stdexcept>
 #include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace re::edit::stl {
 
@@ -82,6 +88,125 @@ struct is_shared_ptr : std::false_type {};
 template<class T>
 struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
 
+//------------------------------------------------------------------------
+// stl::cow | immutable value shared (reference counted) between copies: copying is a pointer copy and the value
+// is only duplicated when modified (`mutate`) while being shared. Not thread safe (like the values it replaces).
+//------------------------------------------------------------------------
+template<typename T>
+class cow
+{
+public:
+  using value_type = T;
+
+public:
+  cow() = default;
+  cow(T iValue) : fValue{std::make_shared<T>(std::move(iValue))} {} // NOLINT(google-explicit-constructor)
+
+  cow &operator=(T iValue) { fValue = std::make_shared<T>(std::move(iValue)); return *this; }
+
+  inline T const &get() const { return fValue ? *fValue : kEmpty; }
+  inline T const &operator*() const { return get(); }
+  inline T const *operator->() const { return &get(); }
+  inline operator T const &() const { return get(); } // NOLINT(google-explicit-constructor)
+
+  //! @return the value to modify (duplicated first if it is shared with other copies)
+  T &mutate()
+  {
+    if(!fValue)
+      fValue = std::make_shared<T>();
+    else if(fValue.use_count() > 1)
+      fValue = std::make_shared<T>(*fValue);
+    return *fValue;
+  }
+
+  //! @return `true` if both share the same value (no comparison necessary)
+  inline bool shares(cow const &iOther) const { return fValue == iOther.fValue; }
+  inline long useCount() const { return fValue.use_count(); }
+
+  friend bool operator==(cow const &l, cow const &r) { return l.shares(r) || l.get() == r.get(); }
+  friend bool operator!=(cow const &l, cow const &r) { return !(l == r); }
+  friend bool operator==(cow const &l, T const &r) { return l.get() == r; }
+  friend bool operator!=(cow const &l, T const &r) { return l.get() != r; }
+  friend bool operator==(T const &l, cow const &r) { return l == r.get(); }
+  friend bool operator!=(T const &l, cow const &r) { return l != r.get(); }
+
+private:
+  static inline const T kEmpty{};
+
+  std::shared_ptr<T> fValue{};
+};
+
+//------------------------------------------------------------------------
+// stl::memorySize | approximate memory used by a value, including what it allocates (strings, containers...)
+//------------------------------------------------------------------------
+template<typename T>
+std::size_t memorySize(T const &iValue);
+
+namespace impl {
+template<typename T> struct MemorySize { static std::size_t compute(T const &) { return sizeof(T); } };
+
+template<>
+struct MemorySize<std::string>
+{
+  static std::size_t compute(std::string const &s) { return sizeof(std::string) + s.capacity(); }
+};
+
+template<typename T, typename A>
+struct MemorySize<std::vector<T, A>>
+{
+  static std::size_t compute(std::vector<T, A> const &v)
+  {
+    auto res = sizeof(v) + (v.capacity() - v.size()) * sizeof(T);
+    for(auto const &e: v)
+      res += memorySize(e);
+    return res;
+  }
+};
+
+template<typename T, typename C, typename A>
+struct MemorySize<std::set<T, C, A>>
+{
+  // each element lives in its own node (value + parent/left/right pointers + color)
+  static std::size_t compute(std::set<T, C, A> const &s)
+  {
+    auto res = sizeof(s) + s.size() * 4 * sizeof(void *);
+    for(auto const &e: s)
+      res += memorySize(e);
+    return res;
+  }
+};
+
+template<typename T>
+struct MemorySize<std::shared_ptr<T>>
+{
+  static std::size_t compute(std::shared_ptr<T> const &p) { return sizeof(p) + (p ? memorySize(*p) : 0); }
+};
+
+template<typename T>
+struct MemorySize<cow<T>>
+{
+  // the value is accounted for in proportion of the copies sharing it *at the time it is measured* (the share of a
+  // copy grows as the other ones are released) => the result is approximate and must be measured again to remain
+  // accurate (see UndoManager::enforceHistoryLimits)
+  static std::size_t compute(cow<T> const &c)
+  {
+    return sizeof(c) + (c.useCount() > 0 ? memorySize(c.get()) / static_cast<std::size_t>(c.useCount()) : 0);
+  }
+};
+
+template<typename T>
+struct MemorySize<std::optional<T>>
+{
+  static std::size_t compute(std::optional<T> const &o) { return sizeof(o) + (o ? memorySize(*o) - sizeof(T) : 0); }
+};
+}
+
+template<typename T>
+std::size_t memorySize(T const &iValue)
+{
+  return impl::MemorySize<T>::compute(iValue);
+}
+
 }
 
 #endif //RE_EDIT_STL_H
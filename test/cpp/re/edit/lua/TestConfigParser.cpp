@@ -31,6 +31,8 @@ global_config["style"] = "Dark"
 global_config["target_frame_rate"] = 60
 global_config["vsync_enabled"] = false
 global_config["show_performance"] = false
+global_config["texture_memory_budget"] = 512
+global_config["gpu_upload_budget"] = 8
 global_config["device_history"] = {}
 global_config["device_history"][1] = {
   name = "CVA-7 CV Analyzer",
@@ -69,6 +71,8 @@ global_config["device_history"][2] = {
   
   ASSERT_EQ(20, config.fFontSize);
   ASSERT_EQ(config::Style::kDark, config.fStyle);
+  ASSERT_EQ(512, config.fTextureMemoryBudget);
+  ASSERT_EQ(8, config.fGPUUploadBudget);
   ASSERT_EQ(2, config.fDeviceHistory.size());
 
   {
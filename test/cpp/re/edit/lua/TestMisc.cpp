@@ -18,6 +18,23 @@
 
 #include <gtest/gtest.h>
 #include <re/edit/FilmStrip.h>
+#include <re/edit/lua/Writer.h>
+#include <re/edit/RLDrawList.h>
+#include <re/edit/SpatialIndex.h>
+#include <re/edit/String.h>
+#include <re/edit/TaskGraph.h>
+#include <re/edit/TextureReferences.h>
+#include <re/edit/ThreadPool.h>
+#include <re/edit/UndoManager.h>
+#include <re/edit/Widget.h>
+#include <re/edit/stl.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
 
 namespace re::edit::Test {
 
@@ -49,4 +66,492 @@ TEST(FilmStrip, computeKey) {
   }).c_str());
 }
 
-}
\ No newline at end of file
+TEST(FilmStrip, generateMipLevels) {
+  // 2 frames of 4x4: frame 0 is opaque red with one transparent (black) pixel, frame 1 is opaque blue
+  RLImageRGBA8 image{4, 8};
+  for(int y = 0; y < 8; y++)
+  {
+    for(int x = 0; x < 4; x++)
+    {
+      auto pixel = image.data() + (y * 4 + x) * RLImageRGBA8::kBytesPerPixel;
+      std::array<unsigned char, 4> color = y < 4 ? std::array<unsigned char, 4>{255, 0, 0, 255} : std::array<unsigned char, 4>{0, 0, 255, 255};
+      if(x == 0 && y == 0)
+        color = {0, 0, 0, 0};
+      std::copy(color.begin(), color.end(), pixel);
+    }
+  }
+
+  auto levels = FilmStrip::generateMipLevels(image, 2);
+
+  // 4x4 -> 2x2 -> 1x1 (per frame)
+  ASSERT_EQ(2, levels.size());
+  ASSERT_EQ(2, levels[0].width());
+  ASSERT_EQ(4, levels[0].height());
+  ASSERT_EQ(1, levels[1].width());
+  ASSERT_EQ(2, levels[1].height());
+
+  auto pixel = [](RLImageRGBA8 const &iImage, int x, int y) {
+    auto p = iImage.data() + (y * iImage.width() + x) * RLImageRGBA8::kBytesPerPixel;
+    return std::array<int, 4>{p[0], p[1], p[2], p[3]};
+  };
+
+  // the transparent pixel does not darken the color (only the alpha)
+  ASSERT_EQ((std::array<int, 4>{255, 0, 0, 191}), pixel(levels[0], 0, 0));
+  ASSERT_EQ((std::array<int, 4>{255, 0, 0, 255}), pixel(levels[0], 1, 1));
+
+  // no bleeding between frames
+  ASSERT_EQ((std::array<int, 4>{0, 0, 255, 255}), pixel(levels[0], 0, 2));
+  ASSERT_EQ((std::array<int, 4>{255, 0, 0, 239}), pixel(levels[1], 0, 0));
+  ASSERT_EQ((std::array<int, 4>{0, 0, 255, 255}), pixel(levels[1], 0, 1));
+
+  // not enough rows per frame
+  ASSERT_TRUE(FilmStrip::generateMipLevels(image, 8).empty());
+}
+
+TEST(FilmStripCache, prune) {
+  auto directory = fs::temp_directory_path() / "re-edit-test" / "texture-cache";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+
+  auto now = fs::file_time_type::clock::now();
+  auto createEntry = [&directory](std::string const &iName, fs::file_time_type iLastUsedTime) {
+    auto path = directory / iName;
+    std::ofstream(path.u8string().c_str()) << std::string(100, 'x');
+    fs::last_write_time(path, iLastUsedTime);
+  };
+
+  // entry 0 is the most recently used, entry 1 the least one
+  createEntry("0.rgba", now);
+  createEntry("1.rgba", now - std::chrono::hours(3));
+  createEntry("2.rgba", now - std::chrono::hours(2));
+  createEntry("3.rgba", now - std::chrono::hours(1));
+  createEntry("3.rgba.1.tmp", now - std::chrono::hours(4)); // being written => ignored
+
+  FilmStripCache cache{directory};
+
+  // fits => nothing removed
+  cache.prune(400);
+  ASSERT_TRUE(fs::exists(directory / "1.rgba"));
+
+  cache.prune(250);
+  ASSERT_TRUE(fs::exists(directory / "0.rgba"));
+  ASSERT_FALSE(fs::exists(directory / "1.rgba"));
+  ASSERT_FALSE(fs::exists(directory / "2.rgba"));
+  ASSERT_TRUE(fs::exists(directory / "3.rgba"));
+  ASSERT_TRUE(fs::exists(directory / "3.rgba.1.tmp"));
+
+  fs::remove_all(directory.parent_path());
+}
+
+TEST(LuaWriter, printf) {
+  lua::Writer w{};
+  std::string name{"front"};
+  w << "-- " << name << '\n';
+  w.printf("%s_widgets[#%s_widgets + 1] = %d", name, name, 3);
+  ASSERT_EQ("-- front\nfront_widgets[#front_widgets + 1] = 3", w.str());
+
+  // output larger than what a small buffer would hold
+  std::string large(1000, 'x');
+  w.clear();
+  w.printf("[%s]", large);
+  ASSERT_EQ("[" + large + "]", w.str());
+  ASSERT_EQ(large.size() + 2, w.size());
+
+  auto s = w.release();
+  ASSERT_EQ(large.size() + 2, s.size());
+}
+
+TEST(SpatialIndex, queries) {
+  SpatialIndex index{100.0f};
+  index.update(1, {10, 10, 50, 50});
+  index.update(2, {40, 40, 250, 250}); // spans several cells
+  index.update(3, {-500, -500, 10000, 10000}); // oversized
+
+  auto findAt = [&index](ImVec2 const &iPosition) {
+    std::vector<int> ids{};
+    index.findAt(iPosition, ids);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  auto findOverlapping = [&index](ReGui::Rect const &iRect) {
+    std::vector<int> ids{};
+    index.findOverlapping(iRect, ids);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  };
+
+  ASSERT_EQ(std::vector<int>({1, 2, 3}), findAt({45, 45}));
+  ASSERT_EQ(std::vector<int>({2, 3}), findAt({200, 200}));
+  ASSERT_EQ(std::vector<int>({3}), findAt({-100, -100}));
+  ASSERT_EQ(std::vector<int>({1, 2, 3}), findOverlapping({0, 0, 300, 300}));
+
+  // move 2 out of the way
+  index.update(2, {5000, 5000, 5010, 5010});
+  ASSERT_EQ(std::vector<int>({3}), findAt({200, 200}));
+  ASSERT_EQ(std::vector<int>({2, 3}), findOverlapping({4000, 4000, 6000, 6000}));
+
+  index.remove(3);
+  ASSERT_EQ(std::vector<int>({1}), findAt({45, 45}));
+  ASSERT_EQ(2u, index.size());
+}
+
+// Symbol
+TEST(Symbol, intern) {
+  ASSERT_TRUE(Symbol{}.empty());
+  ASSERT_EQ(Symbol{}, Symbol{""});
+  ASSERT_EQ("", Symbol{}.str());
+
+  auto s1 = Symbol{"TestSymbol/intern/1"};
+  ASSERT_EQ("TestSymbol/intern/1", s1.str());
+  ASSERT_EQ(s1, Symbol{std::string("TestSymbol/intern/") + "1"});
+  ASSERT_EQ(&s1.str(), &Symbol{"TestSymbol/intern/1"}.str());
+  ASSERT_NE(s1, Symbol{"TestSymbol/intern/2"});
+
+  // find does not intern
+  ASSERT_EQ(std::nullopt, Symbol::find("TestSymbol/intern/3"));
+  ASSERT_EQ(s1, Symbol::find("TestSymbol/intern/1"));
+
+  // same symbols from all threads
+  std::vector<Symbol> symbols(100);
+  ThreadPool pool{4};
+  pool.parallelFor(ThreadPool::Priority::kInteractive, 100, [&symbols](int i) {
+    symbols[i] = Symbol{"TestSymbol/intern/parallel/" + std::to_string(i % 10)};
+  });
+  for(int i = 0; i < 100; i++)
+  {
+    ASSERT_EQ(symbols[i % 10], symbols[i]);
+    ASSERT_EQ("TestSymbol/intern/parallel/" + std::to_string(i % 10), symbols[i].str());
+  }
+}
+
+// TaskGraph.run
+TEST(TaskGraph, run) {
+  auto cancellable = std::make_shared<Utils::Cancellable>();
+
+  std::mutex mutex{};
+  std::vector<std::string> completed{};
+  auto task = [&mutex, &completed](std::string iName) {
+    return [&mutex, &completed, name = std::move(iName)] {
+      std::lock_guard<std::mutex> lock(mutex);
+      completed.emplace_back(name);
+    };
+  };
+
+  TaskGraph graph{};
+  auto a = graph.add("a", task("a"));
+  auto b = graph.add("b", task("b"));
+  auto c = graph.add("c", task("c"), {a, b});
+  graph.add("d", task("d"), {c});
+  graph.run(cancellable);
+
+  ASSERT_EQ(4u, completed.size());
+  ASSERT_EQ("c", completed[2]);
+  ASSERT_EQ("d", completed[3]);
+
+  // a failing task prevents its dependents from running and the exception is propagated
+  std::atomic<int> count{};
+  TaskGraph failingGraph{};
+  auto e = failingGraph.add("e", [] { throw std::runtime_error("e failed"); });
+  failingGraph.add("f", [&count] { count++; }, {e});
+  ASSERT_THROW(failingGraph.run(cancellable), std::runtime_error);
+  ASSERT_EQ(0, count.load());
+
+  // cancelled => nothing runs
+  cancellable->cancel();
+  TaskGraph cancelledGraph{};
+  cancelledGraph.add("g", [&count] { count++; });
+  ASSERT_THROW(cancelledGraph.run(cancellable), Utils::Cancellable::cancelled_t);
+  ASSERT_EQ(0, count.load());
+}
+
+// TextureReferences
+TEST(TextureReferences, update) {
+  TextureReferences refs{};
+
+  texture::FX fx{};
+  fx.fFlipX = true;
+  auto keyFX = FilmStrip::computeKey("knob", 63, fx);
+
+  ASSERT_TRUE(refs.update(1, {{"knob"}, {"bg"}, {"bg-HD"}}, 1));
+  ASSERT_TRUE(refs.update(2, {{"knob", fx, 63}}, 1));
+  ASSERT_FALSE(refs.update(3, {}, 1));
+  ASSERT_EQ(2, refs.getOwnerCount());
+  ASSERT_EQ(4, refs.getTextureCount());
+
+  auto knob = refs.findNode("knob");
+  ASSERT_TRUE(knob != nullptr);
+  ASSERT_TRUE(knob->isUsedAsIs());
+  ASSERT_TRUE(knob->isUsedAsSource());
+  ASSERT_FALSE(knob->isGenerated());
+  ASSERT_EQ(2, knob->getOwnerCount());
+
+  auto generated = refs.findNode(keyFX);
+  ASSERT_TRUE(generated != nullptr);
+  ASSERT_TRUE(generated->isGenerated());
+  ASSERT_FALSE(generated->isUsedAsIs());
+  ASSERT_EQ("knob", generated->getFX().fKey);
+  ASSERT_TRUE(generated->getFX().fEffects == fx);
+
+  std::vector<TextureReferences::owner_t> owners{};
+  refs.findOwners("knob", owners);
+  ASSERT_EQ((std::vector<TextureReferences::owner_t>{1, 2}), owners);
+  owners.clear();
+  refs.findOwners("not-referenced", owners);
+  ASSERT_TRUE(owners.empty());
+
+  // same sources => no change
+  ASSERT_FALSE(refs.update(2, {{"knob", fx, 63}}, 2));
+  // forced
+  refs.invalidate(2);
+  ASSERT_TRUE(refs.update(2, {{"knob", fx, 63}}, 2));
+
+  // owner 1 not updated with version 2 => removed (its textures are no longer referenced)
+  refs.removeStale(2);
+  ASSERT_EQ(1, refs.getOwnerCount());
+  ASSERT_TRUE(refs.findNode("bg") == nullptr);
+  ASSERT_FALSE(refs.findNode("knob")->isUsedAsIs());
+
+  // no more effect
+  ASSERT_TRUE(refs.update(2, {{"knob"}}, 3));
+  ASSERT_TRUE(refs.findNode(keyFX) == nullptr);
+  ASSERT_TRUE(refs.findNode("knob")->isUsedAsIs());
+  ASSERT_EQ(1, refs.getTextureCount());
+
+  refs.remove(2);
+  ASSERT_EQ(0, refs.getOwnerCount());
+  ASSERT_EQ(0, refs.getTextureCount());
+}
+
+// ThreadPool
+TEST(ThreadPool, run) {
+  ThreadPool pool{2};
+
+  // submit
+  auto future = pool.submit(ThreadPool::Priority::kInteractive, [] { return 42; });
+  ASSERT_EQ(42, future.get());
+
+  // exception propagated through the future
+  auto failed = pool.submit(ThreadPool::Priority::kBackground, []() -> int { throw std::runtime_error("failed"); });
+  ASSERT_THROW(failed.get(), std::runtime_error);
+
+  // cancelled before starting => skipped
+  auto cancellable = std::make_shared<Utils::Cancellable>();
+  cancellable->cancel();
+  std::atomic<int> count{};
+  auto cancelled = pool.submit(ThreadPool::Priority::kLoad, cancellable, [&count] { count++; });
+  ASSERT_THROW(cancelled.get(), Utils::Cancellable::cancelled_t);
+  ASSERT_EQ(0, count.load());
+
+  // parallelFor (nested from all workers at once: waiting must not exhaust the pool)
+  std::vector<std::future<int>> futures{};
+  for(int i = 0; i < 4; i++)
+  {
+    futures.emplace_back(pool.submit(ThreadPool::Priority::kLoad, [&pool] {
+      std::vector<int> v(100);
+      pool.parallelFor(ThreadPool::Priority::kLoad, static_cast<int>(v.size()), [&v](int i) { v[i] = i; });
+      int sum = 0;
+      for(auto e: v)
+        sum += e;
+      return sum;
+    }));
+  }
+  for(auto &f: futures)
+    ASSERT_EQ(4950, f.get());
+
+  // parallelFor propagates the (first) exception
+  ASSERT_THROW(pool.parallelFor(ThreadPool::Priority::kInteractive, 10, [](int i) { if(i == 5) throw std::runtime_error("5"); }),
+               std::runtime_error);
+
+  // nested calls (with a different function type) run serially on the calling thread
+  std::atomic<int> nestedOnOtherThread{};
+  pool.parallelFor(ThreadPool::Priority::kLoad, 8, [&pool, &nestedOnOtherThread](int) {
+    auto id = std::this_thread::get_id();
+    pool.parallelFor(ThreadPool::Priority::kLoad, 8, [id, &nestedOnOtherThread](int) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      if(std::this_thread::get_id() != id)
+        nestedOnOtherThread++;
+    });
+  });
+  ASSERT_EQ(0, nestedOnOtherThread.load());
+
+  // shutdown completes the queued tasks then runs new ones on the calling thread
+  std::atomic<int> queued{};
+  for(int i = 0; i < 10; i++)
+    pool.post(ThreadPool::Priority::kBackground, [&queued] { queued++; });
+  pool.shutdown();
+  ASSERT_EQ(10, queued.load());
+  auto thread = pool.submit(ThreadPool::Priority::kInteractive, [] { return std::this_thread::get_id(); });
+  ASSERT_EQ(std::this_thread::get_id(), thread.get());
+}
+
+// RLDrawList
+TEST(RLDrawList, computeBatches) {
+  auto order = [](std::vector<RLDrawList::Batch> const &iBatches) {
+    std::vector<std::vector<std::size_t>> res{};
+    for(auto const &batch: iBatches)
+      res.emplace_back(batch.fCommands);
+    return res;
+  };
+
+  using V = std::vector<std::vector<std::size_t>>;
+
+  // disjoint draws => grouped by state
+  ASSERT_EQ((V{{0, 2}, {1, 3}}),
+            order(RLDrawList::ComputeBatches({{0, 0, 10, 10}, {20, 0, 30, 10}, {40, 0, 50, 10}, {60, 0, 70, 10}},
+                                             {0, 1, 0, 1})));
+
+  // 2 overlaps 1 which overlaps 0 => cannot be moved before 1
+  ASSERT_EQ((V{{0}, {1}, {2}}),
+            order(RLDrawList::ComputeBatches({{0, 0, 10, 10}, {5, 0, 15, 10}, {12, 0, 20, 10}}, {0, 1, 0})));
+
+  // 2 only overlaps 0 (same state) => can be grouped with it
+  ASSERT_EQ((V{{0, 2}, {1}}),
+            order(RLDrawList::ComputeBatches({{0, 0, 10, 10}, {20, 0, 30, 10}, {5, 0, 15, 10}}, {0, 1, 0})));
+
+  // 3 overlaps 1 => goes into a batch (with the same state) after it
+  ASSERT_EQ((V{{0, 2}, {1}, {3}}),
+            order(RLDrawList::ComputeBatches({{0, 0, 10, 10}, {20, 0, 30, 10}, {40, 0, 50, 10}, {25, 0, 35, 10}},
+                                             {0, 1, 0, 0})));
+}
+
+// stl::cow
+TEST(Stl, cow) {
+  stl::cow<std::vector<std::string>> empty{};
+  ASSERT_TRUE(empty->empty());
+  ASSERT_EQ(0, empty.useCount());
+
+  stl::cow<std::vector<std::string>> v{std::vector<std::string>{"a", "b"}};
+  auto copy = v;
+  ASSERT_TRUE(copy.shares(v));
+  ASSERT_EQ(2, v.useCount());
+  ASSERT_EQ(v, copy);
+
+  // modifying a shared value detaches it
+  copy.mutate().emplace_back("c");
+  ASSERT_FALSE(copy.shares(v));
+  ASSERT_EQ((std::vector<std::string>{"a", "b"}), *v);
+  ASSERT_EQ((std::vector<std::string>{"a", "b", "c"}), *copy);
+  ASSERT_NE(v, copy);
+
+  // not shared => modified in place
+  auto const *address = &copy.get();
+  copy.mutate().emplace_back("d");
+  ASSERT_EQ(address, &copy.get());
+
+  copy = std::vector<std::string>{"a", "b"};
+  ASSERT_EQ(v, copy);
+  ASSERT_FALSE(copy.shares(v));
+
+  empty.mutate().emplace_back("e");
+  ASSERT_EQ(std::vector<std::string>{"e"}, *empty);
+}
+
+// widget::Attribute
+TEST(WidgetAttribute, isKindOf) {
+  using namespace widget::attribute;
+
+  Socket socket{re::mock::JboxObjectType::kAudioInput};
+  widget::Attribute const *attribute = &socket;
+  ASSERT_TRUE(attribute->isKindOf<Socket>());
+  ASSERT_TRUE(attribute->isKindOf<ObjectPath>());
+  ASSERT_TRUE(attribute->isKindOf<String>());
+  ASSERT_FALSE(attribute->isKindOf<PropertyPath>());
+  ASSERT_FALSE(attribute->isKindOf<Background>());
+  ASSERT_EQ(&socket, attribute->as<ObjectPath>());
+  ASSERT_EQ(nullptr, attribute->as<UIText>());
+
+  Values values{"values"};
+  attribute = &values;
+  ASSERT_TRUE(attribute->isKindOf<PropertyPathList>());
+  ASSERT_FALSE(attribute->isKindOf<ValueTemplates>());
+}
+
+// UndoManager
+TEST(UndoManager, enforceHistoryLimits) {
+  struct SizedAction : public Action
+  {
+    explicit SizedAction(std::size_t iSize) : fSize{iSize} {}
+    void undo() override {}
+    void redo() override {}
+    std::size_t getMemorySize() const override { return fSize; }
+    std::size_t fSize;
+  };
+
+  UndoManager um{};
+  std::vector<Action *> actions{};
+  for(auto size: {100, 200, 300, 400})
+  {
+    auto action = std::make_unique<SizedAction>(size);
+    actions.emplace_back(action.get());
+    um.addOrMerge(std::move(action));
+  }
+  ASSERT_EQ(1000, um.getMemorySize());
+
+  // undo/redo moves the actions between histories (memory is for both)
+  um.undoLastAction();
+  ASSERT_EQ(1000, um.getMemorySize());
+  um.redoLastAction();
+
+  // oldest dropped first
+  um.enforceHistoryLimits(3, 0);
+  ASSERT_EQ(3, um.getUndoHistory().size());
+  ASSERT_EQ(actions[1], um.getUndoHistory()[0].get());
+  ASSERT_EQ(900, um.getMemorySize());
+
+  um.enforceHistoryLimits(0, 750);
+  ASSERT_EQ(2, um.getUndoHistory().size());
+  ASSERT_EQ(700, um.getMemorySize());
+
+  // the most recent action is always kept
+  um.enforceHistoryLimits(0, 1);
+  ASSERT_EQ(1, um.getUndoHistory().size());
+  ASSERT_EQ(actions[3], um.getLastUndoAction());
+  ASSERT_EQ(400, um.getMemorySize());
+
+  um.clear();
+  ASSERT_EQ(0, um.getMemorySize());
+
+  // redo actions are dropped too (the furthest from the current state first)
+  actions.clear();
+  for(auto size: {100, 200, 300})
+  {
+    auto action = std::make_unique<SizedAction>(size);
+    actions.emplace_back(action.get());
+    um.addOrMerge(std::move(action));
+  }
+  um.undoLastAction();
+  um.undoLastAction();
+  um.enforceHistoryLimits(2, 0);
+  ASSERT_EQ(1, um.getUndoHistory().size());
+  ASSERT_EQ(1, um.getRedoHistory().size());
+  ASSERT_EQ(actions[1], um.getRedoHistory()[0].get());
+  ASSERT_EQ(300, um.getMemorySize());
+
+  um.enforceHistoryLimits(0, 1);
+  ASSERT_EQ(1, um.getUndoHistory().size());
+  ASSERT_TRUE(um.getRedoHistory().empty());
+  ASSERT_EQ(100, um.getMemorySize());
+
+  um.clear();
+
+  // a value shared with another copy is measured again once the copy is released
+  struct SharedValueAction : public Action
+  {
+    explicit SharedValueAction(stl::cow<std::string> iValue) : fValue{std::move(iValue)} {}
+    void undo() override {}
+    void redo() override {}
+    std::size_t getMemorySize() const override { return stl::memorySize(fValue); }
+    stl::cow<std::string> fValue;
+  };
+
+  stl::cow<std::string> value{std::string(1000, 'x')};
+  um.addOrMerge(std::make_unique<SharedValueAction>(value));
+  auto sharedMemorySize = um.getMemorySize();
+  value = std::string{};
+  um.enforceHistoryLimits(0, 1000000);
+  ASSERT_GT(um.getMemorySize(), sharedMemorySize);
+  ASSERT_EQ(stl::memorySize(stl::cow<std::string>{std::string(1000, 'x')}), um.getMemorySize());
+}
+
+}